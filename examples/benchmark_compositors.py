@@ -0,0 +1,38 @@
+# compares the specialized compositors, which inline their per-pixel
+# operation into the compose loop, with the sicgl compositors which are
+# kept in pysicgl.composition.generic
+
+import timeit
+
+import pysicgl
+
+WIDTH = 256
+HEIGHT = 256
+REPEAT = 5
+NUMBER = 100
+
+screen = pysicgl.Screen((WIDTH, HEIGHT))
+display = pysicgl.Interface(screen, pysicgl.allocate_pixel_memory(screen.pixels))
+sprite = pysicgl.allocate_pixel_memory(screen.pixels)
+pysicgl.functional.interface_fill(
+    pysicgl.Interface(screen, sprite),
+    pysicgl.functional.color_from_rgba((255, 128, 3, 64)),
+)
+
+
+def measure(compositor):
+    timer = timeit.Timer(
+        lambda: pysicgl.functional.compose(display, screen, sprite, compositor)
+    )
+    return min(timer.repeat(repeat=REPEAT, number=NUMBER)) / NUMBER
+
+
+print(f"{'compositor':<32}{'generic (us)':>14}{'specialized (us)':>18}{'speedup':>10}")
+for name, generic in pysicgl.composition.generic.items():
+    specialized = getattr(pysicgl.composition, name)
+    generic_time = measure(generic)
+    specialized_time = measure(specialized)
+    print(
+        f"{name:<32}{generic_time * 1e6:>14.1f}{specialized_time * 1e6:>18.1f}"
+        f"{generic_time / specialized_time:>10.2f}"
+    )
@@ -0,0 +1,43 @@
+# measures the fill paths on a 4K interface, a copy of a prepared frame is
+# included as a reference for the memory bandwidth of the machine
+
+import timeit
+
+import pysicgl
+
+WIDTH = 3840
+HEIGHT = 2160
+REPEAT = 5
+NUMBER = 20
+
+screen = pysicgl.Screen((WIDTH, HEIGHT))
+display = pysicgl.Interface(screen, pysicgl.allocate_pixel_memory(screen.pixels))
+color = pysicgl.functional.color_from_rgba((255, 128, 3, 64))
+frame = bytes(pysicgl.allocate_pixel_memory(screen.pixels))
+inset = pysicgl.Screen((WIDTH - 2, HEIGHT - 2), (1, 1))
+tile = pysicgl.Screen((64, 64), (100, 100))
+
+cases = {
+    "frame copy (reference)": lambda: display.memory.__setitem__(
+        slice(None), frame
+    ),
+    "interface_fill": lambda: pysicgl.functional.interface_fill(display, color),
+    "screen_fill (inset rows)": lambda: pysicgl.functional.screen_fill(
+        display, inset, color
+    ),
+    "interface_rectangle_filled": lambda: (
+        pysicgl.functional.interface_rectangle_filled(
+            display, color, (0, 0), (WIDTH - 1, HEIGHT - 1)
+        )
+    ),
+    "screen_fill (64x64 tile)": lambda: pysicgl.functional.screen_fill(
+        display, tile, color
+    ),
+}
+
+print(f"{'case':<32}{'time (us)':>12}{'bandwidth (GB/s)':>20}")
+for name, case in cases.items():
+    seconds = min(timeit.Timer(case).repeat(repeat=REPEAT, number=NUMBER)) / NUMBER
+    pixels = 64 * 64 if "tile" in name else screen.pixels
+    size = pixels * pysicgl.get_bytes_per_pixel()
+    print(f"{name:<32}{seconds * 1e6:>12.1f}{size / seconds / 1e9:>20.2f}")
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "sicgl/color.h"
+
+// compositors with their per-pixel operation inlined into the compose loop,
+// these produce the same results as the sicgl compositors of the same name.
+// only the direct, bitwise and channelwise min/max compositors are covered.
+void compositor_specialized_direct_set(
+    color_t* source, color_t* destination, size_t width, void* args);
+void compositor_specialized_direct_clear(
+    color_t* source, color_t* destination, size_t width, void* args);
+void compositor_specialized_direct_none(
+    color_t* source, color_t* destination, size_t width, void* args);
+void compositor_specialized_bitwise_and(
+    color_t* source, color_t* destination, size_t width, void* args);
+void compositor_specialized_bitwise_or(
+    color_t* source, color_t* destination, size_t width, void* args);
+void compositor_specialized_bitwise_xor(
+    color_t* source, color_t* destination, size_t width, void* args);
+void compositor_specialized_bitwise_nand(
+    color_t* source, color_t* destination, size_t width, void* args);
+void compositor_specialized_bitwise_nor(
+    color_t* source, color_t* destination, size_t width, void* args);
+void compositor_specialized_bitwise_xnor(
+    color_t* source, color_t* destination, size_t width, void* args);
+void compositor_specialized_channelwise_min(
+    color_t* source, color_t* destination, size_t width, void* args);
+void compositor_specialized_channelwise_max(
+    color_t* source, color_t* destination, size_t width, void* args);
+
+// porter-duff compositors for premultiplied alpha colors
+void compositor_premultiplied_clear(
+    color_t* source, color_t* destination, size_t width, void* args);
+void compositor_premultiplied_copy(
+    color_t* source, color_t* destination, size_t width, void* args);
+void compositor_premultiplied_destination(
+    color_t* source, color_t* destination, size_t width, void* args);
+void compositor_premultiplied_source_over(
+    color_t* source, color_t* destination, size_t width, void* args);
+void compositor_premultiplied_destination_over(
+    color_t* source, color_t* destination, size_t width, void* args);
+void compositor_premultiplied_source_in(
+    color_t* source, color_t* destination, size_t width, void* args);
+void compositor_premultiplied_destination_in(
+    color_t* source, color_t* destination, size_t width, void* args);
+void compositor_premultiplied_source_out(
+    color_t* source, color_t* destination, size_t width, void* args);
+void compositor_premultiplied_destination_out(
+    color_t* source, color_t* destination, size_t width, void* args);
+void compositor_premultiplied_source_atop(
+    color_t* source, color_t* destination, size_t width, void* args);
+void compositor_premultiplied_destination_atop(
+    color_t* source, color_t* destination, size_t width, void* args);
+void compositor_premultiplied_xor(
+    color_t* source, color_t* destination, size_t width, void* args);
+void compositor_premultiplied_lighter(
+    color_t* source, color_t* destination, size_t width, void* args);
@@ -0,0 +1,15 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+PyObject* interface_line_aa(PyObject* self_in, PyObject* args);
+PyObject* interface_circle_aa(PyObject* self_in, PyObject* args);
+PyObject* interface_ellipse_aa(PyObject* self_in, PyObject* args);
+PyObject* screen_line_aa(PyObject* self_in, PyObject* args);
+PyObject* screen_circle_aa(PyObject* self_in, PyObject* args);
+PyObject* screen_ellipse_aa(PyObject* self_in, PyObject* args);
+PyObject* global_line_aa(PyObject* self_in, PyObject* args);
+PyObject* global_circle_aa(PyObject* self_in, PyObject* args);
+PyObject* global_ellipse_aa(PyObject* self_in, PyObject* args);
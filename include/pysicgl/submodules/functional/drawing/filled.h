@@ -0,0 +1,28 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+// how the edges crossing a row of a polygon are paired into spans
+typedef enum _polygon_fill_rule_t {
+  POLYGON_FILL_EVEN_ODD = 0,
+  POLYGON_FILL_NONZERO,
+} polygon_fill_rule_t;
+
+PyObject* interface_circle_filled(PyObject* self_in, PyObject* args);
+PyObject* interface_ellipse_filled(PyObject* self_in, PyObject* args);
+PyObject* interface_rounded_rectangle_filled(
+    PyObject* self_in, PyObject* args);
+PyObject* interface_polygon_filled(
+    PyObject* self_in, PyObject* args, PyObject* kwds);
+PyObject* screen_circle_filled(PyObject* self_in, PyObject* args);
+PyObject* screen_ellipse_filled(PyObject* self_in, PyObject* args);
+PyObject* screen_rounded_rectangle_filled(PyObject* self_in, PyObject* args);
+PyObject* screen_polygon_filled(
+    PyObject* self_in, PyObject* args, PyObject* kwds);
+PyObject* global_circle_filled(PyObject* self_in, PyObject* args);
+PyObject* global_ellipse_filled(PyObject* self_in, PyObject* args);
+PyObject* global_rounded_rectangle_filled(PyObject* self_in, PyObject* args);
+PyObject* global_polygon_filled(
+    PyObject* self_in, PyObject* args, PyObject* kwds);
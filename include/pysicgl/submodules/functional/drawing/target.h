@@ -0,0 +1,34 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "sicgl/interface.h"
+#include "sicgl/screen.h"
+
+// where primitives drawn by pysicgl itself are placed in an interface
+typedef struct _draw_target_t {
+  interface_t* interface;
+  color_t color;
+  // added to drawing coordinates to reach interface coordinates
+  double du, dv;
+  // drawable pixels in interface coordinates, inclusive
+  ext_t u0, v0, u1, v1;
+} draw_target_t;
+
+// fills of at least this many bytes use non-temporal stores so that a
+// frame which is not read back soon does not evict the cache
+#define FILL_STREAM_THRESHOLD (1 << 20)
+
+void fill_span(color_t* memory, color_t color, size_t count, bool stream);
+
+int draw_target_init(
+    draw_target_t* target, interface_t* interface, color_t color,
+    screen_t* screen, bool local);
+void draw_target_span(draw_target_t* target, ext_t v, ext_t u0, ext_t u1);
+void draw_target_rectangle(
+    draw_target_t* target, ext_t u0, ext_t v0, ext_t u1, ext_t v1);
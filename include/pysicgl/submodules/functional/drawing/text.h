@@ -0,0 +1,9 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+PyObject* interface_text(PyObject* self_in, PyObject* args, PyObject* kwds);
+PyObject* screen_text(PyObject* self_in, PyObject* args, PyObject* kwds);
+PyObject* global_text(PyObject* self_in, PyObject* args, PyObject* kwds);
@@ -0,0 +1,26 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <stdint.h>
+
+#include "sicgl/color.h"
+#include "sicgl/screen.h"
+
+// how a convolution samples pixels beyond the edges of its region
+typedef enum _convolve_edge_t {
+  CONVOLVE_EDGE_CLAMP = 0,
+  CONVOLVE_EDGE_WRAP,
+  CONVOLVE_EDGE_ZERO,
+} convolve_edge_t;
+
+PyObject* box_blur(PyObject* self_in, PyObject* args, PyObject* kwds);
+PyObject* gaussian_blur(PyObject* self_in, PyObject* args, PyObject* kwds);
+PyObject* convolve(PyObject* self_in, PyObject* args, PyObject* kwds);
+
+// utilities for C consumers
+void box_blur_region(
+    color_t* memory, ext_t stride, ext_t width, ext_t height, ext_t radius,
+    color_t* scratch, uint64_t* sums);
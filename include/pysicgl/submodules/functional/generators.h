@@ -0,0 +1,16 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+PyObject* field_linear_gradient(
+    PyObject* self_in, PyObject* args, PyObject* kwds);
+PyObject* field_radial_gradient(
+    PyObject* self_in, PyObject* args, PyObject* kwds);
+PyObject* field_conic_gradient(
+    PyObject* self_in, PyObject* args, PyObject* kwds);
+PyObject* field_plasma(PyObject* self_in, PyObject* args, PyObject* kwds);
+PyObject* field_noise(PyObject* self_in, PyObject* args, PyObject* kwds);
+PyObject* field_expression(
+    PyObject* self_in, PyObject* args, PyObject* kwds);
@@ -3,6 +3,12 @@
 // python includes first (clang-format)
 
 PyObject* scalar_field(PyObject* self_in, PyObject* args, PyObject* kwds);
+PyObject* scalar_field_compose(
+    PyObject* self_in, PyObject* args, PyObject* kwds);
+PyObject* scalar_expression(
+    PyObject* self_in, PyObject* args, PyObject* kwds);
 PyObject* compose(PyObject* self_in, PyObject* args);
 PyObject* blit(PyObject* self_in, PyObject* args);
 PyObject* scale(PyObject* self_in, PyObject* args);
+PyObject* premultiply_alpha(PyObject* self_in, PyObject* args);
+PyObject* unpremultiply_alpha(PyObject* self_in, PyObject* args);
@@ -0,0 +1,12 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+PyObject* interface_scaled_blit(
+    PyObject* self_in, PyObject* args, PyObject* kwds);
+PyObject* interface_scaled_compose(
+    PyObject* self_in, PyObject* args, PyObject* kwds);
+PyObject* interface_affine_blit(
+    PyObject* self_in, PyObject* args, PyObject* kwds);
@@ -0,0 +1,8 @@
+#pragma once
+
+// filters used when source pixels or scalars are resampled onto a
+// destination of a different size
+typedef enum _sample_filter_t {
+  SAMPLE_FILTER_NEAREST = 0,
+  SAMPLE_FILTER_BILINEAR,
+} sample_filter_t;
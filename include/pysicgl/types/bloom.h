@@ -0,0 +1,55 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <stdint.h>
+
+#include "sicgl/interface.h"
+#include "sicgl/screen.h"
+
+// declare the type
+extern PyTypeObject BloomType;
+
+// the most levels in the mip chain
+#define BLOOM_MAX_LEVELS (8)
+
+// one level of the mip chain
+typedef struct _bloom_level_t {
+  color_t* memory;
+  ext_t width;
+  ext_t height;
+} bloom_level_t;
+
+// scratch memory, kept between frames and grown as needed
+typedef struct _bloom_scratch_t {
+  color_t* buffer;
+  size_t capacity;
+  uint64_t* sums;
+  size_t sums_capacity;
+
+  // the mip chain for the extent and levels of the last interface
+  ext_t width;
+  ext_t height;
+  int levels;
+  size_t num_levels;
+  bloom_level_t chain[BLOOM_MAX_LEVELS];
+  color_t* scratch;
+  color_t* row;
+} bloom_scratch_t;
+
+typedef struct {
+  PyObject_HEAD
+      /* Type-specific fields go here. */
+      double threshold;
+  double intensity;
+  int levels;
+  int radius;
+
+  // scratch memory which is not in use, each application takes it while
+  // it runs so that concurrent applications never share it
+  bloom_scratch_t* scratch;
+} BloomObject;
+
+int Bloom_apply(BloomObject* self, interface_t* interface);
@@ -12,12 +12,33 @@
 // declare the type
 extern PyTypeObject CompositorType;
 
+// parameters of a compositor which wraps another compositor, the wrapper
+// is handed these as its args
+typedef struct _compositor_params_t {
+  // the wrapped compositor
+  compositor_fn fn;
+  void* args;
+  // scales the color components of the source
+  double opacity;
+  // when set the source is replaced by a constant color
+  bool has_color;
+  color_t color;
+  // only the bits of the destination within the mask are written
+  color_t mask;
+} compositor_params_t;
+
 typedef struct {
   PyObject_HEAD
       /* Type-specific fields go here. */
       compositor_fn fn;
   void* args;
+
+  // storage for the args of parameterized compositors
+  compositor_params_t params;
+  // the wrapped compositor, if any
+  PyObject* base;
 } CompositorObject;
 
 // public constructors
 CompositorObject* new_compositor_object(compositor_fn fn, void* args);
+int Compositor_check(CompositorObject* compositor);
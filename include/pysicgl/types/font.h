@@ -0,0 +1,74 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <stdint.h>
+
+#include "sicgl/screen.h"
+
+// declare the type
+extern PyTypeObject FontType;
+
+// glyphs with code points below this are found without a search
+#define FONT_DIRECT_GLYPHS (256)
+
+// number of rasterized strings kept by each font
+#define FONT_RUN_CACHE_SIZE (16)
+
+// one glyph of the atlas
+typedef struct _font_glyph_t {
+  uint32_t code;
+  // offset of the coverage of the glyph in the atlas
+  size_t offset;
+  ext_t width;
+  ext_t height;
+  // position of the top left of the glyph relative to the top of the line
+  // at the pen position
+  ext_t left;
+  ext_t top;
+  // distance the pen moves after the glyph
+  ext_t advance;
+} font_glyph_t;
+
+// a rasterized string, its top left lies at the top of the first line at
+// the starting pen position
+typedef struct _font_run_t {
+  // the string, NULL when the entry is unused
+  PyObject* text;
+  Py_hash_t hash;
+  // one byte of coverage in [0, 255] per pixel
+  uint8_t* coverage;
+  ext_t width;
+  ext_t height;
+  // moves the top left of the coverage from the starting pen position
+  ext_t left;
+  // recency of use, larger is more recent
+  uint64_t used;
+} font_run_t;
+
+typedef struct {
+  PyObject_HEAD
+      /* Type-specific fields go here. */
+      // coverage of every glyph, packed one after another
+      uint8_t* atlas;
+  size_t atlas_size;
+
+  // glyphs sorted by code point
+  font_glyph_t* glyphs;
+  size_t num_glyphs;
+  // index + 1 of the glyph for each small code point, 0 when missing
+  uint32_t direct[FONT_DIRECT_GLYPHS];
+  // drawn for missing code points, NULL to skip them
+  const font_glyph_t* fallback;
+
+  ext_t ascent;
+  ext_t descent;
+
+  font_run_t runs[FONT_RUN_CACHE_SIZE];
+  uint64_t clock;
+} FontObject;
+
+const font_glyph_t* Font_get_glyph(FontObject* self, uint32_t code);
+const font_run_t* Font_get_run(FontObject* self, PyObject* text);
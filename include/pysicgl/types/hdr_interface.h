@@ -0,0 +1,63 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include "pysicgl/types/screen.h"
+#include "sicgl/interface.h"
+
+// declare the type
+extern PyTypeObject HDRInterfaceType;
+
+// how a source is combined into a high dynamic range interface
+typedef enum _hdr_mode_t {
+  // adds the color weighted by alpha, nothing saturates
+  HDR_MODE_ADD = 0,
+  // places the color over the destination
+  HDR_MODE_OVER,
+  // multiplies the destination by the color, weighted by alpha
+  HDR_MODE_MULTIPLY,
+  // keeps the brighter of the color weighted by alpha and the destination
+  HDR_MODE_MAX,
+} hdr_mode_t;
+
+// how values above one are brought into range when quantizing
+typedef enum _hdr_tone_map_t {
+  HDR_TONE_MAP_CLAMP = 0,
+  // x / (1 + x), compresses highlights smoothly
+  HDR_TONE_MAP_REINHARD,
+} hdr_tone_map_t;
+
+typedef struct {
+  PyObject_HEAD
+      /* Type-specific fields go here. */
+      ScreenObject* screen;
+
+  // four floats per pixel, red, green, blue and alpha, one is full scale.
+  // the storage object owns them so that they outlive a reinitialization
+  // while they are held.
+  PyObject* storage;
+  float* memory;
+  size_t length;
+} HDRInterfaceObject;
+
+// a reference to the memory of a high dynamic range interface and a copy
+// of its screen which stay valid while the interpreter lock is released
+typedef struct _hdr_hold_t {
+  PyObject* storage;
+  float* memory;
+  size_t length;
+  screen_t screen;
+} hdr_hold_t;
+
+int HDRInterface_hold(HDRInterfaceObject* self, hdr_hold_t* hold);
+void HDRInterface_release(hdr_hold_t* hold);
+
+int HDRInterface_compose(
+    HDRInterfaceObject* self, screen_t* source_screen,
+    const color_t* source_colors, const float* source_floats, hdr_mode_t mode,
+    float scale);
+int HDRInterface_tone_map(
+    HDRInterfaceObject* self, interface_t* interface, float exposure,
+    hdr_tone_map_t tone_map);
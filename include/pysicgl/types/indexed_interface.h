@@ -0,0 +1,35 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <stdint.h>
+
+#include "pysicgl/types/color_sequence.h"
+#include "pysicgl/types/compositor.h"
+#include "pysicgl/types/screen.h"
+#include "sicgl/interface.h"
+
+// declare the type
+extern PyTypeObject IndexedInterfaceType;
+
+// number of colors an index can select
+#define INDEXED_PALETTE_SIZE (256)
+
+typedef struct {
+  PyObject_HEAD
+      /* Type-specific fields go here. */
+      ScreenObject* screen;
+  // colors selected by the indices, swapping it recolors the interface
+  ColorSequenceObject* palette;
+
+  // a buffer backs up the indices, one byte per pixel
+  Py_buffer memory_buffer;
+  uint8_t* memory;
+  size_t length;
+} IndexedInterfaceObject;
+
+int IndexedInterface_expand(
+    IndexedInterfaceObject* self, interface_t* interface,
+    CompositorObject* compositor);
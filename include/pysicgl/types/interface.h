@@ -23,3 +23,15 @@ typedef struct {
   // a buffer backs up the interface memory
   Py_buffer memory_buffer;
 } InterfaceObject;
+
+// references to the pixels and a copy of the screen of an interface which
+// stay valid while the interpreter lock is released
+typedef struct {
+  interface_t interface;
+  screen_t screen;
+  Py_buffer buffer;
+} interface_hold_t;
+
+int Interface_check(interface_t* interface);
+int Interface_hold(InterfaceObject* self, interface_hold_t* hold);
+void Interface_release(interface_hold_t* hold);
@@ -0,0 +1,63 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <stdbool.h>
+
+#include "pysicgl/types/compositor.h"
+#include "pysicgl/types/interface.h"
+#include "pysicgl/types/screen.h"
+
+// declare the type
+extern PyTypeObject LayerStackType;
+
+// a rectangle in global coordinates, empty when u0 > u1 or v0 > v1
+typedef struct _layer_region_t {
+  ext_t u0, v0, u1, v1;
+} layer_region_t;
+
+// one layer of the stack, the stack holds a reference to each object
+typedef struct _layer_t {
+  // the pixels of the layer
+  InterfaceObject* interface;
+  // where the layer is placed, in global coordinates
+  ScreenObject* screen;
+  // how the layer is combined with the layers beneath it
+  CompositorObject* compositor;
+  double opacity;
+  bool visible;
+
+  // set when the layer must be recomposited by the next incremental flatten
+  bool dirty;
+  // region of the destination which the layer has invalidated
+  layer_region_t damage;
+  // region which the layer covered when it was last flattened
+  layer_region_t drawn;
+} layer_t;
+
+typedef struct {
+  PyObject_HEAD
+      /* Type-specific fields go here. */
+      layer_t* layers;
+  size_t length;
+  size_t capacity;
+
+  // incremental flattening state, the destination as it was before any
+  // layer was composed and the destination after the first `cached` layers
+  color_t* base;
+  color_t* cache;
+  size_t cached;
+  // the destination which the cache belongs to
+  color_t* target;
+  screen_t target_screen;
+  // damage and first invalidated layer from layers which were removed
+  layer_region_t damage;
+  size_t dirty_from;
+} LayerStackObject;
+
+int LayerStack_flatten(LayerStackObject* self, interface_t* destination);
+int LayerStack_flatten_incremental(
+    LayerStackObject* self, interface_t* destination);
+void LayerStack_invalidate(LayerStackObject* self);
@@ -0,0 +1,47 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <stdint.h>
+
+#include "pysicgl/types/compositor.h"
+#include "sicgl/interface.h"
+#include "sicgl/screen.h"
+
+// declare the type
+extern PyTypeObject RLESpriteType;
+
+// a horizontal run of pixels which are not fully transparent
+typedef struct _rle_run_t {
+  // first pixel of the run relative to the top left of the sprite
+  ext_t u;
+  ext_t length;
+  // offset of the first pixel of the run in the packed pixels
+  size_t offset;
+} rle_run_t;
+
+typedef struct {
+  PyObject_HEAD
+      /* Type-specific fields go here. */
+      ext_t width;
+  ext_t height;
+
+  // runs of every row, in order
+  rle_run_t* runs;
+  size_t num_runs;
+  // index of the first run of each row, with one extra entry at the end
+  size_t* rows;
+
+  // pixels of every run, packed one after another
+  color_t* pixels;
+  size_t num_pixels;
+} RLESpriteObject;
+
+int RLESprite_encode(
+    RLESpriteObject* self, const color_t* pixels, ext_t stride, ext_t width,
+    ext_t height);
+void RLESprite_draw(
+    RLESpriteObject* self, interface_t* interface, int64_t u, int64_t v,
+    ext_t u0, ext_t v0, ext_t u1, ext_t v1, CompositorObject* compositor);
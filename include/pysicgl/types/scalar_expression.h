@@ -0,0 +1,57 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <stdint.h>
+
+#include "sicgl/screen.h"
+
+// number of pixels evaluated by each instruction
+#define SCALAR_EXPRESSION_BLOCK (64)
+
+// declare the type
+extern PyTypeObject ScalarExpressionType;
+
+// a single register-based instruction
+typedef struct _scalar_expression_instruction_t {
+  uint8_t opcode;
+  uint16_t destination;
+  uint16_t a;
+  uint16_t b;
+} scalar_expression_instruction_t;
+
+typedef struct {
+  PyObject_HEAD PyObject* source;
+
+  // instructions grouped by how often they must be evaluated:
+  // once per call, once per row, or once per block of pixels
+  scalar_expression_instruction_t* instructions;
+  size_t num_instructions;
+  size_t row_start;
+  size_t pixel_start;
+
+  // constants are loaded into registers once per call
+  double* constants;
+  uint16_t* constant_registers;
+  size_t num_constants;
+
+  size_t num_registers;
+  uint16_t result;
+} ScalarExpressionObject;
+
+// evaluates a compiled expression one row at a time
+typedef struct _scalar_expression_evaluator_t {
+  ScalarExpressionObject* expression;
+  double* registers;
+} scalar_expression_evaluator_t;
+
+int ScalarExpression_evaluator_init(
+    scalar_expression_evaluator_t* evaluator,
+    ScalarExpressionObject* expression, double t);
+int ScalarExpression_evaluator_row(
+    scalar_expression_evaluator_t* evaluator, ext_t u0, ext_t v,
+    size_t count, double* out);
+void ScalarExpression_evaluator_deinit(
+    scalar_expression_evaluator_t* evaluator);
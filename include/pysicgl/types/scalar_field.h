@@ -4,12 +4,74 @@
 #include <Python.h>
 // python includes first (clang-format)
 
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "pysicgl/submodules/functional/sampling.h"
 #include "sicgl/field.h"
+#include "sicgl/screen.h"
 
 // declare the type
 extern PyTypeObject ScalarFieldType;
 
+// storage formats for scalars
+typedef enum _scalar_storage_t {
+  // double precision
+  SCALAR_STORAGE_FLOAT64 = 0,
+  // single precision
+  SCALAR_STORAGE_FLOAT32,
+  // the range [0, 1] normalized onto 16 bits, values are clamped
+  SCALAR_STORAGE_UINT16,
+} scalar_storage_t;
+
 typedef struct {
-  PyObject_HEAD double* scalars;
+  PyObject_HEAD void* scalars;
   size_t length;
+  scalar_storage_t storage;
 } ScalarFieldObject;
+
+size_t ScalarField_element_size(scalar_storage_t storage);
+
+// produces rows of scalars for a region of a screen, resampling
+// the field when its extent differs from that of the screen
+typedef struct _scalar_field_sampler_t {
+  ScalarFieldObject* field;
+  screen_t* screen;
+  sample_filter_t filter;
+
+  // extent of the field data
+  ext_t width;
+  ext_t height;
+
+  // sampled region in global coordinates
+  ext_t gu0;
+  ext_t columns;
+
+  // per-column source indices and weights, NULL when not resampling
+  bool resample;
+  ext_t* u0;
+  ext_t* u1;
+  double* weights;
+  double* row;
+} scalar_field_sampler_t;
+
+int ScalarField_sampler_init(
+    scalar_field_sampler_t* sampler, ScalarFieldObject* field,
+    screen_t* screen, ext_t width, ext_t height, sample_filter_t filter,
+    screen_t* region);
+int ScalarField_sampler_row(
+    scalar_field_sampler_t* sampler, ext_t v, double** row);
+void ScalarField_sampler_deinit(scalar_field_sampler_t* sampler);
+
+// writes rows of double precision scalars into a field of any storage
+typedef struct _scalar_field_writer_t {
+  ScalarFieldObject* field;
+  double* row;
+} scalar_field_writer_t;
+
+int ScalarField_writer_init(
+    scalar_field_writer_t* writer, ScalarFieldObject* field, size_t count);
+double* ScalarField_writer_row(scalar_field_writer_t* writer, size_t start);
+void ScalarField_writer_store(
+    scalar_field_writer_t* writer, size_t start, size_t count);
+void ScalarField_writer_deinit(scalar_field_writer_t* writer);
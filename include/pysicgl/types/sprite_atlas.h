@@ -0,0 +1,59 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <stdint.h>
+
+#include "pysicgl/types/compositor.h"
+#include "sicgl/interface.h"
+#include "sicgl/screen.h"
+
+// declare the type
+extern PyTypeObject SpriteAtlasType;
+
+// a sub-rectangle of the atlas
+typedef struct _sprite_t {
+  ext_t u, v;
+  ext_t width, height;
+} sprite_t;
+
+// one sprite of a batch, positioned in interface coordinates, which may
+// lie beyond ext_t once offset by a screen. the sprite is copied since
+// adding to the atlas moves its sprites.
+typedef struct _sprite_draw_t {
+  sprite_t sprite;
+  int64_t u, v;
+  // compositor, or NULL to copy the pixels of the sprite
+  CompositorObject* compositor;
+} sprite_draw_t;
+
+typedef struct {
+  PyObject_HEAD
+      /* Type-specific fields go here. */
+      // pixels of every sprite, rows of width pixels
+      color_t* pixels;
+  ext_t width;
+  ext_t height;
+
+  sprite_t* sprites;
+  size_t num_sprites;
+  size_t capacity;
+  // maps the name of a sprite to its id
+  PyObject* names;
+  // counts the initializations, each of which discards every sprite
+  size_t generation;
+
+  // sprites are packed left to right onto shelves stacked top to bottom
+  ext_t shelf_v;
+  ext_t shelf_height;
+  ext_t shelf_u;
+} SpriteAtlasObject;
+
+int SpriteAtlas_add(
+    SpriteAtlasObject* self, const color_t* pixels, ext_t stride, ext_t width,
+    ext_t height);
+void SpriteAtlas_draw(
+    SpriteAtlasObject* self, interface_t* interface, const sprite_draw_t* batch,
+    size_t count, ext_t u0, ext_t v0, ext_t u1, ext_t v1);
@@ -0,0 +1,35 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include "pysicgl/types/compositor.h"
+#include "pysicgl/types/interface.h"
+#include "pysicgl/types/screen.h"
+
+// declare the type
+extern PyTypeObject SupersamplerType;
+
+// the largest supersampling factor, sums of factor squared channels must
+// fit in 16 bits
+#define SUPERSAMPLER_MAX_FACTOR (8)
+
+typedef struct {
+  PyObject_HEAD
+      /* Type-specific fields go here. */
+      // the screen which is supersampled
+      ScreenObject* screen;
+  ext_t factor;
+
+  // the target screen in global coordinates when the sampler was made
+  ext_t u0, v0;
+  ext_t width, height;
+
+  // the interface which is drawn at factor times the resolution
+  InterfaceObject* interface;
+} SupersamplerObject;
+
+int Supersampler_resolve(
+    SupersamplerObject* self, interface_t* interface,
+    CompositorObject* compositor);
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "sicgl/color.h"
+
+static inline color_t clamp_u8(color_t channel) {
+  if (channel > 255) {
+    return 255;
+  } else if (channel < 0) {
+    return 0;
+  } else {
+    return channel;
+  }
+}
+
+static inline color_t color_scale(color_t color, double scale) {
+  // scales only the color components, alpha channel is untouched
+  return color_from_channels(
+      clamp_u8((color_t)(color_channel_red(color) * scale)),
+      clamp_u8((color_t)(color_channel_green(color) * scale)),
+      clamp_u8((color_t)(color_channel_blue(color) * scale)),
+      color_channel_alpha(color));
+}
+
+static inline void color_scale_row(
+    color_t* destination, const color_t* source, size_t count, double scale) {
+  for (size_t idx = 0; idx < count; idx++) {
+    destination[idx] = color_scale(source[idx], scale);
+  }
+}
+
+// rounded division by 255 of a product of two channels, exact for [0, 65025]
+static inline color_t div255(color_t value) {
+  value += 128;
+  return (value + (value >> 8)) >> 8;
+}
+
+// converts a straight alpha color to premultiplied alpha
+static inline color_t color_premultiply(color_t color) {
+  color_t alpha = color_channel_alpha(color);
+  return color_from_channels(
+      div255(color_channel_red(color) * alpha),
+      div255(color_channel_green(color) * alpha),
+      div255(color_channel_blue(color) * alpha), alpha);
+}
+
+// converts a premultiplied alpha color to straight alpha
+static inline color_t color_unpremultiply(color_t color) {
+  color_t alpha = color_channel_alpha(color);
+  if (0 == alpha) {
+    return 0;
+  }
+  return color_from_channels(
+      clamp_u8((color_channel_red(color) * 255 + alpha / 2) / alpha),
+      clamp_u8((color_channel_green(color) * 255 + alpha / 2) / alpha),
+      clamp_u8((color_channel_blue(color) * 255 + alpha / 2) / alpha), alpha);
+}
+
+// blends a straight alpha color over another, the alpha of the source is
+// first scaled by a coverage in [0, 255]
+static inline color_t color_blend_coverage(
+    color_t destination, color_t source, color_t coverage) {
+  color_t alpha = div255(color_channel_alpha(source) * coverage);
+  if (0 == alpha) {
+    return destination;
+  }
+  color_t remaining = div255(color_channel_alpha(destination) * (255 - alpha));
+  color_t total = alpha + remaining;
+  color_t half = total / 2;
+  return color_from_channels(
+      (color_channel_red(source) * alpha +
+       color_channel_red(destination) * remaining + half) /
+          total,
+      (color_channel_green(source) * alpha +
+       color_channel_green(destination) * remaining + half) /
+          total,
+      (color_channel_blue(source) * alpha +
+       color_channel_blue(destination) * remaining + half) /
+          total,
+      total);
+}
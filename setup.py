@@ -46,21 +46,38 @@ pysicgl_include_dirs = list(
 pysicgl_sources = list(
     str(PurePath(pysicgl_root_dir, "src", source))
     for source in [
+        "submodules/composition/kernels.c",
         "submodules/composition/module.c",
+        "submodules/functional/drawing/antialiased.c",
+        "submodules/functional/drawing/filled.c",
         "submodules/functional/drawing/global.c",
         "submodules/functional/drawing/interface.c",
         "submodules/functional/drawing/screen.c",
+        "submodules/functional/drawing/target.c",
+        "submodules/functional/drawing/text.c",
         "submodules/functional/color.c",
         "submodules/functional/color_correction.c",
+        "submodules/functional/filters.c",
+        "submodules/functional/generators.c",
         "submodules/functional/module.c",
         "submodules/functional/operations.c",
+        "submodules/functional/resampling.c",
         "submodules/interpolation/module.c",
+        "types/bloom/type.c",
         "types/color_sequence/type.c",
         "types/color_sequence_interpolator/type.c",
         "types/compositor/type.c",
+        "types/font/type.c",
+        "types/hdr_interface/type.c",
+        "types/scalar_expression/type.c",
         "types/scalar_field/type.c",
         "types/interface/type.c",
+        "types/indexed_interface/type.c",
+        "types/layer_stack/type.c",
+        "types/rle_sprite/type.c",
         "types/screen/type.c",
+        "types/sprite_atlas/type.c",
+        "types/supersampler/type.c",
         "module.c",
     ]
 )
@@ -6,12 +6,21 @@
 #include "pysicgl/submodules/composition.h"
 #include "pysicgl/submodules/functional.h"
 #include "pysicgl/submodules/interpolation.h"
+#include "pysicgl/types/bloom.h"
 #include "pysicgl/types/color_sequence.h"
 #include "pysicgl/types/color_sequence_interpolator.h"
 #include "pysicgl/types/compositor.h"
+#include "pysicgl/types/font.h"
+#include "pysicgl/types/hdr_interface.h"
+#include "pysicgl/types/indexed_interface.h"
 #include "pysicgl/types/interface.h"
+#include "pysicgl/types/layer_stack.h"
+#include "pysicgl/types/rle_sprite.h"
+#include "pysicgl/types/scalar_expression.h"
 #include "pysicgl/types/scalar_field.h"
 #include "pysicgl/types/screen.h"
+#include "pysicgl/types/sprite_atlas.h"
+#include "pysicgl/types/supersampler.h"
 #include "sicgl.h"
 
 /**
@@ -80,7 +89,16 @@ static type_entry_t pysicgl_types[] = {
     {"ColorSequenceInterpolator", &ColorSequenceInterpolatorType},
     {"Screen", &ScreenType},
     {"ScalarField", &ScalarFieldType},
+    {"ScalarExpression", &ScalarExpressionType},
     {"Compositor", &CompositorType},
+    {"LayerStack", &LayerStackType},
+    {"Bloom", &BloomType},
+    {"Supersampler", &SupersamplerType},
+    {"Font", &FontType},
+    {"SpriteAtlas", &SpriteAtlasType},
+    {"RLESprite", &RLESpriteType},
+    {"IndexedInterface", &IndexedInterfaceType},
+    {"HDRInterface", &HDRInterfaceType},
 };
 static size_t num_types = sizeof(pysicgl_types) / sizeof(type_entry_t);
 
@@ -108,6 +126,20 @@ PyMODINIT_FUNC PyInit__core(void) {
 
   // create the module
   PyObject* m = PyModule_Create(&module);
+  if (NULL == m) {
+    return NULL;
+  }
+
+  // scalar field storage formats
+  if ((PyModule_AddIntConstant(
+           m, "SCALAR_STORAGE_FLOAT64", SCALAR_STORAGE_FLOAT64) < 0) ||
+      (PyModule_AddIntConstant(
+           m, "SCALAR_STORAGE_FLOAT32", SCALAR_STORAGE_FLOAT32) < 0) ||
+      (PyModule_AddIntConstant(
+           m, "SCALAR_STORAGE_UINT16", SCALAR_STORAGE_UINT16) < 0)) {
+    Py_DECREF(m);
+    return NULL;
+  }
 
   // register types into the module
   for (size_t idx = 0; idx < num_types; idx++) {
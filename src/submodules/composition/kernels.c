@@ -0,0 +1,147 @@
+#include "pysicgl/submodules/composition/kernels.h"
+
+#include <string.h>
+
+#include "pysicgl/utilities/color.h"
+
+// generates a compose loop around an inlined per-pixel operation, which
+// the compiler is free to unroll and vectorize
+#define DEFINE_COMPOSE_KERNEL(name, op)                                  \
+  void compositor_specialized_##name(                                    \
+      color_t* source, color_t* destination, size_t width, void* args) { \
+    (void)args;                                                          \
+    for (size_t idx = 0; idx < width; idx++) {                           \
+      destination[idx] = op(source[idx], destination[idx]);              \
+    }                                                                    \
+  }
+
+static inline color_t op_clear(color_t source, color_t destination) {
+  (void)source;
+  (void)destination;
+  return 0;
+}
+
+static inline color_t op_and(color_t source, color_t destination) {
+  return source & destination;
+}
+
+static inline color_t op_or(color_t source, color_t destination) {
+  return source | destination;
+}
+
+static inline color_t op_xor(color_t source, color_t destination) {
+  return source ^ destination;
+}
+
+static inline color_t op_nand(color_t source, color_t destination) {
+  return ~(source & destination);
+}
+
+static inline color_t op_nor(color_t source, color_t destination) {
+  return ~(source | destination);
+}
+
+static inline color_t op_xnor(color_t source, color_t destination) {
+  return ~(source ^ destination);
+}
+
+static inline color_t channel_min(color_t a, color_t b) {
+  return (a < b) ? a : b;
+}
+
+static inline color_t channel_max(color_t a, color_t b) {
+  return (a > b) ? a : b;
+}
+
+static inline color_t op_min(color_t source, color_t destination) {
+  return color_from_channels(
+      channel_min(color_channel_red(source), color_channel_red(destination)),
+      channel_min(
+          color_channel_green(source), color_channel_green(destination)),
+      channel_min(color_channel_blue(source), color_channel_blue(destination)),
+      channel_min(
+          color_channel_alpha(source), color_channel_alpha(destination)));
+}
+
+static inline color_t op_max(color_t source, color_t destination) {
+  return color_from_channels(
+      channel_max(color_channel_red(source), color_channel_red(destination)),
+      channel_max(
+          color_channel_green(source), color_channel_green(destination)),
+      channel_max(color_channel_blue(source), color_channel_blue(destination)),
+      channel_max(
+          color_channel_alpha(source), color_channel_alpha(destination)));
+}
+
+// the direct compositors reduce to memory operations
+void compositor_specialized_direct_set(
+    color_t* source, color_t* destination, size_t width, void* args) {
+  (void)args;
+  memmove(destination, source, width * sizeof(color_t));
+}
+
+DEFINE_COMPOSE_KERNEL(direct_clear, op_clear)
+
+void compositor_specialized_direct_none(
+    color_t* source, color_t* destination, size_t width, void* args) {
+  (void)source;
+  (void)destination;
+  (void)width;
+  (void)args;
+}
+
+DEFINE_COMPOSE_KERNEL(bitwise_and, op_and)
+DEFINE_COMPOSE_KERNEL(bitwise_or, op_or)
+DEFINE_COMPOSE_KERNEL(bitwise_xor, op_xor)
+DEFINE_COMPOSE_KERNEL(bitwise_nand, op_nand)
+DEFINE_COMPOSE_KERNEL(bitwise_nor, op_nor)
+DEFINE_COMPOSE_KERNEL(bitwise_xnor, op_xnor)
+DEFINE_COMPOSE_KERNEL(channelwise_min, op_min)
+DEFINE_COMPOSE_KERNEL(channelwise_max, op_max)
+
+// blends one premultiplied channel of the source and destination
+static inline color_t premultiplied_channel(
+    color_t source, color_t destination, color_t fa, color_t fb) {
+  return clamp_u8(div255(source * fa) + div255(destination * fb));
+}
+
+// generates a porter-duff compose loop for premultiplied alpha colors, each
+// channel of the result is (source * fa + destination * fb) where the factors
+// are expressions of the source and destination alpha, sa and da, in [0, 255]
+#define DEFINE_PREMULTIPLIED_KERNEL(name, fa, fb)                        \
+  void compositor_premultiplied_##name(                                  \
+      color_t* source, color_t* destination, size_t width, void* args) { \
+    (void)args;                                                          \
+    for (size_t idx = 0; idx < width; idx++) {                           \
+      color_t s = source[idx];                                           \
+      color_t d = destination[idx];                                      \
+      color_t sa = color_channel_alpha(s);                               \
+      color_t da = color_channel_alpha(d);                               \
+      (void)sa;                                                          \
+      (void)da;                                                          \
+      color_t a = (fa);                                                  \
+      color_t b = (fb);                                                  \
+      destination[idx] = color_from_channels(                            \
+          premultiplied_channel(                                         \
+              color_channel_red(s), color_channel_red(d), a, b),         \
+          premultiplied_channel(                                         \
+              color_channel_green(s), color_channel_green(d), a, b),     \
+          premultiplied_channel(                                         \
+              color_channel_blue(s), color_channel_blue(d), a, b),       \
+          premultiplied_channel(sa, da, a, b));                          \
+    }                                                                    \
+  }
+
+DEFINE_PREMULTIPLIED_KERNEL(clear, 0, 0)
+DEFINE_PREMULTIPLIED_KERNEL(copy, 255, 0)
+DEFINE_PREMULTIPLIED_KERNEL(destination, 0, 255)
+DEFINE_PREMULTIPLIED_KERNEL(source_over, 255, 255 - sa)
+DEFINE_PREMULTIPLIED_KERNEL(destination_over, 255 - da, 255)
+DEFINE_PREMULTIPLIED_KERNEL(source_in, da, 0)
+DEFINE_PREMULTIPLIED_KERNEL(destination_in, 0, sa)
+DEFINE_PREMULTIPLIED_KERNEL(source_out, 255 - da, 0)
+DEFINE_PREMULTIPLIED_KERNEL(destination_out, 0, 255 - sa)
+DEFINE_PREMULTIPLIED_KERNEL(source_atop, da, 255 - sa)
+DEFINE_PREMULTIPLIED_KERNEL(destination_atop, 255 - da, sa)
+DEFINE_PREMULTIPLIED_KERNEL(xor, 255 - da, 255 - sa)
+DEFINE_PREMULTIPLIED_KERNEL(lighter, 255, 255)
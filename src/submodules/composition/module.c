@@ -2,6 +2,7 @@
 #include <Python.h>
 // python includes first (clang-format)
 
+#include "pysicgl/submodules/composition/kernels.h"
 #include "pysicgl/types/compositor.h"
 #include "sicgl/compositors.h"
 
@@ -15,62 +16,93 @@ static type_entry_t pysicgl_types[] = {
 };
 static size_t num_types = sizeof(pysicgl_types) / sizeof(type_entry_t);
 
-// collect compositors for the module
+// collect compositors for the module, those with a specialized kernel use
+// it in place of the sicgl compositor, which may be absent
+//
+// only compositors whose per-pixel operation is exact bit or channel
+// selection are specialized. the channelwise arithmetic and the alpha
+// compositors round, clamp and divide as sicgl defines them, so they call
+// the sicgl compositor to keep its results bit for bit.
 typedef struct _compositor_entry_t {
   const char* name;
   compositor_fn fn;
+  compositor_fn specialized;
 } compositor_entry_t;
 static compositor_entry_t compositors[] = {
     // direct compositors
-    {"DIRECT_SET", compositor_direct_set},
-    {"DIRECT_CLEAR", compositor_direct_clear},
-    {"DIRECT_NONE", compositor_direct_none},
+    {"DIRECT_SET", compositor_direct_set, compositor_specialized_direct_set},
+    {"DIRECT_CLEAR", compositor_direct_clear,
+     compositor_specialized_direct_clear},
+    {"DIRECT_NONE", compositor_direct_none, compositor_specialized_direct_none},
 
     // bitwise compositors
-    {"BIT_AND", compositor_bitwise_and},
-    {"BIT_OR", compositor_bitwise_or},
-    {"BIT_XOR", compositor_bitwise_xor},
-    {"BIT_NAND", compositor_bitwise_nand},
-    {"BIT_NOR", compositor_bitwise_nor},
-    {"BIT_XNOR", compositor_bitwise_xnor},
+    {"BIT_AND", compositor_bitwise_and, compositor_specialized_bitwise_and},
+    {"BIT_OR", compositor_bitwise_or, compositor_specialized_bitwise_or},
+    {"BIT_XOR", compositor_bitwise_xor, compositor_specialized_bitwise_xor},
+    {"BIT_NAND", compositor_bitwise_nand, compositor_specialized_bitwise_nand},
+    {"BIT_NOR", compositor_bitwise_nor, compositor_specialized_bitwise_nor},
+    {"BIT_XNOR", compositor_bitwise_xnor, compositor_specialized_bitwise_xnor},
     // // These bitwise compositors are not implemented yet in sicgl.
     // {"BIT_NOT_SOURCE", compositor_bitwise_not_source},
     // {"BIT_NOT_DESTINATION", compositor_bitwise_not_destination},
 
     // channelwise compositors
-    {"CHANNEL_MIN", compositor_channelwise_min},
-    {"CHANNEL_MAX", compositor_channelwise_max},
-
-    {"CHANNEL_SUM", compositor_channelwise_sum},
-    {"CHANNEL_DIFF", compositor_channelwise_diff},
-    {"CHANNEL_DIFF_REVERSE", compositor_channelwise_diff_reverse},
-    {"CHANNEL_MULTIPLY", compositor_channelwise_multiply},
-    {"CHANNEL_DIVIDE", compositor_channelwise_divide},
-    {"CHANNEL_DIVIDE_REVERSE", compositor_channelwise_divide_reverse},
-
-    {"CHANNEL_SUM_CLAMPED", compositor_channelwise_sum_clamped},
-    {"CHANNEL_DIFF_CLAMPED", compositor_channelwise_diff_clamped},
+    {"CHANNEL_MIN", compositor_channelwise_min,
+     compositor_specialized_channelwise_min},
+    {"CHANNEL_MAX", compositor_channelwise_max,
+     compositor_specialized_channelwise_max},
+
+    // arithmetic is left to sicgl, see above
+    {"CHANNEL_SUM", compositor_channelwise_sum, NULL},
+    {"CHANNEL_DIFF", compositor_channelwise_diff, NULL},
+    {"CHANNEL_DIFF_REVERSE", compositor_channelwise_diff_reverse, NULL},
+    {"CHANNEL_MULTIPLY", compositor_channelwise_multiply, NULL},
+    {"CHANNEL_DIVIDE", compositor_channelwise_divide, NULL},
+    {"CHANNEL_DIVIDE_REVERSE", compositor_channelwise_divide_reverse, NULL},
+
+    {"CHANNEL_SUM_CLAMPED", compositor_channelwise_sum_clamped, NULL},
+    {"CHANNEL_DIFF_CLAMPED", compositor_channelwise_diff_clamped, NULL},
     {"CHANNEL_DIFF_REVERSE_CLAMPED",
-     compositor_channelwise_diff_reverse_clamped},
-    {"CHANNEL_MULTIPLY_CLAMPED", compositor_channelwise_multiply_clamped},
-    {"CHANNEL_DIVIDE_CLAMPED", compositor_channelwise_divide_clamped},
+     compositor_channelwise_diff_reverse_clamped, NULL},
+    {"CHANNEL_MULTIPLY_CLAMPED", compositor_channelwise_multiply_clamped, NULL},
+    {"CHANNEL_DIVIDE_CLAMPED", compositor_channelwise_divide_clamped, NULL},
     {"CHANNEL_DIVIDE_REVERSE_CLAMPED",
-     compositor_channelwise_divide_reverse_clamped},
+     compositor_channelwise_divide_reverse_clamped, NULL},
 
     // porter-duff alpha compositing
-    {"ALPHA_CLEAR", compositor_alpha_clear},
-    {"ALPHA_COPY", compositor_alpha_copy},
-    {"ALPHA_DESTINATION", compositor_alpha_destination},
-    {"ALPHA_SOURCE_OVER", compositor_alpha_source_over},
-    {"ALPHA_DESTINATION_OVER", compositor_alpha_destination_over},
-    {"ALPHA_SOURCE_IN", compositor_alpha_source_in},
-    {"ALPHA_DESTINATION_IN", compositor_alpha_destination_in},
-    {"ALPHA_SOURCE_OUT", compositor_alpha_source_out},
-    {"ALPHA_DESTINATION_OUT", compositor_alpha_destination_out},
-    {"ALPHA_SOURCE_ATOP", compositor_alpha_source_atop},
-    {"ALPHA_DESTINATION_ATOP", compositor_alpha_destination_atop},
-    {"ALPHA_XOR", compositor_alpha_xor},
-    {"ALPHA_LIGHTER", compositor_alpha_lighter},
+    {"ALPHA_CLEAR", compositor_alpha_clear, NULL},
+    {"ALPHA_COPY", compositor_alpha_copy, NULL},
+    {"ALPHA_DESTINATION", compositor_alpha_destination, NULL},
+    {"ALPHA_SOURCE_OVER", compositor_alpha_source_over, NULL},
+    {"ALPHA_DESTINATION_OVER", compositor_alpha_destination_over, NULL},
+    {"ALPHA_SOURCE_IN", compositor_alpha_source_in, NULL},
+    {"ALPHA_DESTINATION_IN", compositor_alpha_destination_in, NULL},
+    {"ALPHA_SOURCE_OUT", compositor_alpha_source_out, NULL},
+    {"ALPHA_DESTINATION_OUT", compositor_alpha_destination_out, NULL},
+    {"ALPHA_SOURCE_ATOP", compositor_alpha_source_atop, NULL},
+    {"ALPHA_DESTINATION_ATOP", compositor_alpha_destination_atop, NULL},
+    {"ALPHA_XOR", compositor_alpha_xor, NULL},
+    {"ALPHA_LIGHTER", compositor_alpha_lighter, NULL},
+
+    // porter-duff alpha compositing of premultiplied alpha colors, these
+    // have no sicgl counterpart
+    {"PREMULTIPLIED_CLEAR", NULL, compositor_premultiplied_clear},
+    {"PREMULTIPLIED_COPY", NULL, compositor_premultiplied_copy},
+    {"PREMULTIPLIED_DESTINATION", NULL, compositor_premultiplied_destination},
+    {"PREMULTIPLIED_SOURCE_OVER", NULL, compositor_premultiplied_source_over},
+    {"PREMULTIPLIED_DESTINATION_OVER", NULL,
+     compositor_premultiplied_destination_over},
+    {"PREMULTIPLIED_SOURCE_IN", NULL, compositor_premultiplied_source_in},
+    {"PREMULTIPLIED_DESTINATION_IN", NULL,
+     compositor_premultiplied_destination_in},
+    {"PREMULTIPLIED_SOURCE_OUT", NULL, compositor_premultiplied_source_out},
+    {"PREMULTIPLIED_DESTINATION_OUT", NULL,
+     compositor_premultiplied_destination_out},
+    {"PREMULTIPLIED_SOURCE_ATOP", NULL, compositor_premultiplied_source_atop},
+    {"PREMULTIPLIED_DESTINATION_ATOP", NULL,
+     compositor_premultiplied_destination_atop},
+    {"PREMULTIPLIED_XOR", NULL, compositor_premultiplied_xor},
+    {"PREMULTIPLIED_LIGHTER", NULL, compositor_premultiplied_lighter},
 };
 static size_t num_compositors =
     sizeof(compositors) / sizeof(compositor_entry_t);
@@ -98,11 +130,26 @@ PyMODINIT_FUNC PyInit_composition(void) {
 
   // create the module
   PyObject* m = PyModule_Create(&module);
+  if (NULL == m) {
+    return NULL;
+  }
+
+  // the sicgl compositors are kept available by name in a dictionary
+  PyObject* generic = PyDict_New();
+  if ((NULL == generic) || (PyModule_AddObject(m, "generic", generic) < 0)) {
+    Py_XDECREF(generic);
+    Py_DECREF(m);
+    return NULL;
+  }
 
   // create and register compositors
   for (size_t idx = 0; idx < num_compositors; idx++) {
     compositor_entry_t entry = compositors[idx];
-    CompositorObject* obj = new_compositor_object(entry.fn, NULL);
+    compositor_fn fn = entry.fn;
+    if (NULL != entry.specialized) {
+      fn = entry.specialized;
+    }
+    CompositorObject* obj = new_compositor_object(fn, NULL);
     if (NULL == obj) {
       PyErr_SetString(PyExc_OSError, "failed to create compositor object");
       return NULL;
@@ -114,6 +161,19 @@ PyMODINIT_FUNC PyInit_composition(void) {
           PyExc_OSError, "failed to add compositor object to module");
       return NULL;
     }
+
+    if (NULL == entry.fn) {
+      continue;
+    }
+    CompositorObject* generic_obj = new_compositor_object(entry.fn, NULL);
+    if ((NULL == generic_obj) ||
+        (PyDict_SetItemString(generic, entry.name, (PyObject*)generic_obj) <
+         0)) {
+      Py_XDECREF(generic_obj);
+      Py_DECREF(m);
+      return NULL;
+    }
+    Py_DECREF(generic_obj);
   }
 
   return m;
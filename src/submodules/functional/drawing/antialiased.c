@@ -0,0 +1,460 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <math.h>
+#include <stdbool.h>
+
+#include "pysicgl/submodules/functional/drawing/antialiased.h"
+#include "pysicgl/submodules/functional/drawing/target.h"
+#include "pysicgl/types/interface.h"
+#include "pysicgl/utilities/color.h"
+
+/**
+ * @brief Blend the color of the target into one pixel.
+ *
+ * @param target
+ * @param u in interface coordinates.
+ * @param v in interface coordinates.
+ * @param coverage fraction of the pixel covered, in [0, 1].
+ */
+static inline void aa_plot(
+    draw_target_t* target, ext_t u, ext_t v, double coverage) {
+  if ((u < target->u0) || (u > target->u1) || (v < target->v0) ||
+      (v > target->v1)) {
+    return;
+  }
+  color_t amount = (color_t)(coverage * 255.0 + 0.5);
+  if (amount <= 0) {
+    return;
+  }
+  color_t* pixel =
+      &target->interface->memory[v * target->interface->screen->width + u];
+  *pixel = color_blend_coverage(*pixel, target->color, clamp_u8(amount));
+}
+
+// plots with the axes exchanged when a line is steep
+static inline void aa_plot_axes(
+    draw_target_t* target, bool steep, ext_t x, ext_t y, double coverage) {
+  if (steep) {
+    aa_plot(target, y, x, coverage);
+  } else {
+    aa_plot(target, x, y, coverage);
+  }
+}
+
+static inline double fraction(double value) { return value - floor(value); }
+
+// limits a value to a range before it is converted to ext_t
+static inline double clamp(double value, double low, double high) {
+  return fmin(fmax(value, low), high);
+}
+
+/**
+ * @brief Narrow the parameter range of a segment against one boundary.
+ *
+ * @param p change of the boundary distance along the segment.
+ * @param q boundary distance at the start of the segment.
+ * @param edge index of the boundary.
+ * @param t range of the segment which is visible, within [0, 1].
+ * @param edges boundary which limits each end of the range, or -1.
+ * @return true while part of the segment remains visible.
+ */
+static inline bool clip_boundary(
+    double p, double q, int edge, double t[2], int edges[2]) {
+  if (0.0 == p) {
+    return q >= 0.0;
+  }
+  double ratio = q / p;
+  if (p < 0.0) {
+    if (ratio > t[1]) {
+      return false;
+    }
+    if (ratio > t[0]) {
+      t[0] = ratio;
+      edges[0] = edge;
+    }
+  } else {
+    if (ratio < t[0]) {
+      return false;
+    }
+    if (ratio < t[1]) {
+      t[1] = ratio;
+      edges[1] = edge;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Clip a segment to the target with the Liang-Barsky algorithm.
+ *
+ * The target is grown by a margin so that the ends of a clipped segment
+ * lie outside of it, which leaves the weights of visible pixels unchanged.
+ * A clipped end is placed exactly on its boundary since the parameter
+ * loses precision for very long segments. Afterwards the endpoints may be
+ * safely cast to ext_t.
+ *
+ * @param target
+ * @param x start and end along u in interface coordinates, clipped in place.
+ * @param y start and end along v in interface coordinates, clipped in place.
+ * @return true when part of the segment is within the target.
+ */
+static bool clip_segment(draw_target_t* target, double x[2], double y[2]) {
+  static const double margin = 2.0;
+  if (!isfinite(x[0]) || !isfinite(y[0]) || !isfinite(x[1]) ||
+      !isfinite(y[1])) {
+    return false;
+  }
+  double bounds[4] = {
+      target->u0 - margin,
+      target->u1 + margin,
+      target->v0 - margin,
+      target->v1 + margin,
+  };
+  double dx = x[1] - x[0];
+  double dy = y[1] - y[0];
+  double t[2] = {0.0, 1.0};
+  int edges[2] = {-1, -1};
+  if (!clip_boundary(-dx, x[0] - bounds[0], 0, t, edges) ||
+      !clip_boundary(dx, bounds[1] - x[0], 1, t, edges) ||
+      !clip_boundary(-dy, y[0] - bounds[2], 2, t, edges) ||
+      !clip_boundary(dy, bounds[3] - y[0], 3, t, edges)) {
+    return false;
+  }
+  double start_x = x[0];
+  double start_y = y[0];
+  for (size_t end = 0; end < 2; end++) {
+    if (edges[end] < 0) {
+      continue;
+    }
+    x[end] = (edges[end] < 2) ? bounds[edges[end]] : start_x + t[end] * dx;
+    y[end] = (edges[end] < 2) ? start_y + t[end] * dy : bounds[edges[end]];
+  }
+  return true;
+}
+
+/**
+ * @brief Draw an anti-aliased line with Wu's algorithm.
+ *
+ * Pixel centers lie at integer coordinates. Along the major axis each
+ * column touches the two pixels straddling the line, weighted by their
+ * distance to it. The segment is clipped to the target first, columns
+ * outside the target are skipped.
+ *
+ * @param target
+ * @param x0 start in interface coordinates.
+ * @param y0
+ * @param x1 end in interface coordinates.
+ * @param y1
+ */
+static void aa_line(
+    draw_target_t* target, double x0, double y0, double x1, double y1) {
+  double xs[2] = {x0, x1};
+  double ys[2] = {y0, y1};
+  if (!clip_segment(target, xs, ys)) {
+    return;
+  }
+  x0 = xs[0], y0 = ys[0], x1 = xs[1], y1 = ys[1];
+  bool steep = fabs(y1 - y0) > fabs(x1 - x0);
+  double swap;
+  if (steep) {
+    swap = x0, x0 = y0, y0 = swap;
+    swap = x1, x1 = y1, y1 = swap;
+  }
+  if (x0 > x1) {
+    swap = x0, x0 = x1, x1 = swap;
+    swap = y0, y0 = y1, y1 = swap;
+  }
+  double dx = x1 - x0;
+  double gradient = (0.0 == dx) ? 1.0 : (y1 - y0) / dx;
+
+  // the ends are weighted by how much of their column the line spans
+  ext_t first = (ext_t)floor(x0 + 0.5);
+  ext_t last = (ext_t)floor(x1 + 0.5);
+  double first_y = y0 + gradient * (first - x0);
+  double last_y = y1 + gradient * (last - x1);
+  double first_gap = 1.0 - fraction(x0 + 0.5);
+  double last_gap = fraction(x1 + 0.5);
+  if (first == last) {
+    first_gap = 1.0;
+  }
+  ext_t row = (ext_t)floor(first_y);
+  aa_plot_axes(
+      target, steep, first, row, (1.0 - fraction(first_y)) * first_gap);
+  aa_plot_axes(target, steep, first, row + 1, fraction(first_y) * first_gap);
+  if (first == last) {
+    return;
+  }
+  row = (ext_t)floor(last_y);
+  aa_plot_axes(
+      target, steep, last, row, (1.0 - fraction(last_y)) * last_gap);
+  aa_plot_axes(target, steep, last, row + 1, fraction(last_y) * last_gap);
+
+  // only the columns of the major axis which are drawable
+  ext_t low = steep ? target->v0 : target->u0;
+  ext_t high = steep ? target->v1 : target->u1;
+  ext_t start = (first + 1 > low) ? first + 1 : low;
+  ext_t end = (last - 1 < high) ? last - 1 : high;
+  double y = first_y + gradient * (start - first);
+  for (ext_t x = start; x <= end; x++, y += gradient) {
+    row = (ext_t)floor(y);
+    aa_plot_axes(target, steep, x, row, 1.0 - fraction(y));
+    aa_plot_axes(target, steep, x, row + 1, fraction(y));
+  }
+}
+
+/**
+ * @brief Draw an anti-aliased ellipse outline.
+ *
+ * The flat parts of the outline are stepped by column and the steep parts
+ * by row, so that each step touches the two pixels straddling the outline
+ * like a Wu line. The center need not be on a pixel.
+ *
+ * @param target
+ * @param cx center in interface coordinates.
+ * @param cy
+ * @param a semi-axis along u.
+ * @param b semi-axis along v.
+ */
+static void aa_ellipse(
+    draw_target_t* target, double cx, double cy, double a, double b) {
+  if ((a <= 0.0) || (b <= 0.0)) {
+    double u = floor(cx + 0.5);
+    double v = floor(cy + 0.5);
+    if ((u >= target->u0) && (u <= target->u1) && (v >= target->v0) &&
+        (v <= target->v1)) {
+      aa_plot(target, (ext_t)u, (ext_t)v, 1.0);
+    }
+    return;
+  }
+
+  // the slope of the outline is one where these offsets are reached
+  double hypotenuse = hypot(a, b);
+  double flat = a * (a / hypotenuse);
+  double steep = b * (b / hypotenuse);
+
+  // ranges and edges are clamped to the target before conversion to
+  // ext_t, edges just outside of it plot nothing
+  ext_t start = (ext_t)clamp(ceil(cx - flat), target->u0, target->u1 + 1.0);
+  ext_t end = (ext_t)clamp(floor(cx + flat), target->u0 - 1.0, target->u1);
+  for (ext_t u = start; u <= end; u++) {
+    double x = (u - cx) / a;
+    double offset = b * sqrt(fmax(0.0, 1.0 - x * x));
+    double edges[2] = {cy - offset, cy + offset};
+    for (size_t idx = 0; idx < 2; idx++) {
+      double edge = clamp(edges[idx], target->v0 - 1.0, target->v1 + 1.0);
+      ext_t v = (ext_t)floor(edge);
+      aa_plot(target, u, v, 1.0 - fraction(edge));
+      aa_plot(target, u, v + 1, fraction(edge));
+    }
+  }
+
+  // rows already covered by the columns are skipped
+  start = (ext_t)clamp(ceil(cy - steep), target->v0, target->v1 + 1.0);
+  end = (ext_t)clamp(floor(cy + steep), target->v0 - 1.0, target->v1);
+  for (ext_t v = start; v <= end; v++) {
+    double y = (v - cy) / b;
+    double offset = a * sqrt(fmax(0.0, 1.0 - y * y));
+    if (offset <= flat) {
+      continue;
+    }
+    double edges[2] = {cx - offset, cx + offset};
+    for (size_t idx = 0; idx < 2; idx++) {
+      double edge = clamp(edges[idx], target->u0 - 1.0, target->u1 + 1.0);
+      ext_t u = (ext_t)floor(edge);
+      aa_plot(target, u, v, 1.0 - fraction(edge));
+      aa_plot(target, u + 1, v, fraction(edge));
+    }
+  }
+}
+
+/**
+ * @brief Draw an anti-aliased ellipse or report invalid semi-axes.
+ *
+ * @return PyObject* None, or NULL with the Python error indicator set.
+ */
+static PyObject* draw_ellipse(
+    interface_t* interface, screen_t* screen, bool local, color_t color,
+    double u, double v, double semiu, double semiv) {
+  if (!isfinite(u) || !isfinite(v) || !isfinite(semiu) || !isfinite(semiv)) {
+    PyErr_SetString(PyExc_ValueError, "position and size must be finite");
+    return NULL;
+  }
+  if ((semiu < 0.0) || (semiv < 0.0)) {
+    PyErr_SetString(PyExc_ValueError, "size must not be negative");
+    return NULL;
+  }
+  draw_target_t target;
+  int ret = draw_target_init(&target, interface, color, screen, local);
+  if (ret < 0) {
+    return NULL;
+  }
+  if (ret > 0) {
+    aa_ellipse(&target, u + target.du, v + target.dv, semiu, semiv);
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static PyObject* draw_line(
+    interface_t* interface, screen_t* screen, bool local, color_t color,
+    double u0, double v0, double u1, double v1) {
+  draw_target_t target;
+  int ret = draw_target_init(&target, interface, color, screen, local);
+  if (ret < 0) {
+    return NULL;
+  }
+  if (ret > 0) {
+    aa_line(
+        &target, u0 + target.du, v0 + target.dv, u1 + target.du,
+        v1 + target.dv);
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+PyObject* interface_line_aa(PyObject* self_in, PyObject* args) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  int color;
+  double u0, v0, u1, v1;
+  if (!PyArg_ParseTuple(
+          args, "O!i(dd)(dd)", &InterfaceType, &interface_obj, &color, &u0,
+          &v0, &u1, &v1)) {
+    return NULL;
+  }
+
+  return draw_line(
+      &interface_obj->interface, NULL, true, color, u0, v0, u1, v1);
+}
+
+PyObject* interface_circle_aa(PyObject* self_in, PyObject* args) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  int color;
+  double u0, v0, diameter;
+  if (!PyArg_ParseTuple(
+          args, "O!i(dd)d", &InterfaceType, &interface_obj, &color, &u0, &v0,
+          &diameter)) {
+    return NULL;
+  }
+
+  return draw_ellipse(
+      &interface_obj->interface, NULL, true, color, u0, v0, diameter / 2.0,
+      diameter / 2.0);
+}
+
+PyObject* interface_ellipse_aa(PyObject* self_in, PyObject* args) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  int color;
+  double u0, v0, semiu, semiv;
+  if (!PyArg_ParseTuple(
+          args, "O!i(dd)(dd)", &InterfaceType, &interface_obj, &color, &u0,
+          &v0, &semiu, &semiv)) {
+    return NULL;
+  }
+
+  return draw_ellipse(
+      &interface_obj->interface, NULL, true, color, u0, v0, semiu, semiv);
+}
+
+PyObject* screen_line_aa(PyObject* self_in, PyObject* args) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  ScreenObject* screen_obj;
+  int color;
+  double u0, v0, u1, v1;
+  if (!PyArg_ParseTuple(
+          args, "O!O!i(dd)(dd)", &InterfaceType, &interface_obj, &ScreenType,
+          &screen_obj, &color, &u0, &v0, &u1, &v1)) {
+    return NULL;
+  }
+
+  return draw_line(
+      &interface_obj->interface, screen_obj->screen, false, color, u0, v0, u1,
+      v1);
+}
+
+PyObject* screen_circle_aa(PyObject* self_in, PyObject* args) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  ScreenObject* screen_obj;
+  int color;
+  double u0, v0, diameter;
+  if (!PyArg_ParseTuple(
+          args, "O!O!i(dd)d", &InterfaceType, &interface_obj, &ScreenType,
+          &screen_obj, &color, &u0, &v0, &diameter)) {
+    return NULL;
+  }
+
+  return draw_ellipse(
+      &interface_obj->interface, screen_obj->screen, false, color, u0, v0,
+      diameter / 2.0, diameter / 2.0);
+}
+
+PyObject* screen_ellipse_aa(PyObject* self_in, PyObject* args) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  ScreenObject* screen_obj;
+  int color;
+  double u0, v0, semiu, semiv;
+  if (!PyArg_ParseTuple(
+          args, "O!O!i(dd)(dd)", &InterfaceType, &interface_obj, &ScreenType,
+          &screen_obj, &color, &u0, &v0, &semiu, &semiv)) {
+    return NULL;
+  }
+
+  return draw_ellipse(
+      &interface_obj->interface, screen_obj->screen, false, color, u0, v0,
+      semiu, semiv);
+}
+
+PyObject* global_line_aa(PyObject* self_in, PyObject* args) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  int color;
+  double u0, v0, u1, v1;
+  if (!PyArg_ParseTuple(
+          args, "O!i(dd)(dd)", &InterfaceType, &interface_obj, &color, &u0,
+          &v0, &u1, &v1)) {
+    return NULL;
+  }
+
+  return draw_line(
+      &interface_obj->interface, NULL, false, color, u0, v0, u1, v1);
+}
+
+PyObject* global_circle_aa(PyObject* self_in, PyObject* args) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  int color;
+  double u0, v0, diameter;
+  if (!PyArg_ParseTuple(
+          args, "O!i(dd)d", &InterfaceType, &interface_obj, &color, &u0, &v0,
+          &diameter)) {
+    return NULL;
+  }
+
+  return draw_ellipse(
+      &interface_obj->interface, NULL, false, color, u0, v0, diameter / 2.0,
+      diameter / 2.0);
+}
+
+PyObject* global_ellipse_aa(PyObject* self_in, PyObject* args) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  int color;
+  double u0, v0, semiu, semiv;
+  if (!PyArg_ParseTuple(
+          args, "O!i(dd)(dd)", &InterfaceType, &interface_obj, &color, &u0,
+          &v0, &semiu, &semiv)) {
+    return NULL;
+  }
+
+  return draw_ellipse(
+      &interface_obj->interface, NULL, false, color, u0, v0, semiu, semiv);
+}
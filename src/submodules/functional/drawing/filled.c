@@ -0,0 +1,609 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "pysicgl/submodules/functional/drawing/filled.h"
+#include "pysicgl/submodules/functional/drawing/target.h"
+#include "pysicgl/types/interface.h"
+
+// utilities for C consumers
+////////////////////////////
+
+/**
+ * @brief Fill the pixels of a row whose centers lie within [left, right].
+ *
+ * @param target
+ * @param v row in interface coordinates.
+ * @param left in interface coordinates.
+ * @param right in interface coordinates.
+ */
+static inline void fill_between(
+    draw_target_t* target, ext_t v, double left, double right) {
+  if ((left > right) || (left > target->u1) || (right < target->u0)) {
+    return;
+  }
+  // clamp before converting so that huge shapes cannot overflow
+  left = fmax(left, target->u0);
+  right = fmin(right, target->u1);
+  draw_target_span(target, v, (ext_t)ceil(left), (ext_t)floor(right));
+}
+
+/**
+ * @brief Fill an ellipse one row at a time.
+ *
+ * @param target
+ * @param cx center in interface coordinates.
+ * @param cy
+ * @param a semi-axis along u.
+ * @param b semi-axis along v.
+ */
+static void fill_ellipse(
+    draw_target_t* target, double cx, double cy, double a, double b) {
+  if ((cy + b < target->v0) || (cy - b > target->v1)) {
+    return;
+  }
+  ext_t start = (ext_t)ceil(fmax(cy - b, target->v0));
+  ext_t end = (ext_t)floor(fmin(cy + b, target->v1));
+  for (ext_t v = start; v <= end; v++) {
+    double y = (b > 0.0) ? (v - cy) / b : 0.0;
+    double half = a * sqrt(fmax(0.0, 1.0 - y * y));
+    fill_between(target, v, cx - half, cx + half);
+  }
+}
+
+/**
+ * @brief Fill a rectangle with rounded corners one row at a time.
+ *
+ * @param target
+ * @param u0 corner in interface coordinates, inclusive.
+ * @param v0
+ * @param u1 opposite corner in interface coordinates, inclusive.
+ * @param v1
+ * @param radius radius of the corners, limited to half the smaller side.
+ */
+static void fill_rounded_rectangle(
+    draw_target_t* target, double u0, double v0, double u1, double v1,
+    double radius) {
+  double swap;
+  if (u0 > u1) {
+    swap = u0, u0 = u1, u1 = swap;
+  }
+  if (v0 > v1) {
+    swap = v0, v0 = v1, v1 = swap;
+  }
+  radius = fmin(radius, fmin(u1 - u0, v1 - v0) / 2.0);
+  if ((v1 < target->v0) || (v0 > target->v1)) {
+    return;
+  }
+
+  ext_t start = (ext_t)ceil(fmax(v0, target->v0));
+  ext_t end = (ext_t)floor(fmin(v1, target->v1));
+  for (ext_t v = start; v <= end; v++) {
+    // distance into the band of rows which holds the corners
+    double dy = 0.0;
+    if (v < v0 + radius) {
+      dy = v0 + radius - v;
+    } else if (v > v1 - radius) {
+      dy = v - (v1 - radius);
+    }
+    double inset = radius - sqrt(fmax(0.0, radius * radius - dy * dy));
+    fill_between(target, v, u0 + inset, u1 - inset);
+  }
+}
+
+// an edge of a polygon with its upper end first
+typedef struct _polygon_edge_t {
+  double u0, v0;
+  double v1;
+  double slope;
+  // +1 when the edge runs down in the polygon order and -1 when it runs up
+  int winding;
+} polygon_edge_t;
+
+// a crossing of the sample row by an edge
+typedef struct _polygon_crossing_t {
+  double u;
+  int winding;
+} polygon_crossing_t;
+
+static int compare_edges(const void* a, const void* b) {
+  double difference =
+      ((const polygon_edge_t*)a)->v0 - ((const polygon_edge_t*)b)->v0;
+  return (difference > 0.0) - (difference < 0.0);
+}
+
+/**
+ * @brief Fill a polygon with an active edge list.
+ *
+ * Each row is sampled at the pixel centers. Edges are sorted by their
+ * upper end and join the active list as the rows reach them, so each row
+ * only considers the edges which cross it. Edges cover the rows in
+ * [v0, v1) and spans the pixels in [left, right) so that polygons sharing
+ * an edge do not both fill it.
+ *
+ * @param target
+ * @param vertices pairs of coordinates in interface coordinates.
+ * @param count number of vertices.
+ * @param rule how the crossings of a row are paired into spans.
+ * @param edges scratch of count edges.
+ * @param crossings scratch of count crossings.
+ */
+static void fill_polygon(
+    draw_target_t* target, const double* vertices, size_t count,
+    polygon_fill_rule_t rule, polygon_edge_t* edges,
+    polygon_crossing_t* crossings) {
+  size_t num_edges = 0;
+  for (size_t idx = 0; idx < count; idx++) {
+    const double* a = &vertices[2 * idx];
+    const double* b = &vertices[2 * ((idx + 1) % count)];
+    if (a[1] == b[1]) {
+      // horizontal edges never cross a row
+      continue;
+    }
+    polygon_edge_t* edge = &edges[num_edges++];
+    const double* upper = (a[1] < b[1]) ? a : b;
+    const double* lower = (a[1] < b[1]) ? b : a;
+    edge->u0 = upper[0];
+    edge->v0 = upper[1];
+    edge->v1 = lower[1];
+    edge->slope = (lower[0] - upper[0]) / (lower[1] - upper[1]);
+    edge->winding = (a[1] < b[1]) ? 1 : -1;
+  }
+  if (0 == num_edges) {
+    return;
+  }
+  qsort(edges, num_edges, sizeof(polygon_edge_t), compare_edges);
+
+  double top = edges[0].v0;
+  double bottom = edges[0].v1;
+  for (size_t idx = 1; idx < num_edges; idx++) {
+    bottom = fmax(bottom, edges[idx].v1);
+  }
+  if ((bottom < target->v0) || (top > target->v1)) {
+    return;
+  }
+  ext_t start = (ext_t)ceil(fmax(top, target->v0));
+  ext_t end = (ext_t)ceil(fmin(bottom, target->v1 + 1.0)) - 1;
+
+  // edges before reached have started, of those the retired edges are
+  // swapped to the front and the active ones follow from active
+  size_t reached = 0;
+  size_t active = 0;
+  for (ext_t v = start; v <= end; v++) {
+    while ((reached < num_edges) && (edges[reached].v0 <= v)) {
+      reached++;
+    }
+    size_t num_crossings = 0;
+    for (size_t idx = active; idx < reached; idx++) {
+      polygon_edge_t* edge = &edges[idx];
+      if (edge->v1 <= v) {
+        // retire the edge for every later row
+        polygon_edge_t swap = edges[active];
+        edges[active] = *edge;
+        *edge = swap;
+        active++;
+        continue;
+      }
+      polygon_crossing_t crossing = {
+          .u = edge->u0 + (v - edge->v0) * edge->slope,
+          .winding = edge->winding,
+      };
+      // insertion sort, rows cross few edges
+      size_t position = num_crossings++;
+      while ((position > 0) && (crossings[position - 1].u > crossing.u)) {
+        crossings[position] = crossings[position - 1];
+        position--;
+      }
+      crossings[position] = crossing;
+    }
+
+    int winding = 0;
+    for (size_t idx = 0; idx + 1 < num_crossings; idx++) {
+      winding += crossings[idx].winding;
+      bool inside = (POLYGON_FILL_EVEN_ODD == rule) ? (0 == idx % 2)
+                                                    : (0 != winding);
+      if (inside) {
+        fill_between(
+            target, v, crossings[idx].u,
+            nextafter(crossings[idx + 1].u, -INFINITY));
+      }
+    }
+  }
+}
+
+/**
+ * @brief Parse a sequence of vertices into pairs of coordinates.
+ *
+ * @param vertices_obj sequence of (u, v) pairs.
+ * @param du added to each u.
+ * @param dv added to each v.
+ * @param vertices output, freed by the caller with PyMem_Free.
+ * @param count output number of vertices.
+ * @return int 0 on success, -1 with the Python error indicator set.
+ */
+static int parse_vertices(
+    PyObject* vertices_obj, double du, double dv, double** vertices,
+    size_t* count) {
+  int ret = 0;
+  double* output = NULL;
+  // private copies keep the coordinates alive and in place while
+  // converting them runs arbitrary code, which may mutate the vertices
+  PyObject* sequence = PySequence_Tuple(vertices_obj);
+  if (NULL == sequence) {
+    ret = -1;
+    goto out;
+  }
+  size_t length = (size_t)PyTuple_GET_SIZE(sequence);
+  output = PyMem_Malloc((length + 1) * 2 * sizeof(double));
+  if (NULL == output) {
+    PyErr_NoMemory();
+    ret = -1;
+    goto out;
+  }
+  for (size_t idx = 0; idx < length; idx++) {
+    PyObject* vertex = PySequence_Tuple(PyTuple_GET_ITEM(sequence, idx));
+    if (NULL == vertex) {
+      ret = -1;
+      goto out;
+    }
+    if (2 != PyTuple_GET_SIZE(vertex)) {
+      Py_DECREF(vertex);
+      PyErr_SetString(PyExc_ValueError, "vertices must be (u, v) pairs");
+      ret = -1;
+      goto out;
+    }
+    double u = PyFloat_AsDouble(PyTuple_GET_ITEM(vertex, 0));
+    double v = PyErr_Occurred()
+                   ? -1.0
+                   : PyFloat_AsDouble(PyTuple_GET_ITEM(vertex, 1));
+    Py_DECREF(vertex);
+    if (PyErr_Occurred()) {
+      ret = -1;
+      goto out;
+    }
+    if (!isfinite(u) || !isfinite(v)) {
+      PyErr_SetString(PyExc_ValueError, "vertices must be finite");
+      ret = -1;
+      goto out;
+    }
+    output[2 * idx] = u + du;
+    output[2 * idx + 1] = v + dv;
+  }
+  *vertices = output;
+  *count = length;
+  output = NULL;
+
+out:
+  Py_XDECREF(sequence);
+  PyMem_Free(output);
+  return ret;
+}
+
+// drawing
+//////////
+
+static PyObject* draw_ellipse(
+    interface_t* interface, screen_t* screen, bool local, color_t color,
+    double u, double v, double semiu, double semiv) {
+  if (!isfinite(u) || !isfinite(v) || !isfinite(semiu) || !isfinite(semiv)) {
+    PyErr_SetString(PyExc_ValueError, "position and size must be finite");
+    return NULL;
+  }
+  if ((semiu < 0.0) || (semiv < 0.0)) {
+    PyErr_SetString(PyExc_ValueError, "size must not be negative");
+    return NULL;
+  }
+  draw_target_t target;
+  int ret = draw_target_init(&target, interface, color, screen, local);
+  if (ret < 0) {
+    return NULL;
+  }
+  if (ret > 0) {
+    fill_ellipse(&target, u + target.du, v + target.dv, semiu, semiv);
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static PyObject* draw_rounded_rectangle(
+    interface_t* interface, screen_t* screen, bool local, color_t color,
+    ext_t u0, ext_t v0, ext_t u1, ext_t v1, double radius) {
+  if (!isfinite(radius)) {
+    PyErr_SetString(PyExc_ValueError, "radius must be finite");
+    return NULL;
+  }
+  if (radius < 0.0) {
+    PyErr_SetString(PyExc_ValueError, "radius must not be negative");
+    return NULL;
+  }
+  draw_target_t target;
+  int ret = draw_target_init(&target, interface, color, screen, local);
+  if (ret < 0) {
+    return NULL;
+  }
+  if (ret > 0) {
+    fill_rounded_rectangle(
+        &target, u0 + target.du, v0 + target.dv, u1 + target.du,
+        v1 + target.dv, radius);
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static PyObject* draw_polygon(
+    interface_t* interface, screen_t* screen, bool local, color_t color,
+    PyObject* vertices_obj, int rule) {
+  if ((POLYGON_FILL_EVEN_ODD != rule) && (POLYGON_FILL_NONZERO != rule)) {
+    PyErr_SetString(PyExc_ValueError, "unknown fill rule");
+    return NULL;
+  }
+  draw_target_t target;
+  int ret = draw_target_init(&target, interface, color, screen, local);
+  if (ret < 0) {
+    return NULL;
+  }
+  double* vertices = NULL;
+  size_t count = 0;
+  if (0 != parse_vertices(
+               vertices_obj, target.du, target.dv, &vertices, &count)) {
+    return NULL;
+  }
+
+  if ((ret > 0) && (count >= 3)) {
+    polygon_edge_t* edges = PyMem_Malloc(count * sizeof(polygon_edge_t));
+    polygon_crossing_t* crossings =
+        PyMem_Malloc(count * sizeof(polygon_crossing_t));
+    if ((NULL == edges) || (NULL == crossings)) {
+      PyMem_Free(edges);
+      PyMem_Free(crossings);
+      PyMem_Free(vertices);
+      return PyErr_NoMemory();
+    }
+    fill_polygon(
+        &target, vertices, count, (polygon_fill_rule_t)rule, edges,
+        crossings);
+    PyMem_Free(edges);
+    PyMem_Free(crossings);
+  }
+  PyMem_Free(vertices);
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+// interface relative drawing
+/////////////////////////////
+
+PyObject* interface_circle_filled(PyObject* self_in, PyObject* args) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  int color;
+  double u0, v0, diameter;
+  if (!PyArg_ParseTuple(
+          args, "O!i(dd)d", &InterfaceType, &interface_obj, &color, &u0, &v0,
+          &diameter)) {
+    return NULL;
+  }
+
+  return draw_ellipse(
+      &interface_obj->interface, NULL, true, color, u0, v0, diameter / 2.0,
+      diameter / 2.0);
+}
+
+PyObject* interface_ellipse_filled(PyObject* self_in, PyObject* args) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  int color;
+  double u0, v0, semiu, semiv;
+  if (!PyArg_ParseTuple(
+          args, "O!i(dd)(dd)", &InterfaceType, &interface_obj, &color, &u0,
+          &v0, &semiu, &semiv)) {
+    return NULL;
+  }
+
+  return draw_ellipse(
+      &interface_obj->interface, NULL, true, color, u0, v0, semiu, semiv);
+}
+
+PyObject* interface_rounded_rectangle_filled(
+    PyObject* self_in, PyObject* args) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  int color;
+  ext_t u0, v0, u1, v1;
+  double radius;
+  if (!PyArg_ParseTuple(
+          args, "O!i(ii)(ii)d", &InterfaceType, &interface_obj, &color, &u0,
+          &v0, &u1, &v1, &radius)) {
+    return NULL;
+  }
+
+  return draw_rounded_rectangle(
+      &interface_obj->interface, NULL, true, color, u0, v0, u1, v1, radius);
+}
+
+PyObject* interface_polygon_filled(
+    PyObject* self_in, PyObject* args, PyObject* kwds) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  int color;
+  PyObject* vertices_obj;
+  int rule = POLYGON_FILL_NONZERO;
+  char* keywords[] = {
+      "interface",
+      "color",
+      "vertices",
+      "rule",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!iO|i", keywords, &InterfaceType, &interface_obj,
+          &color, &vertices_obj, &rule)) {
+    return NULL;
+  }
+
+  return draw_polygon(
+      &interface_obj->interface, NULL, true, color, vertices_obj, rule);
+}
+
+// screen relative drawing
+//////////////////////////
+
+PyObject* screen_circle_filled(PyObject* self_in, PyObject* args) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  ScreenObject* screen_obj;
+  int color;
+  double u0, v0, diameter;
+  if (!PyArg_ParseTuple(
+          args, "O!O!i(dd)d", &InterfaceType, &interface_obj, &ScreenType,
+          &screen_obj, &color, &u0, &v0, &diameter)) {
+    return NULL;
+  }
+
+  return draw_ellipse(
+      &interface_obj->interface, screen_obj->screen, false, color, u0, v0,
+      diameter / 2.0, diameter / 2.0);
+}
+
+PyObject* screen_ellipse_filled(PyObject* self_in, PyObject* args) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  ScreenObject* screen_obj;
+  int color;
+  double u0, v0, semiu, semiv;
+  if (!PyArg_ParseTuple(
+          args, "O!O!i(dd)(dd)", &InterfaceType, &interface_obj, &ScreenType,
+          &screen_obj, &color, &u0, &v0, &semiu, &semiv)) {
+    return NULL;
+  }
+
+  return draw_ellipse(
+      &interface_obj->interface, screen_obj->screen, false, color, u0, v0,
+      semiu, semiv);
+}
+
+PyObject* screen_rounded_rectangle_filled(PyObject* self_in, PyObject* args) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  ScreenObject* screen_obj;
+  int color;
+  ext_t u0, v0, u1, v1;
+  double radius;
+  if (!PyArg_ParseTuple(
+          args, "O!O!i(ii)(ii)d", &InterfaceType, &interface_obj, &ScreenType,
+          &screen_obj, &color, &u0, &v0, &u1, &v1, &radius)) {
+    return NULL;
+  }
+
+  return draw_rounded_rectangle(
+      &interface_obj->interface, screen_obj->screen, false, color, u0, v0, u1,
+      v1, radius);
+}
+
+PyObject* screen_polygon_filled(
+    PyObject* self_in, PyObject* args, PyObject* kwds) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  ScreenObject* screen_obj;
+  int color;
+  PyObject* vertices_obj;
+  int rule = POLYGON_FILL_NONZERO;
+  char* keywords[] = {
+      "interface",
+      "screen",
+      "color",
+      "vertices",
+      "rule",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!O!iO|i", keywords, &InterfaceType, &interface_obj,
+          &ScreenType, &screen_obj, &color, &vertices_obj, &rule)) {
+    return NULL;
+  }
+
+  return draw_polygon(
+      &interface_obj->interface, screen_obj->screen, false, color,
+      vertices_obj, rule);
+}
+
+// global drawing
+/////////////////
+
+PyObject* global_circle_filled(PyObject* self_in, PyObject* args) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  int color;
+  double u0, v0, diameter;
+  if (!PyArg_ParseTuple(
+          args, "O!i(dd)d", &InterfaceType, &interface_obj, &color, &u0, &v0,
+          &diameter)) {
+    return NULL;
+  }
+
+  return draw_ellipse(
+      &interface_obj->interface, NULL, false, color, u0, v0, diameter / 2.0,
+      diameter / 2.0);
+}
+
+PyObject* global_ellipse_filled(PyObject* self_in, PyObject* args) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  int color;
+  double u0, v0, semiu, semiv;
+  if (!PyArg_ParseTuple(
+          args, "O!i(dd)(dd)", &InterfaceType, &interface_obj, &color, &u0,
+          &v0, &semiu, &semiv)) {
+    return NULL;
+  }
+
+  return draw_ellipse(
+      &interface_obj->interface, NULL, false, color, u0, v0, semiu, semiv);
+}
+
+PyObject* global_rounded_rectangle_filled(PyObject* self_in, PyObject* args) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  int color;
+  ext_t u0, v0, u1, v1;
+  double radius;
+  if (!PyArg_ParseTuple(
+          args, "O!i(ii)(ii)d", &InterfaceType, &interface_obj, &color, &u0,
+          &v0, &u1, &v1, &radius)) {
+    return NULL;
+  }
+
+  return draw_rounded_rectangle(
+      &interface_obj->interface, NULL, false, color, u0, v0, u1, v1, radius);
+}
+
+PyObject* global_polygon_filled(
+    PyObject* self_in, PyObject* args, PyObject* kwds) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  int color;
+  PyObject* vertices_obj;
+  int rule = POLYGON_FILL_NONZERO;
+  char* keywords[] = {
+      "interface",
+      "color",
+      "vertices",
+      "rule",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!iO|i", keywords, &InterfaceType, &interface_obj,
+          &color, &vertices_obj, &rule)) {
+    return NULL;
+  }
+
+  return draw_polygon(
+      &interface_obj->interface, NULL, false, color, vertices_obj, rule);
+}
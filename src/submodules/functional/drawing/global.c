@@ -2,6 +2,7 @@
 #include <Python.h>
 // python includes first (clang-format)
 
+#include "pysicgl/submodules/functional/drawing/target.h"
 #include "pysicgl/types/interface.h"
 #include "sicgl/blit.h"
 #include "sicgl/domain/global.h"
@@ -80,12 +81,17 @@ PyObject* global_rectangle_filled(PyObject* self_in, PyObject* args) {
     return NULL;
   }
 
-  int ret = sicgl_global_rectangle_filled(
-      &interface_obj->interface, color, u0, v0, u1, v1);
-  if (0 != ret) {
-    PyErr_SetNone(PyExc_OSError);
+  draw_target_t target;
+  int ret = draw_target_init(
+      &target, &interface_obj->interface, color, NULL, false);
+  if (ret < 0) {
     return NULL;
   }
+  if (ret > 0) {
+    ext_t du = (ext_t)target.du;
+    ext_t dv = (ext_t)target.dv;
+    draw_target_rectangle(&target, u0 + du, v0 + dv, u1 + du, v1 + dv);
+  }
 
   Py_INCREF(Py_None);
   return Py_None;
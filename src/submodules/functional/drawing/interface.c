@@ -2,10 +2,256 @@
 #include <Python.h>
 // python includes first (clang-format)
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "pysicgl/submodules/functional/drawing/target.h"
+#include "pysicgl/types/compositor.h"
 #include "pysicgl/types/interface.h"
 #include "sicgl/blit.h"
 #include "sicgl/domain/interface.h"
 
+/**
+ * @brief Clip a rectangular copy between two interfaces.
+ *
+ * The source rectangle is clipped to the source interface and the
+ * destination location is adjusted to match, then the result is
+ * clipped to the destination interface.
+ *
+ * @param destination destination interface.
+ * @param du destination column, updated.
+ * @param dv destination row, updated.
+ * @param source source interface.
+ * @param su0 first source column, updated.
+ * @param sv0 first source row, updated.
+ * @param su1 last source column.
+ * @param sv1 last source row.
+ * @param width output width of the copy.
+ * @param height output height of the copy.
+ * @return bool true when any pixels remain to be copied.
+ */
+static bool clip_copy(
+    interface_t* destination, ext_t* du, ext_t* dv, interface_t* source,
+    ext_t* su0, ext_t* sv0, ext_t su1, ext_t sv1, ext_t* width,
+    ext_t* height) {
+  // widened so that positions near the limits of ext_t cannot overflow
+  int64_t u0 = *su0, v0 = *sv0, u1 = su1, v1 = sv1;
+  int64_t u = *du, v = *dv;
+  int64_t swap;
+  if (u0 > u1) {
+    swap = u0, u0 = u1, u1 = swap;
+  }
+  if (v0 > v1) {
+    swap = v0, v0 = v1, v1 = swap;
+  }
+
+  // clip the source rectangle to the source interface
+  if (u0 < 0) {
+    u -= u0;
+    u0 = 0;
+  }
+  if (v0 < 0) {
+    v -= v0;
+    v0 = 0;
+  }
+  if (u1 >= source->screen->width) {
+    u1 = source->screen->width - 1;
+  }
+  if (v1 >= source->screen->height) {
+    v1 = source->screen->height - 1;
+  }
+
+  // clip the destination rectangle to the destination interface
+  if (u < 0) {
+    u0 -= u;
+    u = 0;
+  }
+  if (v < 0) {
+    v0 -= v;
+    v = 0;
+  }
+  int64_t w = u1 - u0 + 1;
+  int64_t h = v1 - v0 + 1;
+  if (u + w > destination->screen->width) {
+    w = destination->screen->width - u;
+  }
+  if (v + h > destination->screen->height) {
+    h = destination->screen->height - v;
+  }
+  if ((w <= 0) || (h <= 0)) {
+    return false;
+  }
+
+  *du = (ext_t)u;
+  *dv = (ext_t)v;
+  *su0 = (ext_t)u0;
+  *sv0 = (ext_t)v0;
+  *width = (ext_t)w;
+  *height = (ext_t)h;
+  return true;
+}
+
+/**
+ * @brief Whether the pixels of two interfaces share any memory.
+ */
+static bool memory_overlaps(interface_t* a, interface_t* b) {
+  return (a->memory < b->memory + b->length) &&
+         (b->memory < a->memory + a->length);
+}
+
+/**
+ * @brief Parse optional source corners, defaulting to the whole source.
+ *
+ * @return int 0 on success, -1 with the Python error indicator set.
+ */
+static int parse_source_corners(
+    PyObject* corners_obj, interface_t* source, ext_t* su0, ext_t* sv0,
+    ext_t* su1, ext_t* sv1) {
+  if (Py_None == corners_obj) {
+    *su0 = 0;
+    *sv0 = 0;
+    *su1 = source->screen->width - 1;
+    *sv1 = source->screen->height - 1;
+    return 0;
+  }
+  if (!PyArg_ParseTuple(corners_obj, "(ii)(ii)", su0, sv0, su1, sv1)) {
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Compose a region of one interface onto another.
+ *
+ * When the source shares memory with the destination, rows are visited
+ * bottom-up if the source lies above the destination and each source row
+ * is copied aside before it is composed, so that overlapping copies only
+ * read unmodified pixels.
+ *
+ * @param self_in
+ * @param args
+ *  - interface_obj: the destination interface.
+ *  - (u, v): destination location in interface coordinates.
+ *  - source_obj: the source interface.
+ *  - compositor_obj: the compositor.
+ *  - corners_obj: optional source corners ((u0, v0), (u1, v1)) in
+ *    source interface coordinates. Defaults to the whole source.
+ * @return PyObject* None.
+ */
+PyObject* interface_compose(PyObject* self_in, PyObject* args) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  InterfaceObject* source_obj;
+  CompositorObject* compositor_obj;
+  PyObject* corners_obj = Py_None;
+  ext_t du, dv;
+  if (!PyArg_ParseTuple(
+          args, "O!(ii)O!O!|O", &InterfaceType, &interface_obj, &du, &dv,
+          &InterfaceType, &source_obj, &CompositorType, &compositor_obj,
+          &corners_obj)) {
+    return NULL;
+  }
+
+  interface_t* destination = &interface_obj->interface;
+  interface_t* source = &source_obj->interface;
+  if ((0 != Interface_check(destination)) || (0 != Interface_check(source)) ||
+      (0 != Compositor_check(compositor_obj))) {
+    return NULL;
+  }
+
+  ext_t su0, sv0, su1, sv1;
+  if (0 != parse_source_corners(corners_obj, source, &su0, &sv0, &su1, &sv1)) {
+    return NULL;
+  }
+
+  ext_t width, height;
+  if (clip_copy(
+          destination, &du, &dv, source, &su0, &sv0, su1, sv1, &width,
+          &height)) {
+    ext_t sw = source->screen->width;
+    ext_t dw = destination->screen->width;
+    bool aliased = memory_overlaps(source, destination);
+    bool reverse = aliased && (dv > sv0);
+    color_t* snapshot = NULL;
+    if (aliased) {
+      snapshot = PyMem_Malloc((size_t)width * sizeof(color_t));
+      if (NULL == snapshot) {
+        return PyErr_NoMemory();
+      }
+    }
+    for (ext_t row = 0; row < height; row++) {
+      ext_t idx = reverse ? (height - 1 - row) : row;
+      color_t* pixels = &source->memory[(sv0 + idx) * sw + su0];
+      if (aliased) {
+        memcpy(snapshot, pixels, (size_t)width * sizeof(color_t));
+        pixels = snapshot;
+      }
+      compositor_obj->fn(
+          pixels, &destination->memory[(dv + idx) * dw + du], width,
+          compositor_obj->args);
+    }
+    PyMem_Free(snapshot);
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+/**
+ * @brief Copy a region of one interface onto another.
+ *
+ * @param self_in
+ * @param args
+ *  - interface_obj: the destination interface.
+ *  - (u, v): destination location in interface coordinates.
+ *  - source_obj: the source interface.
+ *  - corners_obj: optional source corners ((u0, v0), (u1, v1)) in
+ *    source interface coordinates. Defaults to the whole source.
+ * @return PyObject* None.
+ */
+PyObject* interface_blit(PyObject* self_in, PyObject* args) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  InterfaceObject* source_obj;
+  PyObject* corners_obj = Py_None;
+  ext_t du, dv;
+  if (!PyArg_ParseTuple(
+          args, "O!(ii)O!|O", &InterfaceType, &interface_obj, &du, &dv,
+          &InterfaceType, &source_obj, &corners_obj)) {
+    return NULL;
+  }
+
+  interface_t* destination = &interface_obj->interface;
+  interface_t* source = &source_obj->interface;
+  if ((0 != Interface_check(destination)) || (0 != Interface_check(source))) {
+    return NULL;
+  }
+
+  ext_t su0, sv0, su1, sv1;
+  if (0 != parse_source_corners(corners_obj, source, &su0, &sv0, &su1, &sv1)) {
+    return NULL;
+  }
+
+  ext_t width, height;
+  if (clip_copy(
+          destination, &du, &dv, source, &su0, &sv0, su1, sv1, &width,
+          &height)) {
+    ext_t sw = source->screen->width;
+    ext_t dw = destination->screen->width;
+    bool reverse = memory_overlaps(source, destination) && (dv > sv0);
+    for (ext_t row = 0; row < height; row++) {
+      ext_t idx = reverse ? (height - 1 - row) : row;
+      memmove(
+          &destination->memory[(dv + idx) * dw + du],
+          &source->memory[(sv0 + idx) * sw + su0], width * sizeof(color_t));
+    }
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
 PyObject* interface_fill(PyObject* self_in, PyObject* args) {
   (void)self_in;
   InterfaceObject* interface_obj;
@@ -14,11 +260,15 @@ PyObject* interface_fill(PyObject* self_in, PyObject* args) {
     return NULL;
   }
 
-  int ret = sicgl_interface_fill(&interface_obj->interface, color);
-  if (0 != ret) {
-    PyErr_SetNone(PyExc_OSError);
+  draw_target_t target;
+  int ret = draw_target_init(
+      &target, &interface_obj->interface, color, NULL, true);
+  if (ret < 0) {
     return NULL;
   }
+  if (ret > 0) {
+    draw_target_rectangle(&target, target.u0, target.v0, target.u1, target.v1);
+  }
 
   Py_INCREF(Py_None);
   return Py_None;
@@ -99,12 +349,15 @@ PyObject* interface_rectangle_filled(PyObject* self_in, PyObject* args) {
     return NULL;
   }
 
-  int ret = sicgl_interface_rectangle_filled(
-      &interface_obj->interface, color, u0, v0, u1, v1);
-  if (0 != ret) {
-    PyErr_SetNone(PyExc_OSError);
+  draw_target_t target;
+  int ret = draw_target_init(
+      &target, &interface_obj->interface, color, NULL, true);
+  if (ret < 0) {
     return NULL;
   }
+  if (ret > 0) {
+    draw_target_rectangle(&target, u0, v0, u1, v1);
+  }
 
   Py_INCREF(Py_None);
   return Py_None;
@@ -2,6 +2,7 @@
 #include <Python.h>
 // python includes first (clang-format)
 
+#include "pysicgl/submodules/functional/drawing/target.h"
 #include "pysicgl/types/interface.h"
 #include "sicgl/domain/screen.h"
 
@@ -16,12 +17,15 @@ PyObject* screen_fill(PyObject* self_in, PyObject* args) {
     return NULL;
   }
 
-  int ret =
-      sicgl_screen_fill(&interface_obj->interface, screen_obj->screen, color);
-  if (0 != ret) {
-    PyErr_SetNone(PyExc_OSError);
+  draw_target_t target;
+  int ret = draw_target_init(
+      &target, &interface_obj->interface, color, screen_obj->screen, false);
+  if (ret < 0) {
     return NULL;
   }
+  if (ret > 0) {
+    draw_target_rectangle(&target, target.u0, target.v0, target.u1, target.v1);
+  }
 
   Py_INCREF(Py_None);
   return Py_None;
@@ -108,12 +112,17 @@ PyObject* screen_rectangle_filled(PyObject* self_in, PyObject* args) {
     return NULL;
   }
 
-  int ret = sicgl_screen_rectangle_filled(
-      &interface_obj->interface, screen_obj->screen, color, u0, v0, u1, v1);
-  if (0 != ret) {
-    PyErr_SetNone(PyExc_OSError);
+  draw_target_t target;
+  int ret = draw_target_init(
+      &target, &interface_obj->interface, color, screen_obj->screen, false);
+  if (ret < 0) {
     return NULL;
   }
+  if (ret > 0) {
+    ext_t du = (ext_t)target.du;
+    ext_t dv = (ext_t)target.dv;
+    draw_target_rectangle(&target, u0 + du, v0 + dv, u1 + du, v1 + dv);
+  }
 
   Py_INCREF(Py_None);
   return Py_None;
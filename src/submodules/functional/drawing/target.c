@@ -0,0 +1,201 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <stdint.h>
+#include <string.h>
+
+#include "pysicgl/submodules/functional/drawing/target.h"
+#include "pysicgl/types/interface.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief Fill a run of pixels with one color using wide stores.
+ *
+ * Single pixels are written until the memory is aligned to 16 bytes, then
+ * blocks of 16 pixels are written four pixels per store. Without SSE2 two
+ * pixels are written per store instead.
+ *
+ * @param memory first pixel.
+ * @param color
+ * @param count number of pixels.
+ * @param stream whether to bypass the cache with non-temporal stores.
+ */
+void fill_span(color_t* memory, color_t color, size_t count, bool stream) {
+  if (sizeof(color_t) == sizeof(uint32_t)) {
+    while ((count > 0) && (0 != ((uintptr_t)memory & 15))) {
+      *memory++ = color;
+      count--;
+    }
+    size_t blocks = count / 16;
+#if defined(__SSE2__)
+    __m128i wide = _mm_set1_epi32((int)color);
+    __m128i* out = (__m128i*)memory;
+    if (stream) {
+      for (size_t idx = 0; idx < blocks; idx++, out += 4) {
+        _mm_stream_si128(&out[0], wide);
+        _mm_stream_si128(&out[1], wide);
+        _mm_stream_si128(&out[2], wide);
+        _mm_stream_si128(&out[3], wide);
+      }
+      // order the streamed stores before any later store
+      _mm_sfence();
+    } else {
+      for (size_t idx = 0; idx < blocks; idx++, out += 4) {
+        _mm_store_si128(&out[0], wide);
+        _mm_store_si128(&out[1], wide);
+        _mm_store_si128(&out[2], wide);
+        _mm_store_si128(&out[3], wide);
+      }
+    }
+#else
+    (void)stream;
+    uint64_t pair = ((uint64_t)(uint32_t)color << 32) | (uint32_t)color;
+    unsigned char* out = (unsigned char*)memory;
+    for (size_t idx = 0; idx < blocks * 8; idx++, out += sizeof(pair)) {
+      memcpy(out, &pair, sizeof(pair));
+    }
+#endif
+    memory += blocks * 16;
+    count -= blocks * 16;
+  }
+  while (count > 0) {
+    *memory++ = color;
+    count--;
+  }
+}
+
+/**
+ * @brief Prepare to draw into a region of an interface.
+ *
+ * @param target output target.
+ * @param interface
+ * @param color
+ * @param screen screen in which drawing coordinates are given, or NULL
+ *  for global coordinates.
+ * @param local when set drawing coordinates are interface coordinates and
+ *  the screen is ignored.
+ * @return int 0 when nothing is drawable, 1 when the target is ready, -1
+ *  with the Python error indicator set.
+ */
+int draw_target_init(
+    draw_target_t* target, interface_t* interface, color_t color,
+    screen_t* screen, bool local) {
+  if (0 != Interface_check(interface)) {
+    return -1;
+  }
+  screen_t* own = interface->screen;
+
+  target->interface = interface;
+  target->color = color;
+  target->u0 = 0;
+  target->v0 = 0;
+  target->u1 = own->width - 1;
+  target->v1 = own->height - 1;
+  if (local) {
+    target->du = 0.0;
+    target->dv = 0.0;
+  } else if (NULL == screen) {
+    target->du = -own->_gu0;
+    target->dv = -own->_gv0;
+  } else {
+    // screen coordinates are offset by the location of the screen and
+    // clipped to its corners
+    target->du = screen->lu - own->_gu0;
+    target->dv = screen->lv - own->_gv0;
+    if (screen->_gu0 - own->_gu0 > target->u0) {
+      target->u0 = screen->_gu0 - own->_gu0;
+    }
+    if (screen->_gv0 - own->_gv0 > target->v0) {
+      target->v0 = screen->_gv0 - own->_gv0;
+    }
+    if (screen->_gu1 - own->_gu0 < target->u1) {
+      target->u1 = screen->_gu1 - own->_gu0;
+    }
+    if (screen->_gv1 - own->_gv0 < target->v1) {
+      target->v1 = screen->_gv1 - own->_gv0;
+    }
+  }
+
+  return ((target->u0 <= target->u1) && (target->v0 <= target->v1)) ? 1 : 0;
+}
+
+/**
+ * @brief Fill a horizontal run of pixels with the color of the target.
+ *
+ * @param target
+ * @param v row in interface coordinates.
+ * @param u0 first pixel in interface coordinates.
+ * @param u1 last pixel in interface coordinates, inclusive.
+ */
+void draw_target_span(draw_target_t* target, ext_t v, ext_t u0, ext_t u1) {
+  if ((v < target->v0) || (v > target->v1)) {
+    return;
+  }
+  if (u0 < target->u0) {
+    u0 = target->u0;
+  }
+  if (u1 > target->u1) {
+    u1 = target->u1;
+  }
+  if (u0 > u1) {
+    return;
+  }
+  fill_span(
+      &target->interface->memory[v * target->interface->screen->width + u0],
+      target->color, (size_t)(u1 - u0 + 1), false);
+}
+
+/**
+ * @brief Fill a rectangle with the color of the target.
+ *
+ * Rectangles spanning whole rows of the interface are filled as one run,
+ * large rectangles bypass the cache.
+ *
+ * @param target
+ * @param u0 corner in interface coordinates, inclusive.
+ * @param v0
+ * @param u1 opposite corner in interface coordinates, inclusive.
+ * @param v1
+ */
+void draw_target_rectangle(
+    draw_target_t* target, ext_t u0, ext_t v0, ext_t u1, ext_t v1) {
+  ext_t swap;
+  if (u0 > u1) {
+    swap = u0, u0 = u1, u1 = swap;
+  }
+  if (v0 > v1) {
+    swap = v0, v0 = v1, v1 = swap;
+  }
+  if (u0 < target->u0) {
+    u0 = target->u0;
+  }
+  if (v0 < target->v0) {
+    v0 = target->v0;
+  }
+  if (u1 > target->u1) {
+    u1 = target->u1;
+  }
+  if (v1 > target->v1) {
+    v1 = target->v1;
+  }
+  if ((u0 > u1) || (v0 > v1)) {
+    return;
+  }
+
+  ext_t stride = target->interface->screen->width;
+  size_t width = (size_t)(u1 - u0 + 1);
+  size_t rows = (size_t)(v1 - v0 + 1);
+  bool stream = width * rows * sizeof(color_t) >= FILL_STREAM_THRESHOLD;
+  color_t* start = &target->interface->memory[v0 * stride + u0];
+  if ((ext_t)width == stride) {
+    fill_span(start, target->color, width * rows, stream);
+    return;
+  }
+  for (size_t row = 0; row < rows; row++) {
+    fill_span(&start[row * stride], target->color, width, stream);
+  }
+}
@@ -0,0 +1,228 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "pysicgl/submodules/functional/drawing/target.h"
+#include "pysicgl/submodules/functional/drawing/text.h"
+#include "pysicgl/types/compositor.h"
+#include "pysicgl/types/font.h"
+#include "pysicgl/types/interface.h"
+#include "pysicgl/types/screen.h"
+#include "pysicgl/utilities/color.h"
+
+/**
+ * @brief Draw a rasterized run into the target.
+ *
+ * Without a compositor the color is blended over the destination by the
+ * coverage of each pixel, opaque colors are stored directly where the
+ * coverage is full. With a compositor each stretch of covered pixels is
+ * handed to it as a row of the color with its alpha scaled by coverage.
+ * The run is clipped in 64 bits so that far away positions cannot overflow.
+ *
+ * @param target
+ * @param run
+ * @param u left of the pen in interface coordinates.
+ * @param v top of the first line in interface coordinates.
+ * @param compositor compositor, or NULL to blend.
+ * @param row scratch for the compositor, at least as wide as the run.
+ */
+static void draw_run(
+    draw_target_t* target, const font_run_t* run, int64_t u, int64_t v,
+    CompositorObject* compositor, color_t* row) {
+  int64_t left = u + run->left;
+  int64_t first = (target->u0 > left) ? target->u0 - left : 0;
+  int64_t top = (target->v0 > v) ? target->v0 - v : 0;
+  int64_t last = (target->u1 - left < run->width - 1) ? target->u1 - left
+                                                      : run->width - 1;
+  int64_t bottom = (target->v1 - v < run->height - 1) ? target->v1 - v
+                                                      : run->height - 1;
+  if ((first > last) || (top > bottom)) {
+    return;
+  }
+  // within the run and the target, so these fit in ext_t
+  ext_t x0 = (ext_t)first;
+  ext_t x1 = (ext_t)last;
+  ext_t y0 = (ext_t)top;
+  ext_t y1 = (ext_t)bottom;
+  ext_t u0 = (ext_t)(left + first);
+
+  color_t color = target->color;
+  bool opaque = (255 == color_channel_alpha(color));
+  ext_t stride = target->interface->screen->width;
+  for (ext_t y = y0; y <= y1; y++) {
+    const uint8_t* coverage = &run->coverage[(size_t)y * (size_t)run->width];
+    // indexed by the column of the run less x0
+    color_t* out =
+        &target->interface->memory[(size_t)(v + y) * stride + (size_t)u0];
+    if (NULL == compositor) {
+      for (ext_t x = x0; x <= x1; x++) {
+        if (0 == coverage[x]) {
+          continue;
+        }
+        if (opaque && (255 == coverage[x])) {
+          out[x - x0] = color;
+        } else {
+          out[x - x0] = color_blend_coverage(out[x - x0], color, coverage[x]);
+        }
+      }
+      continue;
+    }
+
+    ext_t x = x0;
+    while (x <= x1) {
+      if (0 == coverage[x]) {
+        x++;
+        continue;
+      }
+      ext_t start = x;
+      for (; (x <= x1) && (0 != coverage[x]); x++) {
+        color_t alpha = div255(color_channel_alpha(color) * coverage[x]);
+        row[x - start] = color_from_channels(
+            color_channel_red(color), color_channel_green(color),
+            color_channel_blue(color), alpha);
+      }
+      compositor->fn(
+          row, &out[start - x0], (size_t)(x - start), compositor->args);
+    }
+  }
+}
+
+/**
+ * @brief Draw a string with a font.
+ *
+ * @return PyObject* None, or NULL with the Python error indicator set.
+ */
+static PyObject* draw_text(
+    interface_t* interface, screen_t* screen, bool local, FontObject* font,
+    color_t color, ext_t u, ext_t v, PyObject* text,
+    PyObject* compositor_obj) {
+  CompositorObject* compositor = NULL;
+  if (Py_None != compositor_obj) {
+    if (!PyObject_TypeCheck(compositor_obj, &CompositorType)) {
+      PyErr_SetString(PyExc_TypeError, "compositor must be a Compositor");
+      return NULL;
+    }
+    compositor = (CompositorObject*)compositor_obj;
+    if (0 != Compositor_check(compositor)) {
+      return NULL;
+    }
+  }
+
+  const font_run_t* run = Font_get_run(font, text);
+  if (NULL == run) {
+    return NULL;
+  }
+  draw_target_t target;
+  int ret = draw_target_init(&target, interface, color, screen, local);
+  if (ret < 0) {
+    return NULL;
+  }
+  color_t* row = NULL;
+  if ((ret > 0) && (NULL != compositor)) {
+    row = PyMem_Malloc((size_t)run->width * sizeof(color_t));
+    if (NULL == row) {
+      return PyErr_NoMemory();
+    }
+  }
+  if (ret > 0) {
+    draw_run(
+        &target, run, (int64_t)u + (int64_t)target.du,
+        (int64_t)v + (int64_t)target.dv, compositor, row);
+  }
+  PyMem_Free(row);
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+PyObject* interface_text(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  FontObject* font_obj;
+  int color;
+  ext_t u, v;
+  PyObject* text;
+  PyObject* compositor_obj = Py_None;
+  char* keywords[] = {
+      "interface",
+      "font",
+      "color",
+      "position",
+      "text",
+      "compositor",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!O!i(ii)U|O", keywords, &InterfaceType,
+          &interface_obj, &FontType, &font_obj, &color, &u, &v, &text,
+          &compositor_obj)) {
+    return NULL;
+  }
+
+  return draw_text(
+      &interface_obj->interface, NULL, true, font_obj, color, u, v, text,
+      compositor_obj);
+}
+
+PyObject* screen_text(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  ScreenObject* screen_obj;
+  FontObject* font_obj;
+  int color;
+  ext_t u, v;
+  PyObject* text;
+  PyObject* compositor_obj = Py_None;
+  char* keywords[] = {
+      "interface",
+      "screen",
+      "font",
+      "color",
+      "position",
+      "text",
+      "compositor",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!O!O!i(ii)U|O", keywords, &InterfaceType,
+          &interface_obj, &ScreenType, &screen_obj, &FontType, &font_obj,
+          &color, &u, &v, &text, &compositor_obj)) {
+    return NULL;
+  }
+
+  return draw_text(
+      &interface_obj->interface, screen_obj->screen, false, font_obj, color,
+      u, v, text, compositor_obj);
+}
+
+PyObject* global_text(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  FontObject* font_obj;
+  int color;
+  ext_t u, v;
+  PyObject* text;
+  PyObject* compositor_obj = Py_None;
+  char* keywords[] = {
+      "interface",
+      "font",
+      "color",
+      "position",
+      "text",
+      "compositor",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!O!i(ii)U|O", keywords, &InterfaceType,
+          &interface_obj, &FontType, &font_obj, &color, &u, &v, &text,
+          &compositor_obj)) {
+    return NULL;
+  }
+
+  return draw_text(
+      &interface_obj->interface, NULL, false, font_obj, color, u, v, text,
+      compositor_obj);
+}
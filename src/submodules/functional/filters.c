@@ -0,0 +1,814 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "pysicgl/submodules/functional/filters.h"
+#include "pysicgl/types/interface.h"
+#include "pysicgl/types/screen.h"
+#include "pysicgl/utilities/color.h"
+
+// number of channels in a color
+#define CHANNELS (4)
+
+// box averages divide by a reciprocal in 16.48 fixed point, which stays
+// within half a step of the true average for boxes of up to 2^32 pixels
+#define RECIPROCAL_SHIFT (48)
+
+// a region of an interface in interface coordinates
+typedef struct _filter_region_t {
+  color_t* memory;
+  ext_t stride;
+  ext_t width;
+  ext_t height;
+} filter_region_t;
+
+/**
+ * @brief Find the region of an interface to filter.
+ *
+ * @param interface
+ * @param screen_obj optional ScreenObject limiting the region, in global
+ *  coordinates, or Py_None for the whole interface.
+ * @param region output region.
+ * @return int 0 when the region is empty, 1 when it is not, -1 with the
+ *  Python error indicator set.
+ */
+static int filter_region(
+    interface_t* interface, PyObject* screen_obj, filter_region_t* region) {
+  if (0 != Interface_check(interface)) {
+    return -1;
+  }
+  screen_t* screen = interface->screen;
+
+  ext_t u0 = 0;
+  ext_t v0 = 0;
+  ext_t u1 = screen->width - 1;
+  ext_t v1 = screen->height - 1;
+  if (Py_None != screen_obj) {
+    if (!PyObject_TypeCheck(screen_obj, &ScreenType)) {
+      PyErr_SetString(PyExc_TypeError, "screen must be a Screen");
+      return -1;
+    }
+    screen_t* limit = ((ScreenObject*)screen_obj)->screen;
+    if (limit->_gu0 - screen->_gu0 > u0) {
+      u0 = limit->_gu0 - screen->_gu0;
+    }
+    if (limit->_gv0 - screen->_gv0 > v0) {
+      v0 = limit->_gv0 - screen->_gv0;
+    }
+    if (limit->_gu1 - screen->_gu0 < u1) {
+      u1 = limit->_gu1 - screen->_gu0;
+    }
+    if (limit->_gv1 - screen->_gv0 < v1) {
+      v1 = limit->_gv1 - screen->_gv0;
+    }
+  }
+  if ((u0 > u1) || (v0 > v1)) {
+    return 0;
+  }
+
+  region->memory = &interface->memory[v0 * screen->width + u0];
+  region->stride = screen->width;
+  region->width = u1 - u0 + 1;
+  region->height = v1 - v0 + 1;
+  return 1;
+}
+
+static inline ext_t clamp_index(int64_t index, ext_t limit) {
+  if (index < 0) {
+    return 0;
+  } else if (index >= limit) {
+    return limit - 1;
+  }
+  return (ext_t)index;
+}
+
+static inline void accumulate(uint64_t* sums, color_t color, uint64_t count) {
+  sums[0] += count * color_channel_red(color);
+  sums[1] += count * color_channel_green(color);
+  sums[2] += count * color_channel_blue(color);
+  sums[3] += count * color_channel_alpha(color);
+}
+
+static inline void exchange(uint64_t* sums, color_t in, color_t out) {
+  sums[0] += (uint64_t)color_channel_red(in) - color_channel_red(out);
+  sums[1] += (uint64_t)color_channel_green(in) - color_channel_green(out);
+  sums[2] += (uint64_t)color_channel_blue(in) - color_channel_blue(out);
+  sums[3] += (uint64_t)color_channel_alpha(in) - color_channel_alpha(out);
+}
+
+static inline uint64_t box_reciprocal(ext_t radius) {
+  return ((uint64_t)1 << RECIPROCAL_SHIFT) / (2 * (uint64_t)radius + 1);
+}
+
+static inline color_t average(const uint64_t* sums, uint64_t reciprocal) {
+  const uint64_t half = (uint64_t)1 << (RECIPROCAL_SHIFT - 1);
+  return color_from_channels(
+      (color_t)((sums[0] * reciprocal + half) >> RECIPROCAL_SHIFT),
+      (color_t)((sums[1] * reciprocal + half) >> RECIPROCAL_SHIFT),
+      (color_t)((sums[2] * reciprocal + half) >> RECIPROCAL_SHIFT),
+      (color_t)((sums[3] * reciprocal + half) >> RECIPROCAL_SHIFT));
+}
+
+/**
+ * @brief Box blur each row of a region into a buffer.
+ *
+ * A running sum is carried along the row so the cost per pixel does not
+ * depend on the radius. Pixels beyond the edges repeat the edge pixel.
+ *
+ * @param region
+ * @param radius
+ * @param output buffer of width * height pixels.
+ */
+static void box_blur_rows(
+    filter_region_t* region, ext_t radius, color_t* output) {
+  ext_t width = region->width;
+  uint64_t reciprocal = box_reciprocal(radius);
+  // the box around the first pixel covers radius copies of the first pixel
+  // followed by the row up to the radius, repeating the last pixel beyond
+  ext_t last = (radius < width - 1) ? radius : width - 1;
+  for (ext_t v = 0; v < region->height; v++) {
+    color_t* row = &region->memory[v * region->stride];
+    color_t* out = &output[v * width];
+    uint64_t sums[CHANNELS] = {0};
+    accumulate(sums, row[0], radius);
+    for (ext_t k = 0; k <= last; k++) {
+      accumulate(sums, row[k], 1);
+    }
+    accumulate(sums, row[width - 1], radius - last);
+    for (ext_t u = 0; u < width; u++) {
+      out[u] = average(sums, reciprocal);
+      exchange(
+          sums, row[clamp_index((int64_t)u + radius + 1, width)],
+          row[clamp_index((int64_t)u - radius, width)]);
+    }
+  }
+}
+
+/**
+ * @brief Box blur the columns of a buffer back into a region.
+ *
+ * The running sums of every column are carried down the rows together so
+ * that memory is visited row by row.
+ *
+ * @param input buffer of width * height pixels.
+ * @param radius
+ * @param region
+ * @param sums scratch of width * CHANNELS sums.
+ */
+static void box_blur_columns(
+    color_t* input, ext_t radius, filter_region_t* region, uint64_t* sums) {
+  ext_t width = region->width;
+  ext_t height = region->height;
+  uint64_t reciprocal = box_reciprocal(radius);
+  ext_t last = (radius < height - 1) ? radius : height - 1;
+  color_t* bottom = &input[(height - 1) * width];
+  memset(sums, 0, (size_t)width * CHANNELS * sizeof(uint64_t));
+  for (ext_t u = 0; u < width; u++) {
+    accumulate(&sums[u * CHANNELS], input[u], radius);
+    accumulate(&sums[u * CHANNELS], bottom[u], radius - last);
+  }
+  for (ext_t k = 0; k <= last; k++) {
+    color_t* row = &input[k * width];
+    for (ext_t u = 0; u < width; u++) {
+      accumulate(&sums[u * CHANNELS], row[u], 1);
+    }
+  }
+  for (ext_t v = 0; v < height; v++) {
+    color_t* out = &region->memory[v * region->stride];
+    color_t* in =
+        &input[clamp_index((int64_t)v + radius + 1, height) * width];
+    color_t* removed =
+        &input[clamp_index((int64_t)v - radius, height) * width];
+    for (ext_t u = 0; u < width; u++) {
+      out[u] = average(&sums[u * CHANNELS], reciprocal);
+      exchange(&sums[u * CHANNELS], in[u], removed[u]);
+    }
+  }
+}
+
+/**
+ * @brief Box blur a region of pixel memory in place.
+ *
+ * @param memory first pixel of the region.
+ * @param stride distance between rows of the region.
+ * @param width
+ * @param height
+ * @param radius
+ * @param scratch buffer of width * height pixels.
+ * @param sums buffer of width * 4 sums.
+ */
+void box_blur_region(
+    color_t* memory, ext_t stride, ext_t width, ext_t height, ext_t radius,
+    color_t* scratch, uint64_t* sums) {
+  if (radius <= 0) {
+    return;
+  }
+  filter_region_t region = {
+      .memory = memory,
+      .stride = stride,
+      .width = width,
+      .height = height,
+  };
+  box_blur_rows(&region, radius, scratch);
+  box_blur_columns(scratch, radius, &region, sums);
+}
+
+/**
+ * @brief Apply a sequence of separable box blurs to a region.
+ *
+ * The Python interpreter lock is released while filtering so that other
+ * threads may run, scratch memory is allocated beforehand. The region must
+ * lie within a held interface.
+ *
+ * @param region
+ * @param radii radius of each pass.
+ * @param passes number of passes.
+ * @return int 0 on success, -1 with the Python error indicator set.
+ */
+static int box_blur_passes(
+    filter_region_t* region, const ext_t* radii, size_t passes) {
+  size_t pixels = (size_t)region->width * (size_t)region->height;
+  color_t* scratch = PyMem_Malloc(pixels * sizeof(color_t));
+  uint64_t* sums =
+      PyMem_Malloc((size_t)region->width * CHANNELS * sizeof(uint64_t));
+  if ((NULL == scratch) || (NULL == sums)) {
+    PyMem_Free(scratch);
+    PyMem_Free(sums);
+    PyErr_NoMemory();
+    return -1;
+  }
+
+  Py_BEGIN_ALLOW_THREADS;
+  for (size_t pass = 0; pass < passes; pass++) {
+    box_blur_region(
+        region->memory, region->stride, region->width, region->height,
+        radii[pass], scratch, sums);
+  }
+  Py_END_ALLOW_THREADS;
+
+  PyMem_Free(scratch);
+  PyMem_Free(sums);
+  return 0;
+}
+
+/**
+ * @brief Box blur an interface.
+ *
+ * @param self_in
+ * @param args
+ *  - interface_obj: the interface.
+ *  - radius: number of pixels on each side of a pixel which are averaged.
+ *  - screen_obj: optional Screen in global coordinates limiting the blur.
+ *  - passes: number of times to apply the blur.
+ * @param kwds
+ * @return PyObject* None.
+ */
+PyObject* box_blur(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  int radius;
+  PyObject* screen_obj = Py_None;
+  int passes = 1;
+  char* keywords[] = {
+      "interface",
+      "radius",
+      "screen",
+      "passes",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!i|Oi", keywords, &InterfaceType, &interface_obj,
+          &radius, &screen_obj, &passes)) {
+    return NULL;
+  }
+  if ((radius < 0) || (passes < 0)) {
+    PyErr_SetString(
+        PyExc_ValueError, "radius and passes must not be negative");
+    return NULL;
+  }
+
+  interface_hold_t hold;
+  if (0 != Interface_hold(interface_obj, &hold)) {
+    return NULL;
+  }
+  filter_region_t region;
+  int ret = filter_region(&hold.interface, screen_obj, &region);
+
+  if ((ret > 0) && (radius > 0) && (passes > 0)) {
+    ext_t* radii = PyMem_Malloc(passes * sizeof(ext_t));
+    if (NULL == radii) {
+      PyErr_NoMemory();
+      ret = -1;
+    } else {
+      for (int pass = 0; pass < passes; pass++) {
+        radii[pass] = radius;
+      }
+      ret = box_blur_passes(&region, radii, passes);
+      PyMem_Free(radii);
+    }
+  }
+
+  Interface_release(&hold);
+  if (ret < 0) {
+    return NULL;
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+/**
+ * @brief Approximate a Gaussian blur of an interface with box blurs.
+ *
+ * The radii of the box passes are chosen so that their combined variance
+ * matches that of the Gaussian.
+ *
+ * @param self_in
+ * @param args
+ *  - interface_obj: the interface.
+ *  - sigma: standard deviation of the Gaussian in pixels.
+ *  - screen_obj: optional Screen in global coordinates limiting the blur.
+ *  - passes: number of box passes, more passes approach the Gaussian.
+ * @param kwds
+ * @return PyObject* None.
+ */
+PyObject* gaussian_blur(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  double sigma;
+  PyObject* screen_obj = Py_None;
+  int passes = 3;
+  char* keywords[] = {
+      "interface",
+      "sigma",
+      "screen",
+      "passes",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!d|Oi", keywords, &InterfaceType, &interface_obj,
+          &sigma, &screen_obj, &passes)) {
+    return NULL;
+  }
+  if (!(sigma >= 0.0) || !isfinite(sigma) || (passes < 1)) {
+    PyErr_SetString(
+        PyExc_ValueError,
+        "sigma must be finite and not negative and passes positive");
+    return NULL;
+  }
+
+  // the widths of the boxes must fit in ext_t
+  double variance = 12.0 * sigma * sigma;
+  double width = sqrt(variance / passes + 1.0);
+  if (!(width < (double)(INT32_MAX / 2))) {
+    PyErr_SetString(PyExc_ValueError, "sigma is too large");
+    return NULL;
+  }
+
+  interface_hold_t hold;
+  if (0 != Interface_hold(interface_obj, &hold)) {
+    return NULL;
+  }
+  filter_region_t region;
+  int ret = filter_region(&hold.interface, screen_obj, &region);
+  if ((ret <= 0) || (0.0 == sigma)) {
+    goto out;
+  }
+
+  // split the variance between boxes of two adjacent odd widths
+  ext_t lower = (ext_t)floor(width);
+  if (0 == lower % 2) {
+    lower--;
+  }
+  ext_t upper = lower + 2;
+  double ideal = (variance - (double)passes * lower * lower -
+                  4.0 * passes * lower - 3.0 * passes) /
+                 (-4.0 * lower - 4.0);
+  ext_t smaller = (ext_t)lround(ideal);
+
+  ext_t* radii = PyMem_Malloc(passes * sizeof(ext_t));
+  if (NULL == radii) {
+    PyErr_NoMemory();
+    ret = -1;
+    goto out;
+  }
+  for (int pass = 0; pass < passes; pass++) {
+    radii[pass] = ((pass < smaller) ? lower : upper) / 2;
+  }
+  ret = box_blur_passes(&region, radii, passes);
+  PyMem_Free(radii);
+
+out:
+  Interface_release(&hold);
+  if (ret < 0) {
+    return NULL;
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+// convolution weights are kept in 20.12 fixed point
+#define CONVOLVE_SHIFT (12)
+
+// the largest kernel accepted by convolve
+#define CONVOLVE_MAX_SIZE (15)
+
+/**
+ * @brief Copy a row of a region into a ring slot, padding both sides.
+ *
+ * @param row source row, or NULL for a row of zeros.
+ * @param width
+ * @param half number of pixels of padding on each side.
+ * @param edge
+ * @param padded output of width + 2 * half pixels.
+ */
+static void convolve_load_row(
+    const color_t* row, ext_t width, ext_t half, convolve_edge_t edge,
+    color_t* padded) {
+  ext_t padded_width = width + 2 * half;
+  if (NULL == row) {
+    memset(padded, 0, (size_t)padded_width * sizeof(color_t));
+    return;
+  }
+  memcpy(&padded[half], row, (size_t)width * sizeof(color_t));
+  for (ext_t k = 1; k <= half; k++) {
+    color_t* left = &padded[half - k];
+    color_t* right = &padded[half + width - 1 + k];
+    switch (edge) {
+      case CONVOLVE_EDGE_WRAP:
+        *left = row[(width - k % width) % width];
+        *right = row[(k - 1) % width];
+        break;
+
+      case CONVOLVE_EDGE_ZERO:
+        *left = 0;
+        *right = 0;
+        break;
+
+      case CONVOLVE_EDGE_CLAMP:
+      default:
+        *left = row[0];
+        *right = row[width - 1];
+        break;
+    }
+  }
+}
+
+/**
+ * @brief Convolve one output row from the padded rows around it.
+ *
+ * Kept inline so that the wrappers for common kernel sizes are compiled
+ * with a constant size and their inner loops fully unrolled.
+ *
+ * @param rows size padded rows centered on the output row.
+ * @param weights size * size fixed point weights.
+ * @param size
+ * @param width
+ * @param bias fixed point value added to each color channel.
+ * @param alpha whether alpha is convolved or kept from the source pixel.
+ * @param out output row of width pixels.
+ */
+static inline void convolve_row(
+    const color_t* const* rows, const int32_t* weights, ext_t size,
+    ext_t width, int32_t bias, bool alpha, color_t* out) {
+  const int32_t round = bias + (1 << (CONVOLVE_SHIFT - 1));
+  const ext_t half = size / 2;
+  for (ext_t u = 0; u < width; u++) {
+    int32_t sums[CHANNELS] = {round, round, round, 1 << (CONVOLVE_SHIFT - 1)};
+    for (ext_t ky = 0; ky < size; ky++) {
+      const color_t* row = &rows[ky][u];
+      const int32_t* weight = &weights[ky * size];
+      for (ext_t kx = 0; kx < size; kx++) {
+        color_t color = row[kx];
+        sums[0] += weight[kx] * color_channel_red(color);
+        sums[1] += weight[kx] * color_channel_green(color);
+        sums[2] += weight[kx] * color_channel_blue(color);
+        sums[3] += weight[kx] * color_channel_alpha(color);
+      }
+    }
+    out[u] = color_from_channels(
+        clamp_u8(sums[0] >> CONVOLVE_SHIFT),
+        clamp_u8(sums[1] >> CONVOLVE_SHIFT),
+        clamp_u8(sums[2] >> CONVOLVE_SHIFT),
+        alpha ? clamp_u8(sums[3] >> CONVOLVE_SHIFT)
+              : color_channel_alpha(rows[half][u + half]));
+  }
+}
+
+/**
+ * @brief Fill a ring slot with the source row at an index which may lie
+ * beyond the region.
+ *
+ * @param region
+ * @param v row index relative to the region.
+ * @param half
+ * @param edge
+ * @param saved padded copies of the first rows of the region.
+ * @param slot output padded row.
+ */
+static void convolve_fetch_row(
+    filter_region_t* region, ext_t v, ext_t half, convolve_edge_t edge,
+    const color_t* saved, color_t* slot) {
+  ext_t width = region->width;
+  ext_t height = region->height;
+  ext_t index = v;
+  if ((v < 0) || (v >= height)) {
+    switch (edge) {
+      case CONVOLVE_EDGE_ZERO:
+        convolve_load_row(NULL, width, half, edge, slot);
+        return;
+
+      case CONVOLVE_EDGE_WRAP:
+        index = ((v % height) + height) % height;
+        if (v >= height) {
+          // the first rows have already been overwritten
+          size_t padded_width = (size_t)width + 2 * (size_t)half;
+          memcpy(
+              slot, &saved[index * padded_width],
+              padded_width * sizeof(color_t));
+          return;
+        }
+        break;
+
+      case CONVOLVE_EDGE_CLAMP:
+      default:
+        index = clamp_index(v, height);
+        break;
+    }
+  }
+  convolve_load_row(
+      &region->memory[index * region->stride], width, half, edge, slot);
+}
+
+typedef void (*convolve_row_fn)(
+    const color_t* const* rows, const int32_t* weights, ext_t size,
+    ext_t width, int32_t bias, bool alpha, color_t* out);
+
+static void convolve_row_3(
+    const color_t* const* rows, const int32_t* weights, ext_t size,
+    ext_t width, int32_t bias, bool alpha, color_t* out) {
+  (void)size;
+  convolve_row(rows, weights, 3, width, bias, alpha, out);
+}
+
+static void convolve_row_5(
+    const color_t* const* rows, const int32_t* weights, ext_t size,
+    ext_t width, int32_t bias, bool alpha, color_t* out) {
+  (void)size;
+  convolve_row(rows, weights, 5, width, bias, alpha, out);
+}
+
+static void convolve_row_any(
+    const color_t* const* rows, const int32_t* weights, ext_t size,
+    ext_t width, int32_t bias, bool alpha, color_t* out) {
+  convolve_row(rows, weights, size, width, bias, alpha, out);
+}
+
+/**
+ * @brief Convolve a region in place through a ring of padded rows.
+ *
+ * Only the size rows around the output row are held, so each source row
+ * is read once and each output row is written straight back into the
+ * region. Wrapping past the bottom edge reads the first rows, which are
+ * saved before they are overwritten.
+ *
+ * @param region
+ * @param weights size * size fixed point weights.
+ * @param size odd kernel size.
+ * @param bias
+ * @param alpha
+ * @param edge
+ * @param ring buffer of size rows of width + size - 1 pixels.
+ * @param saved buffer of min(size / 2, height) rows of the same width.
+ */
+static void convolve_region(
+    filter_region_t* region, const int32_t* weights, ext_t size, int32_t bias,
+    bool alpha, convolve_edge_t edge, color_t* ring, color_t* saved) {
+  ext_t width = region->width;
+  ext_t height = region->height;
+  ext_t half = size / 2;
+  ext_t padded_width = width + 2 * half;
+  ext_t num_saved = (half < height) ? half : height;
+  convolve_row_fn row_fn = (3 == size)   ? convolve_row_3
+                           : (5 == size) ? convolve_row_5
+                                         : convolve_row_any;
+
+  if (CONVOLVE_EDGE_WRAP == edge) {
+    for (ext_t v = 0; v < num_saved; v++) {
+      convolve_load_row(
+          &region->memory[v * region->stride], width, half, edge,
+          &saved[v * padded_width]);
+    }
+  }
+
+  const color_t* rows[CONVOLVE_MAX_SIZE];
+  for (ext_t v = -half; v < half; v++) {
+    convolve_fetch_row(
+        region, v, half, edge, saved,
+        &ring[((v + size) % size) * padded_width]);
+  }
+  for (ext_t v = 0; v < height; v++) {
+    ext_t next = v + half;
+    convolve_fetch_row(
+        region, next, half, edge, saved, &ring[(next % size) * padded_width]);
+    for (ext_t k = 0; k < size; k++) {
+      rows[k] = &ring[((v - half + k + size) % size) * padded_width];
+    }
+    row_fn(
+        rows, weights, size, width, bias, alpha,
+        &region->memory[v * region->stride]);
+  }
+}
+
+/**
+ * @brief Parse a square kernel of numbers into fixed point weights.
+ *
+ * @param kernel_obj sequence of rows of numbers.
+ * @param divisor_obj number dividing the weights, or Py_None to divide by
+ *  their sum when it is not zero.
+ * @param weights output of up to CONVOLVE_MAX_SIZE squared weights.
+ * @param size output kernel size.
+ * @return int 0 on success, -1 with the Python error indicator set.
+ */
+static int parse_kernel(
+    PyObject* kernel_obj, PyObject* divisor_obj, int32_t* weights,
+    ext_t* size) {
+  int ret = 0;
+  double values[CONVOLVE_MAX_SIZE * CONVOLVE_MAX_SIZE];
+
+  // private copies keep the numbers alive and in place while converting
+  // them runs arbitrary code, which may mutate the caller's sequences
+  PyObject* rows = PySequence_Tuple(kernel_obj);
+  if (NULL == rows) {
+    ret = -1;
+    goto out;
+  }
+  Py_ssize_t count = PyTuple_GET_SIZE(rows);
+  if ((count < 1) || (count > CONVOLVE_MAX_SIZE) || (0 == count % 2)) {
+    PyErr_Format(
+        PyExc_ValueError, "kernel size must be odd and at most %d",
+        CONVOLVE_MAX_SIZE);
+    ret = -1;
+    goto out;
+  }
+
+  double sum = 0.0;
+  for (Py_ssize_t y = 0; y < count; y++) {
+    PyObject* row = PySequence_Tuple(PyTuple_GET_ITEM(rows, y));
+    if (NULL == row) {
+      ret = -1;
+      goto out;
+    }
+    if (PyTuple_GET_SIZE(row) != count) {
+      Py_DECREF(row);
+      PyErr_SetString(PyExc_ValueError, "kernel must be square");
+      ret = -1;
+      goto out;
+    }
+    for (Py_ssize_t x = 0; x < count; x++) {
+      double value = PyFloat_AsDouble(PyTuple_GET_ITEM(row, x));
+      if (PyErr_Occurred()) {
+        Py_DECREF(row);
+        ret = -1;
+        goto out;
+      }
+      values[y * count + x] = value;
+      sum += value;
+    }
+    Py_DECREF(row);
+  }
+
+  double divisor = (0.0 != sum) ? sum : 1.0;
+  if (Py_None != divisor_obj) {
+    divisor = PyFloat_AsDouble(divisor_obj);
+    if (PyErr_Occurred()) {
+      ret = -1;
+      goto out;
+    }
+  }
+  if (0.0 == divisor) {
+    PyErr_SetString(PyExc_ValueError, "divisor must not be zero");
+    ret = -1;
+    goto out;
+  }
+
+  // every channel sum must fit in 32 bits
+  double total = 0.0;
+  for (Py_ssize_t idx = 0; idx < count * count; idx++) {
+    double weight = values[idx] / divisor * (1 << CONVOLVE_SHIFT);
+    total += fabs(weight);
+    weights[idx] = (int32_t)lround(weight);
+  }
+  if (!(total * 255.0 < (double)(INT32_MAX / 2))) {
+    PyErr_SetString(PyExc_ValueError, "kernel weights are too large");
+    ret = -1;
+    goto out;
+  }
+  *size = (ext_t)count;
+
+out:
+  Py_XDECREF(rows);
+  return ret;
+}
+
+/**
+ * @brief Convolve an interface with a square kernel.
+ *
+ * @param self_in
+ * @param args
+ *  - interface_obj: the interface.
+ *  - kernel_obj: square sequence of rows of integer or float weights with
+ *    an odd size of at most 15.
+ *  - screen_obj: optional Screen in global coordinates limiting the
+ *    convolution. Pixels beyond it are sampled according to the edge mode.
+ *  - edge: EDGE_CLAMP, EDGE_WRAP or EDGE_ZERO.
+ *  - divisor_obj: number dividing the weights, the sum of the kernel by
+ *    default or 1 when that is zero.
+ *  - bias: value added to each color channel after convolution.
+ *  - alpha: whether alpha is convolved too, by default it is kept.
+ * @param kwds
+ * @return PyObject* None.
+ */
+PyObject* convolve(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  PyObject* kernel_obj;
+  PyObject* screen_obj = Py_None;
+  int edge = CONVOLVE_EDGE_CLAMP;
+  PyObject* divisor_obj = Py_None;
+  double bias = 0.0;
+  int alpha = false;
+  char* keywords[] = {
+      "interface",
+      "kernel",
+      "screen",
+      "edge",
+      "divisor",
+      "bias",
+      "alpha",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!O|OiOdp", keywords, &InterfaceType, &interface_obj,
+          &kernel_obj, &screen_obj, &edge, &divisor_obj, &bias, &alpha)) {
+    return NULL;
+  }
+  if ((edge < CONVOLVE_EDGE_CLAMP) || (edge > CONVOLVE_EDGE_ZERO)) {
+    PyErr_SetString(PyExc_ValueError, "unknown edge mode");
+    return NULL;
+  }
+  if (!(fabs(bias) <= 255.0)) {
+    PyErr_SetString(PyExc_ValueError, "bias must be in the range [-255, 255]");
+    return NULL;
+  }
+
+  int32_t weights[CONVOLVE_MAX_SIZE * CONVOLVE_MAX_SIZE];
+  ext_t size;
+  if (0 != parse_kernel(kernel_obj, divisor_obj, weights, &size)) {
+    return NULL;
+  }
+
+  interface_hold_t hold;
+  if (0 != Interface_hold(interface_obj, &hold)) {
+    return NULL;
+  }
+  filter_region_t region;
+  int ret = filter_region(&hold.interface, screen_obj, &region);
+  if (ret <= 0) {
+    goto out;
+  }
+
+  ext_t half = size / 2;
+  ext_t num_saved = (half < region.height) ? half : region.height;
+  size_t padded_width = (size_t)region.width + 2 * (size_t)half;
+  color_t* ring = PyMem_Malloc(
+      ((size_t)size + (size_t)num_saved) * padded_width * sizeof(color_t));
+  if (NULL == ring) {
+    PyErr_NoMemory();
+    ret = -1;
+    goto out;
+  }
+
+  Py_BEGIN_ALLOW_THREADS;
+  convolve_region(
+      &region, weights, size, (int32_t)lround(bias * (1 << CONVOLVE_SHIFT)),
+      alpha, (convolve_edge_t)edge, ring, &ring[size * padded_width]);
+  Py_END_ALLOW_THREADS;
+
+  PyMem_Free(ring);
+
+out:
+  Interface_release(&hold);
+  if (ret < 0) {
+    return NULL;
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
@@ -0,0 +1,443 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+
+#include "pysicgl/submodules/functional/generators.h"
+#include "pysicgl/types/scalar_expression.h"
+#include "pysicgl/types/scalar_field.h"
+
+#ifndef M_PI
+#define M_PI (3.14159265358979323846)
+#endif
+
+// Ken Perlin's reference permutation
+static const uint8_t permutation[256] = {
+    151, 160, 137, 91,  90,  15,  131, 13,  201, 95,  96,  53,  194, 233, 7,
+    225, 140, 36,  103, 30,  69,  142, 8,   99,  37,  240, 21,  10,  23,  190,
+    6,   148, 247, 120, 234, 75,  0,   26,  197, 62,  94,  252, 219, 203, 117,
+    35,  11,  32,  57,  177, 33,  88,  237, 149, 56,  87,  174, 20,  125, 136,
+    171, 168, 68,  175, 74,  165, 71,  134, 139, 48,  27,  166, 77,  146, 158,
+    231, 83,  111, 229, 122, 60,  211, 133, 230, 220, 105, 92,  41,  55,  46,
+    245, 40,  244, 102, 143, 54,  65,  25,  63,  161, 1,   216, 80,  73,  209,
+    76,  132, 187, 208, 89,  18,  169, 200, 196, 135, 130, 116, 188, 159, 86,
+    164, 100, 109, 198, 173, 186, 3,   64,  52,  217, 226, 250, 124, 123, 5,
+    202, 38,  147, 118, 126, 255, 82,  85,  212, 207, 206, 59,  227, 47,  16,
+    58,  17,  182, 189, 28,  42,  223, 183, 170, 213, 119, 248, 152, 2,   44,
+    154, 163, 70,  221, 153, 101, 155, 167, 43,  172, 9,   129, 22,  39,  253,
+    19,  98,  108, 110, 79,  113, 224, 232, 178, 185, 112, 104, 218, 246, 97,
+    228, 251, 34,  242, 193, 238, 210, 144, 12,  191, 179, 162, 241, 81,  51,
+    145, 235, 249, 14,  239, 107, 49,  192, 214, 31,  181, 199, 106, 157, 184,
+    84,  204, 176, 115, 121, 50,  45,  127, 4,   150, 254, 138, 236, 205, 93,
+    222, 114, 67,  29,  24,  72,  243, 141, 128, 195, 78,  66,  215, 61,  156,
+    180,
+};
+
+// gradient directions for 3D simplex noise
+static const int8_t gradients[12][3] = {
+    {1, 1, 0}, {-1, 1, 0}, {1, -1, 0}, {-1, -1, 0}, {1, 0, 1},  {-1, 0, 1},
+    {1, 0, -1}, {-1, 0, -1}, {0, 1, 1}, {0, -1, 1}, {0, 1, -1}, {0, -1, -1},
+};
+
+static inline int fast_floor(double x) {
+  int xi = (int)x;
+  return (x < xi) ? xi - 1 : xi;
+}
+
+static inline uint8_t hash(int i, int j, int k) {
+  return permutation
+      [(i + permutation[(j + permutation[k & 255]) & 255]) & 255];
+}
+
+static inline double corner(
+    int i, int j, int k, double x, double y, double z) {
+  double t = 0.6 - x * x - y * y - z * z;
+  if (t < 0.0) {
+    return 0.0;
+  }
+  const int8_t* g = gradients[hash(i, j, k) % 12];
+  t *= t;
+  return t * t * (g[0] * x + g[1] * y + g[2] * z);
+}
+
+/**
+ * @brief 3D simplex noise.
+ *
+ * @return double noise value in the range [-1, 1].
+ */
+static double simplex3(double x, double y, double z) {
+  static const double F3 = 1.0 / 3.0;
+  static const double G3 = 1.0 / 6.0;
+
+  // skew the input space to find the containing simplex cell
+  double s = (x + y + z) * F3;
+  int i = fast_floor(x + s);
+  int j = fast_floor(y + s);
+  int k = fast_floor(z + s);
+  double t = (i + j + k) * G3;
+  double x0 = x - (i - t);
+  double y0 = y - (j - t);
+  double z0 = z - (k - t);
+
+  // determine which simplex of the cell contains the point
+  int i1, j1, k1, i2, j2, k2;
+  if (x0 >= y0) {
+    if (y0 >= z0) {
+      i1 = 1, j1 = 0, k1 = 0, i2 = 1, j2 = 1, k2 = 0;
+    } else if (x0 >= z0) {
+      i1 = 1, j1 = 0, k1 = 0, i2 = 1, j2 = 0, k2 = 1;
+    } else {
+      i1 = 0, j1 = 0, k1 = 1, i2 = 1, j2 = 0, k2 = 1;
+    }
+  } else {
+    if (y0 < z0) {
+      i1 = 0, j1 = 0, k1 = 1, i2 = 0, j2 = 1, k2 = 1;
+    } else if (x0 < z0) {
+      i1 = 0, j1 = 1, k1 = 0, i2 = 0, j2 = 1, k2 = 1;
+    } else {
+      i1 = 0, j1 = 1, k1 = 0, i2 = 1, j2 = 1, k2 = 0;
+    }
+  }
+
+  double n = corner(i, j, k, x0, y0, z0);
+  n += corner(
+      i + i1, j + j1, k + k1, x0 - i1 + G3, y0 - j1 + G3, z0 - k1 + G3);
+  n += corner(
+      i + i2, j + j2, k + k2, x0 - i2 + 2.0 * G3, y0 - j2 + 2.0 * G3,
+      z0 - k2 + 2.0 * G3);
+  n += corner(
+      i + 1, j + 1, k + 1, x0 - 1.0 + 3.0 * G3, y0 - 1.0 + 3.0 * G3,
+      z0 - 1.0 + 3.0 * G3);
+
+  return 32.0 * n;
+}
+
+/**
+ * @brief Check that a scalar field can hold a field of the given extent.
+ *
+ * @return int 0 on success, -1 with the Python error indicator set when
+ *  the field is too small.
+ */
+static int check_extent(
+    ScalarFieldObject* scalar_field_obj, ext_t width, ext_t height) {
+  if ((width <= 0) || (height <= 0) ||
+      ((size_t)width * (size_t)height > scalar_field_obj->length)) {
+    PyErr_SetString(PyExc_ValueError, "scalars buffer is too small");
+    return -1;
+  }
+  return 0;
+}
+
+PyObject* field_linear_gradient(
+    PyObject* self_in, PyObject* args, PyObject* kwds) {
+  (void)self_in;
+  ScalarFieldObject* scalar_field_obj;
+  ext_t width, height;
+  double cu = 0.0;
+  double cv = 0.0;
+  double angle = 0.0;
+  double scale = 1.0;
+  double offset = 0.0;
+  char* keywords[] = {
+      "scalar_field", "extent", "center", "angle", "scale", "offset", NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!(ii)|(dd)ddd", keywords, &ScalarFieldType,
+          &scalar_field_obj, &width, &height, &cu, &cv, &angle, &scale,
+          &offset)) {
+    return NULL;
+  }
+  if (0 != check_extent(scalar_field_obj, width, height)) {
+    return NULL;
+  }
+
+  // the gradient advances by a constant step along rows and columns
+  double du = cos(angle) * scale;
+  double dv = sin(angle) * scale;
+  scalar_field_writer_t writer;
+  if (0 != ScalarField_writer_init(&writer, scalar_field_obj, width)) {
+    return PyErr_NoMemory();
+  }
+  for (ext_t v = 0; v < height; v++) {
+    double* row = ScalarField_writer_row(&writer, v * width);
+    double start = offset + (0.0 - cu) * du + (v - cv) * dv;
+    for (ext_t u = 0; u < width; u++) {
+      row[u] = start + u * du;
+    }
+    ScalarField_writer_store(&writer, v * width, width);
+  }
+  ScalarField_writer_deinit(&writer);
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+PyObject* field_radial_gradient(
+    PyObject* self_in, PyObject* args, PyObject* kwds) {
+  (void)self_in;
+  ScalarFieldObject* scalar_field_obj;
+  ext_t width, height;
+  double cu = 0.0;
+  double cv = 0.0;
+  double scale = 1.0;
+  double offset = 0.0;
+  char* keywords[] = {
+      "scalar_field", "extent", "center", "scale", "offset", NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!(ii)|(dd)dd", keywords, &ScalarFieldType,
+          &scalar_field_obj, &width, &height, &cu, &cv, &scale, &offset)) {
+    return NULL;
+  }
+  if (0 != check_extent(scalar_field_obj, width, height)) {
+    return NULL;
+  }
+
+  scalar_field_writer_t writer;
+  if (0 != ScalarField_writer_init(&writer, scalar_field_obj, width)) {
+    return PyErr_NoMemory();
+  }
+  for (ext_t v = 0; v < height; v++) {
+    double* row = ScalarField_writer_row(&writer, v * width);
+    double dv2 = (v - cv) * (v - cv);
+    for (ext_t u = 0; u < width; u++) {
+      double du = u - cu;
+      row[u] = offset + sqrt(du * du + dv2) * scale;
+    }
+    ScalarField_writer_store(&writer, v * width, width);
+  }
+  ScalarField_writer_deinit(&writer);
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+PyObject* field_conic_gradient(
+    PyObject* self_in, PyObject* args, PyObject* kwds) {
+  (void)self_in;
+  ScalarFieldObject* scalar_field_obj;
+  ext_t width, height;
+  double cu = 0.0;
+  double cv = 0.0;
+  double angle = 0.0;
+  double scale = 1.0;
+  double offset = 0.0;
+  char* keywords[] = {
+      "scalar_field", "extent", "center", "angle", "scale", "offset", NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!(ii)|(dd)ddd", keywords, &ScalarFieldType,
+          &scalar_field_obj, &width, &height, &cu, &cv, &angle, &scale,
+          &offset)) {
+    return NULL;
+  }
+  if (0 != check_extent(scalar_field_obj, width, height)) {
+    return NULL;
+  }
+
+  // one full turn spans a unit range of scalars (times scale)
+  double turns = scale / (2.0 * M_PI);
+  scalar_field_writer_t writer;
+  if (0 != ScalarField_writer_init(&writer, scalar_field_obj, width)) {
+    return PyErr_NoMemory();
+  }
+  for (ext_t v = 0; v < height; v++) {
+    double* row = ScalarField_writer_row(&writer, v * width);
+    double dv = v - cv;
+    for (ext_t u = 0; u < width; u++) {
+      double theta = atan2(dv, u - cu) - angle;
+      if (theta < 0.0) {
+        theta += 2.0 * M_PI;
+      }
+      row[u] = offset + theta * turns;
+    }
+    ScalarField_writer_store(&writer, v * width, width);
+  }
+  ScalarField_writer_deinit(&writer);
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+PyObject* field_plasma(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  (void)self_in;
+  ScalarFieldObject* scalar_field_obj;
+  ext_t width, height;
+  double cu = 0.0;
+  double cv = 0.0;
+  double t = 0.0;
+  double scale = 1.0;
+  double offset = 0.0;
+  char* keywords[] = {
+      "scalar_field", "extent", "center", "t", "scale", "offset", NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!(ii)|(dd)ddd", keywords, &ScalarFieldType,
+          &scalar_field_obj, &width, &height, &cu, &cv, &t, &scale,
+          &offset)) {
+    return NULL;
+  }
+  if (0 != check_extent(scalar_field_obj, width, height)) {
+    return NULL;
+  }
+
+  // the horizontal term only depends on the column
+  double* columns = PyMem_Malloc(width * sizeof(double));
+  if (NULL == columns) {
+    return PyErr_NoMemory();
+  }
+  for (ext_t u = 0; u < width; u++) {
+    columns[u] = sin((u - cu) * scale + t);
+  }
+
+  // the sum of four waves in [-4, 4] is normalized to [0, 1]
+  scalar_field_writer_t writer;
+  if (0 != ScalarField_writer_init(&writer, scalar_field_obj, width)) {
+    PyMem_Free(columns);
+    return PyErr_NoMemory();
+  }
+  for (ext_t v = 0; v < height; v++) {
+    double* row = ScalarField_writer_row(&writer, v * width);
+    double y = (v - cv) * scale;
+    double vertical = sin(y + 0.5 * t);
+    for (ext_t u = 0; u < width; u++) {
+      double x = (u - cu) * scale;
+      double sum = columns[u] + vertical + sin(0.5 * (x + y) + 0.7 * t) +
+                   sin(sqrt(x * x + y * y) + t);
+      row[u] = offset + 0.125 * sum + 0.5;
+    }
+    ScalarField_writer_store(&writer, v * width, width);
+  }
+  ScalarField_writer_deinit(&writer);
+
+  PyMem_Free(columns);
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+PyObject* field_noise(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  (void)self_in;
+  ScalarFieldObject* scalar_field_obj;
+  ext_t width, height;
+  double cu = 0.0;
+  double cv = 0.0;
+  double t = 0.0;
+  double scale = 1.0;
+  double offset = 0.0;
+  int octaves = 1;
+  char* keywords[] = {
+      "scalar_field",
+      "extent",
+      "center",
+      "t",
+      "scale",
+      "offset",
+      "octaves",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!(ii)|(dd)dddi", keywords, &ScalarFieldType,
+          &scalar_field_obj, &width, &height, &cu, &cv, &t, &scale, &offset,
+          &octaves)) {
+    return NULL;
+  }
+  if (0 != check_extent(scalar_field_obj, width, height)) {
+    return NULL;
+  }
+  if (octaves < 1) {
+    PyErr_SetString(PyExc_ValueError, "octaves must be at least 1");
+    return NULL;
+  }
+
+  // each octave doubles the frequency and halves the amplitude
+  double normalization = 0.0;
+  double amplitude = 1.0;
+  for (int octave = 0; octave < octaves; octave++) {
+    normalization += amplitude;
+    amplitude *= 0.5;
+  }
+  normalization = 0.5 / normalization;
+
+  scalar_field_writer_t writer;
+  if (0 != ScalarField_writer_init(&writer, scalar_field_obj, width)) {
+    return PyErr_NoMemory();
+  }
+  for (ext_t v = 0; v < height; v++) {
+    double* row = ScalarField_writer_row(&writer, v * width);
+    double y = (v - cv) * scale;
+    for (ext_t u = 0; u < width; u++) {
+      double x = (u - cu) * scale;
+      double sum = 0.0;
+      double frequency = 1.0;
+      amplitude = 1.0;
+      for (int octave = 0; octave < octaves; octave++) {
+        sum +=
+            amplitude * simplex3(x * frequency, y * frequency, t * frequency);
+        frequency *= 2.0;
+        amplitude *= 0.5;
+      }
+      row[u] = offset + sum * normalization + 0.5;
+    }
+    ScalarField_writer_store(&writer, v * width, width);
+  }
+  ScalarField_writer_deinit(&writer);
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+PyObject* field_expression(
+    PyObject* self_in, PyObject* args, PyObject* kwds) {
+  (void)self_in;
+  ScalarFieldObject* scalar_field_obj;
+  ext_t width, height;
+  ScalarExpressionObject* expression_obj;
+  double t = 0.0;
+  char* keywords[] = {
+      "scalar_field", "extent", "expression", "t", NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!(ii)O!|d", keywords, &ScalarFieldType,
+          &scalar_field_obj, &width, &height, &ScalarExpressionType,
+          &expression_obj, &t)) {
+    return NULL;
+  }
+  if (0 != check_extent(scalar_field_obj, width, height)) {
+    return NULL;
+  }
+
+  scalar_expression_evaluator_t evaluator;
+  int ret = ScalarExpression_evaluator_init(&evaluator, expression_obj, t);
+  if (-ENOMEM == ret) {
+    return PyErr_NoMemory();
+  } else if (0 != ret) {
+    PyErr_SetNone(PyExc_OSError);
+    return NULL;
+  }
+
+  scalar_field_writer_t writer;
+  if (0 != ScalarField_writer_init(&writer, scalar_field_obj, width)) {
+    ScalarExpression_evaluator_deinit(&evaluator);
+    return PyErr_NoMemory();
+  }
+  for (ext_t v = 0; (0 == ret) && (v < height); v++) {
+    ret = ScalarExpression_evaluator_row(
+        &evaluator, 0, v, width, ScalarField_writer_row(&writer, v * width));
+    if (0 == ret) {
+      ScalarField_writer_store(&writer, v * width, width);
+    }
+  }
+  ScalarField_writer_deinit(&writer);
+  ScalarExpression_evaluator_deinit(&evaluator);
+  if (0 != ret) {
+    PyErr_SetNone(PyExc_OSError);
+    return NULL;
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
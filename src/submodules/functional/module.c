@@ -4,10 +4,18 @@
 
 #include "pysicgl/submodules/functional/color.h"
 #include "pysicgl/submodules/functional/color_correction.h"
+#include "pysicgl/submodules/functional/drawing/antialiased.h"
+#include "pysicgl/submodules/functional/drawing/filled.h"
 #include "pysicgl/submodules/functional/drawing/global.h"
 #include "pysicgl/submodules/functional/drawing/interface.h"
 #include "pysicgl/submodules/functional/drawing/screen.h"
+#include "pysicgl/submodules/functional/drawing/text.h"
+#include "pysicgl/submodules/functional/filters.h"
+#include "pysicgl/submodules/functional/generators.h"
 #include "pysicgl/submodules/functional/operations.h"
+#include "pysicgl/submodules/functional/resampling.h"
+#include "pysicgl/submodules/functional/sampling.h"
+#include "pysicgl/types/hdr_interface.h"
 #include "pysicgl/types/interface.h"
 #include "sicgl/gamma.h"
 
@@ -96,11 +104,61 @@ static PyMethodDef funcs[] = {
      "compose a sprite onto the interface memory using a composition method"},
     {"scalar_field", (PyCFunction)scalar_field, METH_VARARGS | METH_KEYWORDS,
      "map a scalar field onto the interface through a color sequence"},
+    {"scalar_field_compose", (PyCFunction)scalar_field_compose,
+     METH_VARARGS | METH_KEYWORDS,
+     "map a scalar field through a color sequence and compose it onto the "
+     "interface in a single pass"},
+    {"scalar_expression", (PyCFunction)scalar_expression,
+     METH_VARARGS | METH_KEYWORDS,
+     "evaluate a ScalarExpression over the screen and map it onto the "
+     "interface through a color sequence"},
     {"scale", (PyCFunction)scale, METH_VARARGS,
      "scale the interface memory by a scalar factor"},
+    {"premultiply_alpha", (PyCFunction)premultiply_alpha, METH_VARARGS,
+     "convert the interface memory from straight to premultiplied alpha"},
+    {"unpremultiply_alpha", (PyCFunction)unpremultiply_alpha, METH_VARARGS,
+     "convert the interface memory from premultiplied to straight alpha"},
 
-    // interface relative drawing
+    // filters
+    {"box_blur", (PyCFunction)box_blur, METH_VARARGS | METH_KEYWORDS,
+     "blur the interface with a separable running sum box filter"},
+    {"gaussian_blur", (PyCFunction)gaussian_blur, METH_VARARGS | METH_KEYWORDS,
+     "blur the interface with an approximate gaussian of repeated boxes"},
+    {"convolve", (PyCFunction)convolve, METH_VARARGS | METH_KEYWORDS,
+     "convolve the interface with a square kernel"},
 
+    // scalar field generators
+    {"field_linear_gradient", (PyCFunction)field_linear_gradient,
+     METH_VARARGS | METH_KEYWORDS,
+     "fill a scalar field with a linear gradient"},
+    {"field_radial_gradient", (PyCFunction)field_radial_gradient,
+     METH_VARARGS | METH_KEYWORDS,
+     "fill a scalar field with the distance from a center point"},
+    {"field_conic_gradient", (PyCFunction)field_conic_gradient,
+     METH_VARARGS | METH_KEYWORDS,
+     "fill a scalar field with the angle around a center point"},
+    {"field_plasma", (PyCFunction)field_plasma, METH_VARARGS | METH_KEYWORDS,
+     "fill a scalar field with a sine plasma in the range [0, 1]"},
+    {"field_noise", (PyCFunction)field_noise, METH_VARARGS | METH_KEYWORDS,
+     "fill a scalar field with simplex noise in the range [0, 1]"},
+    {"field_expression", (PyCFunction)field_expression,
+     METH_VARARGS | METH_KEYWORDS,
+     "fill a scalar field by evaluating a ScalarExpression"},
+
+    // interface relative drawing
+    {"interface_compose", (PyCFunction)interface_compose, METH_VARARGS,
+     "compose a region of another interface onto the interface"},
+    {"interface_blit", (PyCFunction)interface_blit, METH_VARARGS,
+     "copy a region of another interface onto the interface"},
+    {"interface_scaled_compose", (PyCFunction)interface_scaled_compose,
+     METH_VARARGS | METH_KEYWORDS,
+     "compose a region of another interface scaled onto a rectangle"},
+    {"interface_scaled_blit", (PyCFunction)interface_scaled_blit,
+     METH_VARARGS | METH_KEYWORDS,
+     "copy a region of another interface scaled onto a rectangle"},
+    {"interface_affine_blit", (PyCFunction)interface_affine_blit,
+     METH_VARARGS | METH_KEYWORDS,
+     "draw a region of another interface through an affine transform"},
     {"interface_fill", (PyCFunction)interface_fill, METH_VARARGS,
      "fill color into interface"},
     {"interface_pixel", (PyCFunction)interface_pixel, METH_VARARGS,
@@ -115,6 +173,23 @@ static PyMethodDef funcs[] = {
      "draw circle to interface"},
     {"interface_ellipse", (PyCFunction)interface_ellipse, METH_VARARGS,
      "draw ellipse to interface"},
+    {"interface_line_aa", (PyCFunction)interface_line_aa, METH_VARARGS,
+     "draw anti-aliased line to interface"},
+    {"interface_circle_aa", (PyCFunction)interface_circle_aa, METH_VARARGS,
+     "draw anti-aliased circle to interface"},
+    {"interface_ellipse_aa", (PyCFunction)interface_ellipse_aa, METH_VARARGS,
+     "draw anti-aliased ellipse to interface"},
+    {"interface_circle_filled", (PyCFunction)interface_circle_filled,
+     METH_VARARGS, "draw filled circle to interface"},
+    {"interface_ellipse_filled", (PyCFunction)interface_ellipse_filled,
+     METH_VARARGS, "draw filled ellipse to interface"},
+    {"interface_rounded_rectangle_filled",
+     (PyCFunction)interface_rounded_rectangle_filled, METH_VARARGS,
+     "draw filled rounded rectangle to interface"},
+    {"interface_polygon_filled", (PyCFunction)interface_polygon_filled,
+     METH_VARARGS | METH_KEYWORDS, "draw filled polygon to interface"},
+    {"interface_text", (PyCFunction)interface_text,
+     METH_VARARGS | METH_KEYWORDS, "draw text to interface"},
 
     // screen relative drawing
     {"screen_fill", (PyCFunction)screen_fill, METH_VARARGS,
@@ -131,6 +206,23 @@ static PyMethodDef funcs[] = {
      "draw circle to screen"},
     {"screen_ellipse", (PyCFunction)screen_ellipse, METH_VARARGS,
      "draw ellipse to screen"},
+    {"screen_line_aa", (PyCFunction)screen_line_aa, METH_VARARGS,
+     "draw anti-aliased line to screen"},
+    {"screen_circle_aa", (PyCFunction)screen_circle_aa, METH_VARARGS,
+     "draw anti-aliased circle to screen"},
+    {"screen_ellipse_aa", (PyCFunction)screen_ellipse_aa, METH_VARARGS,
+     "draw anti-aliased ellipse to screen"},
+    {"screen_circle_filled", (PyCFunction)screen_circle_filled, METH_VARARGS,
+     "draw filled circle to screen"},
+    {"screen_ellipse_filled", (PyCFunction)screen_ellipse_filled,
+     METH_VARARGS, "draw filled ellipse to screen"},
+    {"screen_rounded_rectangle_filled",
+     (PyCFunction)screen_rounded_rectangle_filled, METH_VARARGS,
+     "draw filled rounded rectangle to screen"},
+    {"screen_polygon_filled", (PyCFunction)screen_polygon_filled,
+     METH_VARARGS | METH_KEYWORDS, "draw filled polygon to screen"},
+    {"screen_text", (PyCFunction)screen_text, METH_VARARGS | METH_KEYWORDS,
+     "draw text to screen"},
 
     // global drawing
     {"global_pixel", (PyCFunction)global_pixel, METH_VARARGS,
@@ -147,6 +239,32 @@ static PyMethodDef funcs[] = {
      "Draw a circle in global coordinates. Output clipped to interface."},
     {"global_ellipse", (PyCFunction)global_ellipse, METH_VARARGS,
      "Draw an ellipse in global coordinates. Output clipped to interface."},
+    {"global_line_aa", (PyCFunction)global_line_aa, METH_VARARGS,
+     "Draw an anti-aliased line in global coordinates. Output clipped to "
+     "interface."},
+    {"global_circle_aa", (PyCFunction)global_circle_aa, METH_VARARGS,
+     "Draw an anti-aliased circle in global coordinates. Output clipped to "
+     "interface."},
+    {"global_ellipse_aa", (PyCFunction)global_ellipse_aa, METH_VARARGS,
+     "Draw an anti-aliased ellipse in global coordinates. Output clipped to "
+     "interface."},
+    {"global_circle_filled", (PyCFunction)global_circle_filled, METH_VARARGS,
+     "Draw a filled circle in global coordinates. Output clipped to "
+     "interface."},
+    {"global_ellipse_filled", (PyCFunction)global_ellipse_filled,
+     METH_VARARGS,
+     "Draw a filled ellipse in global coordinates. Output clipped to "
+     "interface."},
+    {"global_rounded_rectangle_filled",
+     (PyCFunction)global_rounded_rectangle_filled, METH_VARARGS,
+     "Draw a filled rounded rectangle in global coordinates. Output clipped "
+     "to interface."},
+    {"global_polygon_filled", (PyCFunction)global_polygon_filled,
+     METH_VARARGS | METH_KEYWORDS,
+     "Draw a filled polygon in global coordinates. Output clipped to "
+     "interface."},
+    {"global_text", (PyCFunction)global_text, METH_VARARGS | METH_KEYWORDS,
+     "Draw text in global coordinates. Output clipped to interface."},
 
     {NULL},
 };
@@ -165,6 +283,47 @@ static PyModuleDef module = {
 
 PyMODINIT_FUNC PyInit_functional(void) {
   PyObject* m = PyModule_Create(&module);
+  if (NULL == m) {
+    return NULL;
+  }
+
+  // sampling filters
+  if ((PyModule_AddIntConstant(m, "FILTER_NEAREST", SAMPLE_FILTER_NEAREST) <
+       0) ||
+      (PyModule_AddIntConstant(m, "FILTER_BILINEAR", SAMPLE_FILTER_BILINEAR) <
+       0)) {
+    Py_DECREF(m);
+    return NULL;
+  }
+
+  // convolution edge modes
+  if ((PyModule_AddIntConstant(m, "EDGE_CLAMP", CONVOLVE_EDGE_CLAMP) < 0) ||
+      (PyModule_AddIntConstant(m, "EDGE_WRAP", CONVOLVE_EDGE_WRAP) < 0) ||
+      (PyModule_AddIntConstant(m, "EDGE_ZERO", CONVOLVE_EDGE_ZERO) < 0)) {
+    Py_DECREF(m);
+    return NULL;
+  }
+
+  // polygon fill rules
+  if ((PyModule_AddIntConstant(m, "FILL_EVEN_ODD", POLYGON_FILL_EVEN_ODD) <
+       0) ||
+      (PyModule_AddIntConstant(m, "FILL_NONZERO", POLYGON_FILL_NONZERO) < 0)) {
+    Py_DECREF(m);
+    return NULL;
+  }
+
+  // high dynamic range compose modes and tone map operators
+  if ((PyModule_AddIntConstant(m, "HDR_ADD", HDR_MODE_ADD) < 0) ||
+      (PyModule_AddIntConstant(m, "HDR_OVER", HDR_MODE_OVER) < 0) ||
+      (PyModule_AddIntConstant(m, "HDR_MULTIPLY", HDR_MODE_MULTIPLY) < 0) ||
+      (PyModule_AddIntConstant(m, "HDR_MAX", HDR_MODE_MAX) < 0) ||
+      (PyModule_AddIntConstant(m, "TONE_MAP_CLAMP", HDR_TONE_MAP_CLAMP) <
+       0) ||
+      (PyModule_AddIntConstant(
+           m, "TONE_MAP_REINHARD", HDR_TONE_MAP_REINHARD) < 0)) {
+    Py_DECREF(m);
+    return NULL;
+  }
 
   return m;
 }
@@ -2,32 +2,164 @@
 #include <Python.h>
 // python includes first (clang-format)
 
+#include <errno.h>
+
 #include "pysicgl/types/color_sequence.h"
 #include "pysicgl/types/color_sequence_interpolator.h"
 #include "pysicgl/types/compositor.h"
 #include "pysicgl/types/interface.h"
+#include "pysicgl/types/scalar_expression.h"
 #include "pysicgl/types/scalar_field.h"
+#include "pysicgl/utilities/color.h"
 #include "sicgl/blit.h"
 #include "sicgl/compose.h"
 #include "sicgl/gamma.h"
 
-static inline color_t clamp_u8(color_t channel) {
-  if (channel > 255) {
-    return 255;
-  } else if (channel < 0) {
-    return 0;
-  } else {
-    return channel;
+// produces the scalars of one row of a region
+typedef int (*scalar_row_fn)(void* source, ext_t v, double** row);
+
+static int sampler_row(void* source, ext_t v, double** row) {
+  return ScalarField_sampler_row((scalar_field_sampler_t*)source, v, row);
+}
+
+// evaluates an expression along the rows of a region of a screen
+typedef struct _expression_rows_t {
+  scalar_expression_evaluator_t evaluator;
+  screen_t* screen;
+  ext_t u0;
+  size_t count;
+  double* row;
+} expression_rows_t;
+
+static int expression_row(void* source, ext_t v, double** row) {
+  expression_rows_t* rows = (expression_rows_t*)source;
+  *row = rows->row;
+  return ScalarExpression_evaluator_row(
+      &rows->evaluator, rows->u0, v - rows->screen->_gv0, rows->count,
+      rows->row);
+}
+
+/**
+ * @brief Map rows of scalars through a color sequence onto the
+ *  interface, one row at a time.
+ *
+ * @param interface the target interface.
+ * @param row_fn function producing the scalars of each row.
+ * @param source state passed to row_fn.
+ * @param region region to draw in global coordinates.
+ * @param sequence color sequence.
+ * @param map_fn color sequence interpolation function.
+ * @param offset offset added to every scalar.
+ * @param opacity scale applied to the mapped colors.
+ * @param compositor compositor used to combine each mapped row with
+ *  the interface, or NULL to write the mapped colors directly.
+ * @return int
+ */
+static int draw_scalar_field(
+    interface_t* interface, scalar_row_fn row_fn, void* source,
+    screen_t* region, color_sequence_t* sequence, sequence_map_fn map_fn,
+    double offset, double opacity, CompositorObject* compositor) {
+  int ret = 0;
+  color_t* row = NULL;
+  ext_t width = region->_gu1 - region->_gu0 + 1;
+
+  // a single row of mapped colors is the only scratch memory required
+  if (NULL != compositor) {
+    row = PyMem_Malloc(width * sizeof(color_t));
+    if (NULL == row) {
+      ret = -ENOMEM;
+      goto out;
+    }
   }
+
+  screen_t* target_screen = interface->screen;
+  for (ext_t v = region->_gv0; v <= region->_gv1; v++) {
+    double* scalars;
+    ret = row_fn(source, v, &scalars);
+    if (0 != ret) {
+      goto out;
+    }
+
+    color_t* destination =
+        &interface->memory
+             [(v - target_screen->_gv0) * target_screen->width +
+              (region->_gu0 - target_screen->_gu0)];
+    color_t* colors = (NULL == row) ? destination : row;
+
+    // map the scalars of this row through the color sequence
+    for (ext_t idx = 0; idx < width; idx++) {
+      ret = map_fn(sequence, scalars[idx] + offset, &colors[idx]);
+      if (0 != ret) {
+        goto out;
+      }
+    }
+    if (1.0 != opacity) {
+      for (ext_t idx = 0; idx < width; idx++) {
+        colors[idx] = color_scale(colors[idx], opacity);
+      }
+    }
+
+    // combine the row with the destination while it is still in cache
+    if (NULL != compositor) {
+      compositor->fn(row, destination, width, compositor->args);
+    }
+  }
+
+out:
+  PyMem_Free(row);
+  return ret;
 }
 
-static inline color_t color_scale(color_t color, double scale) {
-  // scales only the color components, alpha channel is untouched
-  return color_from_channels(
-      clamp_u8((color_t)(color_channel_red(color) * scale)),
-      clamp_u8((color_t)(color_channel_green(color) * scale)),
-      clamp_u8((color_t)(color_channel_blue(color) * scale)),
-      color_channel_alpha(color));
+/**
+ * @brief Prepare a sampler for the region where the field screen and
+ *  interface overlap.
+ *
+ * @return int 0 on success, 1 when there is nothing to draw and -1
+ *  with the Python error indicator set on failure.
+ */
+static int prepare_scalar_field(
+    InterfaceObject* interface_obj, ScreenObject* field_obj,
+    ScalarFieldObject* scalar_field_obj, ext_t width, ext_t height,
+    int filter, screen_t* region, scalar_field_sampler_t* sampler) {
+  if ((SAMPLE_FILTER_NEAREST != filter) &&
+      (SAMPLE_FILTER_BILINEAR != filter)) {
+    PyErr_SetString(PyExc_ValueError, "unknown sampling filter");
+    return -1;
+  }
+
+  // without an explicit extent the field matches the screen
+  if ((width < 0) && (height < 0)) {
+    width = field_obj->screen->width;
+    height = field_obj->screen->height;
+  }
+  if ((width <= 0) || (height <= 0) ||
+      ((size_t)width * (size_t)height > scalar_field_obj->length)) {
+    PyErr_SetString(PyExc_ValueError, "scalars buffer is too small");
+    return -1;
+  }
+
+  // only the region shared by the field and the interface is drawn
+  int ret = screen_intersect(
+      region, field_obj->screen, interface_obj->interface.screen);
+  if (SICGL_SCREEN_INTERSECTION_NONEXISTENT == ret) {
+    return 1;
+  } else if (0 != ret) {
+    PyErr_SetNone(PyExc_OSError);
+    return -1;
+  }
+
+  ret = ScalarField_sampler_init(
+      sampler, scalar_field_obj, field_obj->screen, width, height, filter,
+      region);
+  if (-ENOMEM == ret) {
+    PyErr_NoMemory();
+    return -1;
+  } else if (0 != ret) {
+    PyErr_SetNone(PyExc_OSError);
+    return -1;
+  }
+
+  return 0;
 }
 
 PyObject* scalar_field(PyObject* self_in, PyObject* args, PyObject* kwds) {
@@ -38,16 +170,60 @@ PyObject* scalar_field(PyObject* self_in, PyObject* args, PyObject* kwds) {
   ScalarFieldObject* scalar_field_obj;
   ColorSequenceObject* color_sequence_obj;
   double offset = 0.0;
+  ext_t width = -1;
+  ext_t height = -1;
+  int filter = SAMPLE_FILTER_BILINEAR;
   char* keywords[] = {
-      "interface", "screen", "scalar_field", "color_sequence", "offset", NULL,
+      "interface",
+      "screen",
+      "scalar_field",
+      "color_sequence",
+      "offset",
+      "extent",
+      "filter",
+      NULL,
   };
   if (!PyArg_ParseTupleAndKeywords(
-          args, kwds, "O!O!O!O!|d", keywords, &InterfaceType, &interface_obj,
-          &ScreenType, &field_obj, &ScalarFieldType, &scalar_field_obj,
-          &ColorSequenceType, &color_sequence_obj, &offset)) {
+          args, kwds, "O!O!O!O!|d(ii)i", keywords, &InterfaceType,
+          &interface_obj, &ScreenType, &field_obj, &ScalarFieldType,
+          &scalar_field_obj, &ColorSequenceType, &color_sequence_obj, &offset,
+          &width, &height, &filter)) {
     return NULL;
   }
 
+  ColorSequenceInterpolatorObject* interpolator_obj =
+      color_sequence_obj->interpolator;
+
+  // fields with their own extent or reduced precision storage are
+  // sampled row by row, otherwise sicgl maps the field directly
+  if ((width >= 0) || (height >= 0) ||
+      (SCALAR_STORAGE_FLOAT64 != scalar_field_obj->storage)) {
+    if (0 != Interface_check(&interface_obj->interface)) {
+      return NULL;
+    }
+    screen_t region;
+    scalar_field_sampler_t sampler;
+    ret = prepare_scalar_field(
+        interface_obj, field_obj, scalar_field_obj, width, height, filter,
+        &region, &sampler);
+    if (0 > ret) {
+      return NULL;
+    } else if (0 == ret) {
+      ret = draw_scalar_field(
+          &interface_obj->interface, sampler_row, &sampler, &region,
+          &color_sequence_obj->sequence, interpolator_obj->fn, offset, 1.0,
+          NULL);
+      ScalarField_sampler_deinit(&sampler);
+      if (0 != ret) {
+        PyErr_SetNone(PyExc_OSError);
+        return NULL;
+      }
+    }
+
+    Py_INCREF(Py_None);
+    return Py_None;
+  }
+
   Py_INCREF(color_sequence_obj);
   Py_INCREF(scalar_field_obj);
 
@@ -56,28 +232,184 @@ PyObject* scalar_field(PyObject* self_in, PyObject* args, PyObject* kwds) {
   ret = screen_get_num_pixels(field_obj->screen, &pixels);
   if (0 != ret) {
     PyErr_SetNone(PyExc_OSError);
-    return NULL;
+    goto fail;
   }
 
   size_t scalars = scalar_field_obj->length;
   if (pixels > scalars) {
     PyErr_SetString(PyExc_ValueError, "scalars buffer is too small");
-    return NULL;
+    goto fail;
   }
 
-  ColorSequenceInterpolatorObject* interpolator_obj =
-      color_sequence_obj->interpolator;
   ret = sicgl_scalar_field(
       &interface_obj->interface, field_obj->screen, scalar_field_obj->scalars,
       offset, &color_sequence_obj->sequence, interpolator_obj->fn);
   if (0 != ret) {
     PyErr_SetNone(PyExc_OSError);
-    return NULL;
+    goto fail;
   }
 
   Py_DECREF(scalar_field_obj);
   Py_DECREF(color_sequence_obj);
 
+  Py_INCREF(Py_None);
+  return Py_None;
+
+fail:
+  Py_DECREF(scalar_field_obj);
+  Py_DECREF(color_sequence_obj);
+  return NULL;
+}
+
+PyObject* scalar_field_compose(
+    PyObject* self_in, PyObject* args, PyObject* kwds) {
+  (void)self_in;
+  int ret = 0;
+  InterfaceObject* interface_obj;
+  ScreenObject* field_obj;
+  ScalarFieldObject* scalar_field_obj;
+  ColorSequenceObject* color_sequence_obj;
+  CompositorObject* compositor_obj;
+  double offset = 0.0;
+  double opacity = 1.0;
+  ext_t width = -1;
+  ext_t height = -1;
+  int filter = SAMPLE_FILTER_BILINEAR;
+  char* keywords[] = {
+      "interface",
+      "screen",
+      "scalar_field",
+      "color_sequence",
+      "compositor",
+      "offset",
+      "opacity",
+      "extent",
+      "filter",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!O!O!O!O!|dd(ii)i", keywords, &InterfaceType,
+          &interface_obj, &ScreenType, &field_obj, &ScalarFieldType,
+          &scalar_field_obj, &ColorSequenceType, &color_sequence_obj,
+          &CompositorType, &compositor_obj, &offset, &opacity, &width,
+          &height, &filter)) {
+    return NULL;
+  }
+  if ((0 != Compositor_check(compositor_obj)) ||
+      (0 != Interface_check(&interface_obj->interface))) {
+    return NULL;
+  }
+
+  screen_t region;
+  scalar_field_sampler_t sampler;
+  ret = prepare_scalar_field(
+      interface_obj, field_obj, scalar_field_obj, width, height, filter,
+      &region, &sampler);
+  if (0 > ret) {
+    return NULL;
+  } else if (0 == ret) {
+    ret = draw_scalar_field(
+        &interface_obj->interface, sampler_row, &sampler, &region,
+        &color_sequence_obj->sequence, color_sequence_obj->interpolator->fn,
+        offset, opacity, compositor_obj);
+    ScalarField_sampler_deinit(&sampler);
+    if (-ENOMEM == ret) {
+      PyErr_NoMemory();
+      return NULL;
+    } else if (0 != ret) {
+      PyErr_SetNone(PyExc_OSError);
+      return NULL;
+    }
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+PyObject* scalar_expression(
+    PyObject* self_in, PyObject* args, PyObject* kwds) {
+  (void)self_in;
+  int ret = 0;
+  InterfaceObject* interface_obj;
+  ScreenObject* screen_obj;
+  ScalarExpressionObject* expression_obj;
+  ColorSequenceObject* color_sequence_obj;
+  double t = 0.0;
+  double offset = 0.0;
+  PyObject* compositor_obj = Py_None;
+  double opacity = 1.0;
+  char* keywords[] = {
+      "interface",
+      "screen",
+      "expression",
+      "color_sequence",
+      "t",
+      "offset",
+      "compositor",
+      "opacity",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!O!O!O!|ddOd", keywords, &InterfaceType,
+          &interface_obj, &ScreenType, &screen_obj, &ScalarExpressionType,
+          &expression_obj, &ColorSequenceType, &color_sequence_obj, &t,
+          &offset, &compositor_obj, &opacity)) {
+    return NULL;
+  }
+  CompositorObject* compositor = NULL;
+  if (Py_None != compositor_obj) {
+    if (!PyObject_TypeCheck(compositor_obj, &CompositorType)) {
+      PyErr_SetString(PyExc_TypeError, "compositor must be a Compositor");
+      return NULL;
+    }
+    compositor = (CompositorObject*)compositor_obj;
+    if (0 != Compositor_check(compositor)) {
+      return NULL;
+    }
+  }
+  if (0 != Interface_check(&interface_obj->interface)) {
+    return NULL;
+  }
+
+  // only the region shared by the screen and the interface is drawn
+  screen_t region;
+  ret = screen_intersect(
+      &region, screen_obj->screen, interface_obj->interface.screen);
+  if (SICGL_SCREEN_INTERSECTION_NONEXISTENT == ret) {
+    Py_INCREF(Py_None);
+    return Py_None;
+  } else if (0 != ret) {
+    PyErr_SetNone(PyExc_OSError);
+    return NULL;
+  }
+
+  // the expression sees coordinates relative to the screen
+  expression_rows_t rows = {
+      .screen = screen_obj->screen,
+      .u0 = region._gu0 - screen_obj->screen->_gu0,
+      .count = region._gu1 - region._gu0 + 1,
+  };
+  rows.row = PyMem_Malloc(rows.count * sizeof(double));
+  if (NULL == rows.row) {
+    return PyErr_NoMemory();
+  }
+  ret = ScalarExpression_evaluator_init(&rows.evaluator, expression_obj, t);
+  if (0 == ret) {
+    ret = draw_scalar_field(
+        &interface_obj->interface, expression_row, &rows, &region,
+        &color_sequence_obj->sequence, color_sequence_obj->interpolator->fn,
+        offset, opacity, compositor);
+  }
+  ScalarExpression_evaluator_deinit(&rows.evaluator);
+  PyMem_Free(rows.row);
+  if (-ENOMEM == ret) {
+    PyErr_NoMemory();
+    return NULL;
+  } else if (0 != ret) {
+    PyErr_SetNone(PyExc_OSError);
+    return NULL;
+  }
+
   Py_INCREF(Py_None);
   return Py_None;
 }
@@ -93,10 +425,17 @@ PyObject* compose(PyObject* self_in, PyObject* args) {
           &screen, &sprite, &CompositorType, &compositor)) {
     return NULL;
   }
+  if (0 != Compositor_check(compositor)) {
+    PyBuffer_Release(&sprite);
+    return NULL;
+  }
 
   int ret = sicgl_compose(
       &interface_obj->interface, screen->screen, sprite.buf, compositor->fn,
       compositor->args);
+
+  PyBuffer_Release(&sprite);
+
   if (0 != ret) {
     PyErr_SetNone(PyExc_OSError);
     return NULL;
@@ -146,3 +485,33 @@ PyObject* scale(PyObject* self_in, PyObject* args) {
   Py_INCREF(Py_None);
   return Py_None;
 }
+
+PyObject* premultiply_alpha(PyObject* self_in, PyObject* args) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  if (!PyArg_ParseTuple(args, "O!", &InterfaceType, &interface_obj)) {
+    return NULL;
+  }
+  color_t* memory = interface_obj->interface.memory;
+  for (size_t idx = 0; idx < interface_obj->interface.length; idx++) {
+    memory[idx] = color_premultiply(memory[idx]);
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+PyObject* unpremultiply_alpha(PyObject* self_in, PyObject* args) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  if (!PyArg_ParseTuple(args, "O!", &InterfaceType, &interface_obj)) {
+    return NULL;
+  }
+  color_t* memory = interface_obj->interface.memory;
+  for (size_t idx = 0; idx < interface_obj->interface.length; idx++) {
+    memory[idx] = color_unpremultiply(memory[idx]);
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
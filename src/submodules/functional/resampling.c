@@ -0,0 +1,693 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "pysicgl/submodules/functional/resampling.h"
+#include "pysicgl/submodules/functional/sampling.h"
+#include "pysicgl/types/compositor.h"
+#include "pysicgl/types/interface.h"
+
+// source coordinates are stepped in 16.16 fixed point
+#define FIXED_SHIFT (16)
+#define FIXED_ONE (1 << FIXED_SHIFT)
+#define FIXED_HALF (FIXED_ONE >> 1)
+
+// bilinear weights are kept to 8 bits so that blends fit in 32 bits
+#define WEIGHT_SHIFT (8)
+#define WEIGHT_ONE (1 << WEIGHT_SHIFT)
+
+// a rectangle with inclusive corners
+typedef struct _rect_t {
+  ext_t u0, v0, u1, v1;
+} rect_t;
+
+/**
+ * @brief Put the corners of a rectangle in ascending order.
+ *
+ * @param rect
+ */
+static void rect_order(rect_t* rect) {
+  if (rect->u0 > rect->u1) {
+    ext_t tmp = rect->u0;
+    rect->u0 = rect->u1;
+    rect->u1 = tmp;
+  }
+  if (rect->v0 > rect->v1) {
+    ext_t tmp = rect->v0;
+    rect->v0 = rect->v1;
+    rect->v1 = tmp;
+  }
+}
+
+/**
+ * @brief Check that an ordered source region lies within its interface.
+ *
+ * @param source
+ * @param region
+ * @return int 0 when valid, -1 with the Python error indicator set.
+ */
+static int check_region(interface_t* source, rect_t region) {
+  if ((region.u0 < 0) || (region.v0 < 0) ||
+      (region.u1 >= source->screen->width) ||
+      (region.v1 >= source->screen->height)) {
+    PyErr_SetString(PyExc_ValueError, "source corners out of range");
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Blend two colors channel by channel.
+ *
+ * @param a
+ * @param b
+ * @param weight weight of b in [0, WEIGHT_ONE).
+ * @return color_t
+ */
+static inline color_t lerp_color(color_t a, color_t b, color_t weight) {
+  color_t inverse = WEIGHT_ONE - weight;
+  return color_from_channels(
+      (color_channel_red(a) * inverse + color_channel_red(b) * weight) >>
+          WEIGHT_SHIFT,
+      (color_channel_green(a) * inverse + color_channel_green(b) * weight) >>
+          WEIGHT_SHIFT,
+      (color_channel_blue(a) * inverse + color_channel_blue(b) * weight) >>
+          WEIGHT_SHIFT,
+      (color_channel_alpha(a) * inverse + color_channel_alpha(b) * weight) >>
+          WEIGHT_SHIFT);
+}
+
+/**
+ * @brief Find the source sample for each of a range of destination pixels.
+ *
+ * @param first index of the first destination pixel in the mapping.
+ * @param count number of destination pixels.
+ * @param step source pixels per destination pixel in fixed point.
+ * @param limit number of source pixels.
+ * @param filter
+ * @param index output first source pixel of each sample.
+ * @param weight output weight of the following source pixel, bilinear only.
+ */
+static void map_samples(
+    int64_t first, size_t count, int64_t step, ext_t limit,
+    sample_filter_t filter, ext_t* index, color_t* weight) {
+  for (size_t idx = 0; idx < count; idx++) {
+    // sample at the center of each destination pixel
+    int64_t position = (first + (int64_t)idx) * step + (step >> 1);
+    if (SAMPLE_FILTER_BILINEAR == filter) {
+      position -= FIXED_HALF;
+      if (position < 0) {
+        position = 0;
+      }
+      ext_t sample = (ext_t)(position >> FIXED_SHIFT);
+      if (sample >= limit - 1) {
+        index[idx] = limit - 1;
+        weight[idx] = 0;
+      } else {
+        index[idx] = sample;
+        weight[idx] = (color_t)((position >> (FIXED_SHIFT - WEIGHT_SHIFT)) &
+                                (WEIGHT_ONE - 1));
+      }
+    } else {
+      ext_t sample = (ext_t)(position >> FIXED_SHIFT);
+      index[idx] = (sample < limit) ? sample : limit - 1;
+    }
+  }
+}
+
+/**
+ * @brief Get the pixels of a source region for reading.
+ *
+ * When an interface is drawn onto itself the region is copied so that
+ * reads are not affected by the writes.
+ *
+ * @param destination
+ * @param source
+ * @param region
+ * @param stride output distance between rows of the pixels.
+ * @param snapshot output copy of the region which the caller must free,
+ *  or NULL when the source is read in place.
+ * @return color_t* the first pixel of the region, or NULL with the Python
+ *  error indicator set.
+ */
+static color_t* source_pixels(
+    interface_t* destination, interface_t* source, rect_t region,
+    ext_t* stride, color_t** snapshot) {
+  ext_t sw = region.u1 - region.u0 + 1;
+  ext_t sh = region.v1 - region.v0 + 1;
+  *stride = source->screen->width;
+  *snapshot = NULL;
+  color_t* pixels = &source->memory[region.v0 * *stride + region.u0];
+  if (source->memory != destination->memory) {
+    return pixels;
+  }
+
+  *snapshot = PyMem_Malloc((size_t)sw * (size_t)sh * sizeof(color_t));
+  if (NULL == *snapshot) {
+    PyErr_NoMemory();
+    return NULL;
+  }
+  for (ext_t v = 0; v < sh; v++) {
+    memcpy(&(*snapshot)[v * sw], &pixels[v * *stride], sw * sizeof(color_t));
+  }
+  *stride = sw;
+  return *snapshot;
+}
+
+/**
+ * @brief Draw a region of a source interface scaled onto a rectangle.
+ *
+ * Source positions are stepped in fixed point. Column samples are found
+ * once and each destination row is resampled into a buffer which is then
+ * copied or composed onto the destination.
+ *
+ * @param destination
+ * @param target destination rectangle in interface coordinates.
+ * @param source
+ * @param region source rectangle in source interface coordinates.
+ * @param filter
+ * @param compositor compositor, or NULL to copy the pixels.
+ * @return int 0 on success, -1 with the Python error indicator set.
+ */
+static int scaled_draw(
+    interface_t* destination, rect_t target, interface_t* source,
+    rect_t region, sample_filter_t filter, CompositorObject* compositor) {
+  int ret = 0;
+  color_t* snapshot = NULL;
+  ext_t* columns = NULL;
+  color_t* weights = NULL;
+  color_t* row = NULL;
+
+  rect_order(&target);
+  rect_order(&region);
+  if (0 != check_region(source, region)) {
+    ret = -1;
+    goto out;
+  }
+
+  // clip the target to the destination
+  screen_t* screen = destination->screen;
+  rect_t visible = {
+      .u0 = (target.u0 > 0) ? target.u0 : 0,
+      .v0 = (target.v0 > 0) ? target.v0 : 0,
+      .u1 = (target.u1 < screen->width - 1) ? target.u1 : screen->width - 1,
+      .v1 = (target.v1 < screen->height - 1) ? target.v1 : screen->height - 1,
+  };
+  if ((visible.u0 > visible.u1) || (visible.v0 > visible.v1)) {
+    goto out;
+  }
+
+  // the extents of the target span up to 2^32 pixels, which only fit in
+  // 64 bits, and the source must not be stepped by less than a fixed point
+  // unit per target pixel
+  ext_t sw = region.u1 - region.u0 + 1;
+  ext_t sh = region.v1 - region.v0 + 1;
+  int64_t step_u =
+      ((int64_t)sw << FIXED_SHIFT) / ((int64_t)target.u1 - target.u0 + 1);
+  int64_t step_v =
+      ((int64_t)sh << FIXED_SHIFT) / ((int64_t)target.v1 - target.v0 + 1);
+  if ((0 == step_u) || (0 == step_v)) {
+    PyErr_SetString(PyExc_ValueError, "target is too large for the source");
+    ret = -1;
+    goto out;
+  }
+
+  ext_t stride;
+  color_t* pixels =
+      source_pixels(destination, source, region, &stride, &snapshot);
+  if (NULL == pixels) {
+    ret = -1;
+    goto out;
+  }
+
+  size_t count = visible.u1 - visible.u0 + 1;
+  columns = PyMem_Malloc(count * sizeof(ext_t));
+  weights = PyMem_Malloc(count * sizeof(color_t));
+  row = PyMem_Malloc(count * sizeof(color_t));
+  if ((NULL == columns) || (NULL == weights) || (NULL == row)) {
+    PyErr_NoMemory();
+    ret = -1;
+    goto out;
+  }
+
+  map_samples(
+      (int64_t)visible.u0 - target.u0, count, step_u, sw, filter, columns,
+      weights);
+
+  for (ext_t v = visible.v0; v <= visible.v1; v++) {
+    ext_t sample;
+    color_t weight = 0;
+    map_samples(
+        (int64_t)v - target.v0, 1, step_v, sh, filter, &sample, &weight);
+    color_t* upper = &pixels[sample * stride];
+    color_t* lower = (weight > 0) ? &upper[stride] : upper;
+    color_t* output = &destination->memory[v * screen->width + visible.u0];
+
+    // nearest neighbor copies need no intermediate row
+    color_t* resampled = (NULL == compositor) ? output : row;
+    if (SAMPLE_FILTER_BILINEAR == filter) {
+      for (size_t idx = 0; idx < count; idx++) {
+        ext_t u = columns[idx];
+        ext_t next = (weights[idx] > 0) ? u + 1 : u;
+        color_t top = lerp_color(upper[u], upper[next], weights[idx]);
+        color_t bottom = lerp_color(lower[u], lower[next], weights[idx]);
+        resampled[idx] = lerp_color(top, bottom, weight);
+      }
+    } else {
+      for (size_t idx = 0; idx < count; idx++) {
+        resampled[idx] = upper[columns[idx]];
+      }
+    }
+
+    if (NULL != compositor) {
+      compositor->fn(row, output, count, compositor->args);
+    }
+  }
+
+out:
+  PyMem_Free(row);
+  PyMem_Free(weights);
+  PyMem_Free(columns);
+  PyMem_Free(snapshot);
+  return ret;
+}
+
+/**
+ * @brief Split a fixed point position into the two pixels which straddle it.
+ *
+ * @param position fixed point position, already offset by half a pixel.
+ * @param limit number of pixels.
+ * @param first output first pixel.
+ * @param second output second pixel.
+ * @param weight output weight of the second pixel.
+ */
+static inline void split_position(
+    int64_t position, ext_t limit, ext_t* first, ext_t* second,
+    color_t* weight) {
+  if (position <= 0) {
+    *first = 0;
+    *second = 0;
+    *weight = 0;
+    return;
+  }
+  ext_t sample = (ext_t)(position >> FIXED_SHIFT);
+  if (sample >= limit - 1) {
+    *first = limit - 1;
+    *second = limit - 1;
+    *weight = 0;
+    return;
+  }
+  *first = sample;
+  *second = sample + 1;
+  *weight =
+      (color_t)((position >> (FIXED_SHIFT - WEIGHT_SHIFT)) & (WEIGHT_ONE - 1));
+}
+
+/**
+ * @brief Draw a region of a source interface through an affine transform.
+ *
+ * The corners of the region are mapped forward to find the bounding box
+ * of the output, which is clipped to the destination. Each destination
+ * pixel center within it is then mapped back onto the source by stepping
+ * the inverse transform in fixed point along the row. Runs of pixels
+ * which land within the region are resampled into a buffer and copied or
+ * composed onto the destination.
+ *
+ * @param destination
+ * @param matrix 2x3 transform from source to destination interface
+ *  coordinates, row major.
+ * @param source
+ * @param region source rectangle in source interface coordinates.
+ * @param filter
+ * @param compositor compositor, or NULL to copy the pixels.
+ * @return int 0 on success, -1 with the Python error indicator set.
+ */
+static int affine_draw(
+    interface_t* destination, double matrix[6], interface_t* source,
+    rect_t region, sample_filter_t filter, CompositorObject* compositor) {
+  int ret = 0;
+  color_t* snapshot = NULL;
+  color_t* row = NULL;
+
+  rect_order(&region);
+  if (0 != check_region(source, region)) {
+    ret = -1;
+    goto out;
+  }
+
+  double a = matrix[0], b = matrix[1], c = matrix[2];
+  double d = matrix[3], e = matrix[4], f = matrix[5];
+  double determinant = a * e - b * d;
+  if ((0.0 == determinant) || !isfinite(determinant)) {
+    PyErr_SetString(PyExc_ValueError, "transform is not invertible");
+    ret = -1;
+    goto out;
+  }
+
+  // bounding box of the transformed region
+  double xs[4] = {region.u0, region.u1 + 1, region.u0, region.u1 + 1};
+  double ys[4] = {region.v0, region.v0, region.v1 + 1, region.v1 + 1};
+  double min_u = INFINITY, min_v = INFINITY;
+  double max_u = -INFINITY, max_v = -INFINITY;
+  for (size_t idx = 0; idx < 4; idx++) {
+    double u = a * xs[idx] + b * ys[idx] + c;
+    double v = d * xs[idx] + e * ys[idx] + f;
+    min_u = fmin(min_u, u);
+    max_u = fmax(max_u, u);
+    min_v = fmin(min_v, v);
+    max_v = fmax(max_v, v);
+  }
+
+  // clip the bounding box to the destination while it is still a double,
+  // a box which misses it may lie beyond the range of ext_t
+  screen_t* screen = destination->screen;
+  if (!(max_u >= 0.0) || !(max_v >= 0.0) ||
+      !(min_u <= (double)screen->width - 1) ||
+      !(min_v <= (double)screen->height - 1)) {
+    goto out;
+  }
+  rect_t visible = {
+      .u0 = (ext_t)fmax(floor(min_u), 0.0),
+      .v0 = (ext_t)fmax(floor(min_v), 0.0),
+      .u1 = (ext_t)fmin(ceil(max_u), (double)screen->width - 1),
+      .v1 = (ext_t)fmin(ceil(max_v), (double)screen->height - 1),
+  };
+  if ((visible.u0 > visible.u1) || (visible.v0 > visible.v1)) {
+    goto out;
+  }
+
+  ext_t sw = region.u1 - region.u0 + 1;
+  ext_t sh = region.v1 - region.v0 + 1;
+  ext_t stride;
+  color_t* pixels =
+      source_pixels(destination, source, region, &stride, &snapshot);
+  if (NULL == pixels) {
+    ret = -1;
+    goto out;
+  }
+
+  size_t count = visible.u1 - visible.u0 + 1;
+  row = PyMem_Malloc(count * sizeof(color_t));
+  if (NULL == row) {
+    PyErr_NoMemory();
+    ret = -1;
+    goto out;
+  }
+
+  // the inverse transform, from destination onto source region coordinates
+  double ia = e / determinant, ib = -b / determinant;
+  double id = -d / determinant, ie = a / determinant;
+  double tx = -(ia * c + ib * f) - region.u0;
+  double ty = -(id * c + ie * f) - region.v0;
+  int64_t step_x = (int64_t)llround(ia * FIXED_ONE);
+  int64_t step_y = (int64_t)llround(id * FIXED_ONE);
+  int64_t width = (int64_t)sw << FIXED_SHIFT;
+  int64_t height = (int64_t)sh << FIXED_SHIFT;
+
+  for (ext_t v = visible.v0; v <= visible.v1; v++) {
+    double cu = visible.u0 + 0.5;
+    double cv = v + 0.5;
+    int64_t x = (int64_t)llround((ia * cu + ib * cv + tx) * FIXED_ONE);
+    int64_t y = (int64_t)llround((id * cu + ie * cv + ty) * FIXED_ONE);
+    color_t* output = &destination->memory[v * screen->width + visible.u0];
+
+    size_t run = 0;
+    for (size_t idx = 0; idx <= count; idx++, x += step_x, y += step_y) {
+      bool inside =
+          (idx < count) && (x >= 0) && (x < width) && (y >= 0) && (y < height);
+      if (inside) {
+        color_t color;
+        if (SAMPLE_FILTER_BILINEAR == filter) {
+          ext_t x0, x1, y0, y1;
+          color_t wx, wy;
+          split_position(x - FIXED_HALF, sw, &x0, &x1, &wx);
+          split_position(y - FIXED_HALF, sh, &y0, &y1, &wy);
+          color_t* upper = &pixels[y0 * stride];
+          color_t* lower = &pixels[y1 * stride];
+          color = lerp_color(
+              lerp_color(upper[x0], upper[x1], wx),
+              lerp_color(lower[x0], lower[x1], wx), wy);
+        } else {
+          color = pixels
+              [(y >> FIXED_SHIFT) * stride + (ext_t)(x >> FIXED_SHIFT)];
+        }
+        row[run++] = color;
+        continue;
+      }
+
+      // flush the run which ended before this pixel
+      if (run > 0) {
+        color_t* start = &output[idx - run];
+        if (NULL == compositor) {
+          memcpy(start, row, run * sizeof(color_t));
+        } else {
+          compositor->fn(row, start, run, compositor->args);
+        }
+        run = 0;
+      }
+    }
+  }
+
+out:
+  PyMem_Free(row);
+  PyMem_Free(snapshot);
+  return ret;
+}
+
+/**
+ * @brief Check that a sampling filter is known.
+ *
+ * @param filter
+ * @return int 0 when valid, -1 with the Python error indicator set.
+ */
+static int check_filter(int filter) {
+  if ((SAMPLE_FILTER_NEAREST != filter) &&
+      (SAMPLE_FILTER_BILINEAR != filter)) {
+    PyErr_SetString(PyExc_ValueError, "unknown sampling filter");
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Parse optional source corners, defaulting to the whole source.
+ *
+ * @return int 0 on success, -1 with the Python error indicator set.
+ */
+static int parse_source_corners(
+    PyObject* corners_obj, interface_t* source, rect_t* region) {
+  if (Py_None == corners_obj) {
+    region->u0 = 0;
+    region->v0 = 0;
+    region->u1 = source->screen->width - 1;
+    region->v1 = source->screen->height - 1;
+    return 0;
+  }
+  if (!PyArg_ParseTuple(
+          corners_obj, "(ii)(ii)", &region->u0, &region->v0, &region->u1,
+          &region->v1)) {
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Copy a region of one interface onto a rectangle of another,
+ * scaling it to fit.
+ *
+ * @param self_in
+ * @param args
+ *  - interface_obj: the destination interface.
+ *  - corners: destination corners ((u0, v0), (u1, v1)) in interface
+ *    coordinates.
+ *  - source_obj: the source interface.
+ *  - source_corners_obj: optional source corners ((u0, v0), (u1, v1)) in
+ *    source interface coordinates. Defaults to the whole source.
+ *  - filter: FILTER_NEAREST or FILTER_BILINEAR.
+ * @param kwds
+ * @return PyObject* None.
+ */
+PyObject* interface_scaled_blit(
+    PyObject* self_in, PyObject* args, PyObject* kwds) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  InterfaceObject* source_obj;
+  PyObject* source_corners_obj = Py_None;
+  rect_t target;
+  rect_t region;
+  int filter = SAMPLE_FILTER_NEAREST;
+  char* keywords[] = {
+      "interface",
+      "corners",
+      "source",
+      "source_corners",
+      "filter",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!((ii)(ii))O!|Oi", keywords, &InterfaceType,
+          &interface_obj, &target.u0, &target.v0, &target.u1, &target.v1,
+          &InterfaceType, &source_obj, &source_corners_obj, &filter)) {
+    return NULL;
+  }
+
+  interface_t* destination = &interface_obj->interface;
+  interface_t* source = &source_obj->interface;
+  if ((0 != Interface_check(destination)) || (0 != Interface_check(source)) ||
+      (0 != parse_source_corners(source_corners_obj, source, &region)) ||
+      (0 != check_filter(filter))) {
+    return NULL;
+  }
+
+  if (0 != scaled_draw(
+               destination, target, source, region, (sample_filter_t)filter,
+               NULL)) {
+    return NULL;
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+/**
+ * @brief Compose a region of one interface onto a rectangle of another,
+ * scaling it to fit.
+ *
+ * @param self_in
+ * @param args
+ *  - interface_obj: the destination interface.
+ *  - corners: destination corners ((u0, v0), (u1, v1)) in interface
+ *    coordinates.
+ *  - source_obj: the source interface.
+ *  - compositor_obj: the compositor.
+ *  - source_corners_obj: optional source corners ((u0, v0), (u1, v1)) in
+ *    source interface coordinates. Defaults to the whole source.
+ *  - filter: FILTER_NEAREST or FILTER_BILINEAR.
+ * @param kwds
+ * @return PyObject* None.
+ */
+PyObject* interface_scaled_compose(
+    PyObject* self_in, PyObject* args, PyObject* kwds) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  InterfaceObject* source_obj;
+  CompositorObject* compositor_obj;
+  PyObject* source_corners_obj = Py_None;
+  rect_t target;
+  rect_t region;
+  int filter = SAMPLE_FILTER_NEAREST;
+  char* keywords[] = {
+      "interface",
+      "corners",
+      "source",
+      "compositor",
+      "source_corners",
+      "filter",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!((ii)(ii))O!O!|Oi", keywords, &InterfaceType,
+          &interface_obj, &target.u0, &target.v0, &target.u1, &target.v1,
+          &InterfaceType, &source_obj, &CompositorType, &compositor_obj,
+          &source_corners_obj, &filter)) {
+    return NULL;
+  }
+
+  interface_t* destination = &interface_obj->interface;
+  interface_t* source = &source_obj->interface;
+  if ((0 != Interface_check(destination)) || (0 != Interface_check(source)) ||
+      (0 != Compositor_check(compositor_obj)) ||
+      (0 != parse_source_corners(source_corners_obj, source, &region)) ||
+      (0 != check_filter(filter))) {
+    return NULL;
+  }
+
+  if (0 != scaled_draw(
+               destination, target, source, region, (sample_filter_t)filter,
+               compositor_obj)) {
+    return NULL;
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+/**
+ * @brief Draw a region of one interface onto another through an affine
+ * transform.
+ *
+ * @param self_in
+ * @param args
+ *  - interface_obj: the destination interface.
+ *  - matrix: ((a, b, c), (d, e, f)) mapping source interface coordinates
+ *    (x, y) to destination interface coordinates
+ *    (a * x + b * y + c, d * x + e * y + f).
+ *  - source_obj: the source interface.
+ *  - compositor_obj: optional compositor, pixels are copied when None.
+ *  - source_corners_obj: optional source corners ((u0, v0), (u1, v1)) in
+ *    source interface coordinates. Defaults to the whole source.
+ *  - filter: FILTER_NEAREST or FILTER_BILINEAR.
+ * @param kwds
+ * @return PyObject* None.
+ */
+PyObject* interface_affine_blit(
+    PyObject* self_in, PyObject* args, PyObject* kwds) {
+  (void)self_in;
+  InterfaceObject* interface_obj;
+  InterfaceObject* source_obj;
+  PyObject* compositor_obj = Py_None;
+  PyObject* source_corners_obj = Py_None;
+  double matrix[6];
+  rect_t region;
+  int filter = SAMPLE_FILTER_NEAREST;
+  char* keywords[] = {
+      "interface",
+      "matrix",
+      "source",
+      "compositor",
+      "source_corners",
+      "filter",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!((ddd)(ddd))O!|OOi", keywords, &InterfaceType,
+          &interface_obj, &matrix[0], &matrix[1], &matrix[2], &matrix[3],
+          &matrix[4], &matrix[5], &InterfaceType, &source_obj,
+          &compositor_obj, &source_corners_obj, &filter)) {
+    return NULL;
+  }
+
+  CompositorObject* compositor = NULL;
+  if (Py_None != compositor_obj) {
+    if (!PyObject_TypeCheck(compositor_obj, &CompositorType)) {
+      PyErr_SetString(PyExc_TypeError, "compositor must be a Compositor");
+      return NULL;
+    }
+    compositor = (CompositorObject*)compositor_obj;
+    if (0 != Compositor_check(compositor)) {
+      return NULL;
+    }
+  }
+
+  interface_t* destination = &interface_obj->interface;
+  interface_t* source = &source_obj->interface;
+  if ((0 != Interface_check(destination)) || (0 != Interface_check(source)) ||
+      (0 != parse_source_corners(source_corners_obj, source, &region)) ||
+      (0 != check_filter(filter))) {
+    return NULL;
+  }
+
+  if (0 != affine_draw(
+               destination, matrix, source, region, (sample_filter_t)filter,
+               compositor)) {
+    return NULL;
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
@@ -0,0 +1,503 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <errno.h>
+#include <string.h>
+
+#include "pysicgl/submodules/functional/filters.h"
+#include "pysicgl/types/bloom.h"
+#include "pysicgl/types/interface.h"
+#include "pysicgl/utilities/color.h"
+
+// resampling positions are stepped in 16.16 fixed point
+#define FIXED_SHIFT (16)
+#define FIXED_HALF (1 << (FIXED_SHIFT - 1))
+
+// blend weights and scale factors are kept to 8 bits
+#define WEIGHT_SHIFT (8)
+#define WEIGHT_ONE (1 << WEIGHT_SHIFT)
+
+// utilities for C consumers
+////////////////////////////
+
+/**
+ * @brief Lay out the mip chain for an extent, growing scratch memory only
+ * when it is too small.
+ *
+ * @param scratch
+ * @param levels most levels in the chain.
+ * @param width
+ * @param height
+ * @return int 0 on success, -ENOMEM when out of memory.
+ */
+static int layout_chain(
+    bloom_scratch_t* scratch, int levels, ext_t width, ext_t height) {
+  int ret = 0;
+
+  // find the extent of each level, halving until a side would vanish
+  bloom_level_t chain[BLOOM_MAX_LEVELS] = {0};
+  size_t num_levels = 0;
+  size_t total = 0;
+  ext_t level_width = (width + 1) / 2;
+  ext_t level_height = (height + 1) / 2;
+  while ((num_levels < (size_t)levels) && (level_width > 0) &&
+         (level_height > 0)) {
+    chain[num_levels].width = level_width;
+    chain[num_levels].height = level_height;
+    total += (size_t)level_width * (size_t)level_height;
+    num_levels++;
+    if ((1 == level_width) || (1 == level_height)) {
+      break;
+    }
+    level_width = (level_width + 1) / 2;
+    level_height = (level_height + 1) / 2;
+  }
+
+  // the largest level is also the size of the blur scratch
+  size_t blur = (size_t)chain[0].width * (size_t)chain[0].height;
+  size_t row = (size_t)width;
+  size_t required = total + blur + row;
+  if (required > scratch->capacity) {
+    color_t* buffer =
+        PyMem_Realloc(scratch->buffer, required * sizeof(color_t));
+    if (NULL == buffer) {
+      ret = -ENOMEM;
+      goto out;
+    }
+    scratch->buffer = buffer;
+    scratch->capacity = required;
+  }
+  size_t sums = (size_t)chain[0].width * 4;
+  if (sums > scratch->sums_capacity) {
+    uint64_t* memory = PyMem_Realloc(scratch->sums, sums * sizeof(uint64_t));
+    if (NULL == memory) {
+      ret = -ENOMEM;
+      goto out;
+    }
+    scratch->sums = memory;
+    scratch->sums_capacity = sums;
+  }
+
+  color_t* next = scratch->buffer;
+  for (size_t idx = 0; idx < num_levels; idx++) {
+    chain[idx].memory = next;
+    next += (size_t)chain[idx].width * (size_t)chain[idx].height;
+    scratch->chain[idx] = chain[idx];
+  }
+  scratch->scratch = next;
+  scratch->row = next + blur;
+  scratch->num_levels = num_levels;
+  scratch->levels = levels;
+  scratch->width = width;
+  scratch->height = height;
+
+out:
+  return ret;
+}
+
+/**
+ * @brief Release scratch memory.
+ *
+ * @param scratch
+ */
+static void free_scratch(bloom_scratch_t* scratch) {
+  if (NULL == scratch) {
+    return;
+  }
+  PyMem_Free(scratch->buffer);
+  PyMem_Free(scratch->sums);
+  PyMem_Free(scratch);
+}
+
+/**
+ * @brief Keep the part of a color which is brighter than a threshold.
+ *
+ * The color is scaled by how far its luma exceeds the threshold and its
+ * alpha is cleared so that adding the glow leaves alpha untouched.
+ *
+ * @param color
+ * @param threshold luma threshold in [0, 255].
+ * @param knee fixed point reciprocal of (255 - threshold).
+ * @return color_t
+ */
+static inline color_t bright_pass(
+    color_t color, color_t threshold, color_t knee) {
+  color_t red = color_channel_red(color);
+  color_t green = color_channel_green(color);
+  color_t blue = color_channel_blue(color);
+  color_t luma = (54 * red + 183 * green + 19 * blue) >> 8;
+  if (luma <= threshold) {
+    return 0;
+  }
+  color_t factor = ((luma - threshold) * knee) >> WEIGHT_SHIFT;
+  return color_from_channels(
+      (red * factor) >> WEIGHT_SHIFT, (green * factor) >> WEIGHT_SHIFT,
+      (blue * factor) >> WEIGHT_SHIFT, 0);
+}
+
+/**
+ * @brief Average the 2x2 blocks of a source into a half size destination.
+ *
+ * @param source
+ * @param stride distance between rows of the source.
+ * @param width width of the source.
+ * @param height height of the source.
+ * @param destination level to fill.
+ * @param threshold bright pass threshold, or -1 for none.
+ * @param knee bright pass reciprocal.
+ */
+static void downsample(
+    color_t* source, ext_t stride, ext_t width, ext_t height,
+    bloom_level_t* destination, color_t threshold, color_t knee) {
+  for (ext_t v = 0; v < destination->height; v++) {
+    color_t* upper = &source[2 * v * stride];
+    color_t* lower = (2 * v + 1 < height) ? &upper[stride] : upper;
+    color_t* out = &destination->memory[v * destination->width];
+    for (ext_t u = 0; u < destination->width; u++) {
+      ext_t left = 2 * u;
+      ext_t right = (left + 1 < width) ? left + 1 : left;
+      color_t block[4] = {
+          upper[left],
+          upper[right],
+          lower[left],
+          lower[right],
+      };
+      color_t sums[4] = {0};
+      for (size_t idx = 0; idx < 4; idx++) {
+        color_t color = block[idx];
+        if (threshold >= 0) {
+          color = bright_pass(color, threshold, knee);
+        }
+        sums[0] += color_channel_red(color);
+        sums[1] += color_channel_green(color);
+        sums[2] += color_channel_blue(color);
+        sums[3] += color_channel_alpha(color);
+      }
+      out[u] = color_from_channels(
+          (sums[0] + 2) >> 2, (sums[1] + 2) >> 2, (sums[2] + 2) >> 2,
+          (sums[3] + 2) >> 2);
+    }
+  }
+}
+
+/**
+ * @brief Split a fixed point position into the two samples around it.
+ */
+static inline void split_position(
+    int64_t position, ext_t limit, ext_t* first, ext_t* second,
+    color_t* weight) {
+  if (position <= 0) {
+    *first = 0;
+    *second = 0;
+    *weight = 0;
+    return;
+  }
+  ext_t sample = (ext_t)(position >> FIXED_SHIFT);
+  if (sample >= limit - 1) {
+    *first = limit - 1;
+    *second = limit - 1;
+    *weight = 0;
+    return;
+  }
+  *first = sample;
+  *second = sample + 1;
+  *weight =
+      (color_t)((position >> (FIXED_SHIFT - WEIGHT_SHIFT)) & (WEIGHT_ONE - 1));
+}
+
+static inline color_t lerp_color(color_t a, color_t b, color_t weight) {
+  color_t inverse = WEIGHT_ONE - weight;
+  return color_from_channels(
+      (color_channel_red(a) * inverse + color_channel_red(b) * weight) >>
+          WEIGHT_SHIFT,
+      (color_channel_green(a) * inverse + color_channel_green(b) * weight) >>
+          WEIGHT_SHIFT,
+      (color_channel_blue(a) * inverse + color_channel_blue(b) * weight) >>
+          WEIGHT_SHIFT,
+      (color_channel_alpha(a) * inverse + color_channel_alpha(b) * weight) >>
+          WEIGHT_SHIFT);
+}
+
+/**
+ * @brief Bilinearly upsample one row of a level.
+ *
+ * @param level
+ * @param width width of the upsampled level.
+ * @param height height of the upsampled level.
+ * @param v row of the upsampled level.
+ * @param out output row of width pixels.
+ */
+static void upsample_row(
+    bloom_level_t* level, ext_t width, ext_t height, ext_t v, color_t* out) {
+  int64_t step_u = ((int64_t)level->width << FIXED_SHIFT) / width;
+  int64_t step_v = ((int64_t)level->height << FIXED_SHIFT) / height;
+  ext_t v0, v1;
+  color_t wv;
+  split_position(
+      v * step_v + (step_v >> 1) - FIXED_HALF, level->height, &v0, &v1, &wv);
+  color_t* upper = &level->memory[v0 * level->width];
+  color_t* lower = &level->memory[v1 * level->width];
+  int64_t position = (step_u >> 1) - FIXED_HALF;
+  for (ext_t u = 0; u < width; u++, position += step_u) {
+    ext_t u0, u1;
+    color_t wu;
+    split_position(position, level->width, &u0, &u1, &wu);
+    out[u] = lerp_color(
+        lerp_color(upper[u0], upper[u1], wu),
+        lerp_color(lower[u0], lower[u1], wu), wv);
+  }
+}
+
+/**
+ * @brief Add a row of glow onto a row of pixels, clamping each channel.
+ *
+ * @param destination
+ * @param glow
+ * @param count
+ * @param scale fixed point scale of the glow.
+ */
+static void add_row(
+    color_t* destination, const color_t* glow, size_t count, color_t scale) {
+  for (size_t idx = 0; idx < count; idx++) {
+    color_t d = destination[idx];
+    color_t g = glow[idx];
+    destination[idx] = color_from_channels(
+        clamp_u8(
+            color_channel_red(d) +
+            ((color_channel_red(g) * scale) >> WEIGHT_SHIFT)),
+        clamp_u8(
+            color_channel_green(d) +
+            ((color_channel_green(g) * scale) >> WEIGHT_SHIFT)),
+        clamp_u8(
+            color_channel_blue(d) +
+            ((color_channel_blue(g) * scale) >> WEIGHT_SHIFT)),
+        clamp_u8(
+            color_channel_alpha(d) +
+            ((color_channel_alpha(g) * scale) >> WEIGHT_SHIFT)));
+  }
+}
+
+/**
+ * @brief Add a bloom of the bright areas of an interface onto it.
+ *
+ * The bright areas are found while downsampling to half resolution and
+ * then halved again to build a mip chain. Every level is blurred, which is
+ * cheap at low resolution, and the levels are summed from the smallest up
+ * before being upsampled and added onto the interface. Scratch memory is
+ * kept by the object so that repeated frames of the same extent allocate
+ * nothing.
+ *
+ * The interpreter lock is released while the bloom is applied, so the
+ * interface must stay valid until this returns, see Interface_hold.
+ *
+ * @param self
+ * @param interface
+ * @return int 0 on success, -1 with the Python error indicator set.
+ */
+int Bloom_apply(BloomObject* self, interface_t* interface) {
+  if (0 != Interface_check(interface)) {
+    return -1;
+  }
+  screen_t* screen = interface->screen;
+  ext_t width = screen->width;
+  ext_t height = screen->height;
+  int radius = self->radius;
+  if ((width <= 0) || (height <= 0) || (self->levels < 1)) {
+    return 0;
+  }
+
+  color_t threshold = clamp_u8((color_t)(self->threshold * 255.0));
+  color_t knee = (threshold < 255) ? (WEIGHT_ONE * 255) / (255 - threshold)
+                                   : WEIGHT_ONE;
+  double intensity = self->intensity * WEIGHT_ONE;
+  color_t scale = (intensity > (double)(255 * WEIGHT_ONE))
+                      ? 255 * WEIGHT_ONE
+                      : (color_t)intensity;
+  if (scale <= 0) {
+    return 0;
+  }
+
+  // take the scratch memory, a concurrent application gets its own
+  bloom_scratch_t* scratch = self->scratch;
+  self->scratch = NULL;
+  if (NULL == scratch) {
+    scratch = PyMem_Calloc(1, sizeof(bloom_scratch_t));
+  }
+  if ((NULL == scratch) ||
+      (((width != scratch->width) || (height != scratch->height) ||
+        (self->levels != scratch->levels)) &&
+       (0 != layout_chain(scratch, self->levels, width, height)))) {
+    free_scratch(scratch);
+    PyErr_NoMemory();
+    return -1;
+  }
+  bloom_level_t* chain = scratch->chain;
+  size_t num_levels = scratch->num_levels;
+
+  Py_BEGIN_ALLOW_THREADS;
+
+  // bright pass and mip chain
+  downsample(
+      interface->memory, width, width, height, &chain[0], threshold, knee);
+  for (size_t idx = 1; idx < num_levels; idx++) {
+    bloom_level_t* above = &chain[idx - 1];
+    downsample(
+        above->memory, above->width, above->width, above->height, &chain[idx],
+        -1, 0);
+  }
+
+  for (size_t idx = 0; idx < num_levels; idx++) {
+    bloom_level_t* level = &chain[idx];
+    box_blur_region(
+        level->memory, level->width, level->width, level->height, radius,
+        scratch->scratch, scratch->sums);
+  }
+
+  // sum the levels from the smallest up
+  for (size_t idx = num_levels - 1; idx > 0; idx--) {
+    bloom_level_t* level = &chain[idx - 1];
+    for (ext_t v = 0; v < level->height; v++) {
+      upsample_row(&chain[idx], level->width, level->height, v, scratch->row);
+      add_row(
+          &level->memory[v * level->width], scratch->row, level->width,
+          WEIGHT_ONE);
+    }
+  }
+
+  // add the glow onto the interface
+  for (ext_t v = 0; v < height; v++) {
+    upsample_row(&chain[0], width, height, v, scratch->row);
+    add_row(&interface->memory[v * width], scratch->row, width, scale);
+  }
+
+  Py_END_ALLOW_THREADS;
+
+  // keep the scratch memory for the next frame unless another application
+  // already returned its own
+  if (NULL == self->scratch) {
+    self->scratch = scratch;
+  } else {
+    free_scratch(scratch);
+  }
+
+  return 0;
+}
+
+// getset
+/////////
+
+static PyObject* get_threshold(PyObject* self_in, void* closure) {
+  (void)closure;
+  return PyFloat_FromDouble(((BloomObject*)self_in)->threshold);
+}
+
+static PyObject* get_intensity(PyObject* self_in, void* closure) {
+  (void)closure;
+  return PyFloat_FromDouble(((BloomObject*)self_in)->intensity);
+}
+
+static PyObject* get_levels(PyObject* self_in, void* closure) {
+  (void)closure;
+  return PyLong_FromLong(((BloomObject*)self_in)->levels);
+}
+
+static PyObject* get_radius(PyObject* self_in, void* closure) {
+  (void)closure;
+  return PyLong_FromLong(((BloomObject*)self_in)->radius);
+}
+
+// methods
+//////////
+
+static PyObject* apply(PyObject* self_in, PyObject* args) {
+  BloomObject* self = (BloomObject*)self_in;
+  InterfaceObject* interface_obj;
+  if (!PyArg_ParseTuple(args, "O!", &InterfaceType, &interface_obj)) {
+    return NULL;
+  }
+
+  interface_hold_t hold;
+  if (0 != Interface_hold(interface_obj, &hold)) {
+    return NULL;
+  }
+  int ret = Bloom_apply(self, &hold.interface);
+  Interface_release(&hold);
+  if (0 != ret) {
+    return NULL;
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static void tp_dealloc(PyObject* self_in) {
+  BloomObject* self = (BloomObject*)self_in;
+  free_scratch(self->scratch);
+  Py_TYPE(self)->tp_free(self);
+}
+
+static int tp_init(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  BloomObject* self = (BloomObject*)self_in;
+  double threshold = 0.75;
+  double intensity = 1.0;
+  int levels = 4;
+  int radius = 2;
+  char* keywords[] = {
+      "threshold",
+      "intensity",
+      "levels",
+      "radius",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "|ddii", keywords, &threshold, &intensity, &levels,
+          &radius)) {
+    return -1;
+  }
+  if ((levels < 1) || (levels > BLOOM_MAX_LEVELS)) {
+    PyErr_Format(
+        PyExc_ValueError, "levels must be in the range [1, %d]",
+        BLOOM_MAX_LEVELS);
+    return -1;
+  }
+  if ((radius < 0) || !(intensity >= 0.0)) {
+    PyErr_SetString(
+        PyExc_ValueError, "radius and intensity must not be negative");
+    return -1;
+  }
+
+  self->threshold = threshold;
+  self->intensity = intensity;
+  self->levels = levels;
+  self->radius = radius;
+
+  return 0;
+}
+
+static PyMethodDef tp_methods[] = {
+    {"apply", (PyCFunction)apply, METH_VARARGS,
+     "add a glow of the bright areas of an interface onto it"},
+    {NULL},
+};
+
+static PyGetSetDef tp_getset[] = {
+    {"threshold", get_threshold, NULL, "luma above which pixels glow", NULL},
+    {"intensity", get_intensity, NULL, "scale of the added glow", NULL},
+    {"levels", get_levels, NULL, "number of levels in the mip chain", NULL},
+    {"radius", get_radius, NULL, "blur radius of each level", NULL},
+    {NULL},
+};
+
+PyTypeObject BloomType = {
+    PyVarObject_HEAD_INIT(NULL, 0).tp_name = "_sicgl_core.Bloom",
+    .tp_doc = PyDoc_STR("bloom effect with reusable scratch memory"),
+    .tp_basicsize = sizeof(BloomObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = PyType_GenericNew,
+    .tp_dealloc = tp_dealloc,
+    .tp_init = tp_init,
+    .tp_getset = tp_getset,
+    .tp_methods = tp_methods,
+};
@@ -4,9 +4,71 @@
 // python includes first (clang-format)
 
 #include <errno.h>
+#include <math.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "pysicgl/types/compositor.h"
+#include "pysicgl/utilities/color.h"
+
+// number of pixels which are prepared on the stack at once
+#define COMPOSITOR_CHUNK_SIZE (64)
+
+/**
+ * @brief Compose through a wrapped compositor applying parameters.
+ *
+ * The source is prepared in small chunks on the stack so that the
+ * opacity, constant color and channel mask are applied in the same pass
+ * over the pixels as the wrapped compositor.
+ *
+ * @param source
+ * @param destination
+ * @param width
+ * @param args compositor_params_t of the compositor.
+ */
+static void compositor_parameterized(
+    color_t* source, color_t* destination, size_t width, void* args) {
+  compositor_params_t* params = (compositor_params_t*)args;
+  color_t chunk[COMPOSITOR_CHUNK_SIZE];
+  color_t composed[COMPOSITOR_CHUNK_SIZE];
+  bool scaled = (1.0 != params->opacity);
+  bool masked = ((color_t)-1 != params->mask);
+  color_t color = params->color;
+  if (params->has_color && scaled) {
+    color = color_scale(color, params->opacity);
+  }
+
+  for (size_t start = 0; start < width; start += COMPOSITOR_CHUNK_SIZE) {
+    size_t count = width - start;
+    if (count > COMPOSITOR_CHUNK_SIZE) {
+      count = COMPOSITOR_CHUNK_SIZE;
+    }
+
+    color_t* input = &source[start];
+    if (params->has_color) {
+      for (size_t idx = 0; idx < count; idx++) {
+        chunk[idx] = color;
+      }
+      input = chunk;
+    } else if (scaled) {
+      color_scale_row(chunk, input, count, params->opacity);
+      input = chunk;
+    }
+
+    color_t* output = &destination[start];
+    if (!masked) {
+      params->fn(input, output, count, params->args);
+      continue;
+    }
+
+    memcpy(composed, output, count * sizeof(color_t));
+    params->fn(input, composed, count, params->args);
+    for (size_t idx = 0; idx < count; idx++) {
+      output[idx] =
+          (composed[idx] & params->mask) | (output[idx] & ~params->mask);
+    }
+  }
+}
 
 /**
  * @brief Creates a new compositor object.
@@ -24,10 +86,145 @@ CompositorObject* new_compositor_object(compositor_fn fn, void* args) {
   return self;
 }
 
+/**
+ * @brief Check that a compositor has been initialized.
+ *
+ * @param compositor
+ * @return int 0 when valid, -1 with the Python error indicator set.
+ */
+int Compositor_check(CompositorObject* compositor) {
+  if (NULL == compositor->fn) {
+    PyErr_SetString(PyExc_ValueError, "compositor is not initialized");
+    return -1;
+  }
+  return 0;
+}
+
+// getset
+/////////
+
+static PyObject* get_base(PyObject* self_in, void* closure) {
+  (void)closure;
+  CompositorObject* self = (CompositorObject*)self_in;
+  PyObject* base = (NULL == self->base) ? Py_None : self->base;
+  Py_INCREF(base);
+  return base;
+}
+
+static PyObject* get_opacity(PyObject* self_in, void* closure) {
+  (void)closure;
+  CompositorObject* self = (CompositorObject*)self_in;
+  if (NULL == self->base) {
+    return PyFloat_FromDouble(1.0);
+  }
+  return PyFloat_FromDouble(self->params.opacity);
+}
+
+static PyObject* get_color(PyObject* self_in, void* closure) {
+  (void)closure;
+  CompositorObject* self = (CompositorObject*)self_in;
+  if ((NULL == self->base) || !self->params.has_color) {
+    Py_INCREF(Py_None);
+    return Py_None;
+  }
+  return PyLong_FromLong(self->params.color);
+}
+
+static PyObject* get_mask(PyObject* self_in, void* closure) {
+  (void)closure;
+  CompositorObject* self = (CompositorObject*)self_in;
+  if (NULL == self->base) {
+    return PyLong_FromUnsignedLong((unsigned int)-1);
+  }
+  return PyLong_FromUnsignedLong((unsigned int)self->params.mask);
+}
+
+// methods
+//////////
+
+static void tp_dealloc(PyObject* self_in) {
+  CompositorObject* self = (CompositorObject*)self_in;
+  Py_XDECREF(self->base);
+  Py_TYPE(self)->tp_free(self);
+}
+
+static int tp_init(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  CompositorObject* self = (CompositorObject*)self_in;
+  CompositorObject* base;
+  PyObject* color_obj = Py_None;
+  unsigned int mask = (unsigned int)-1;
+  compositor_params_t params = {
+      .opacity = 1.0,
+  };
+  char* keywords[] = {
+      "compositor",
+      "opacity",
+      "color",
+      "mask",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!|$dOI", keywords, &CompositorType, &base,
+          &params.opacity, &color_obj, &mask)) {
+    return -1;
+  }
+  params.mask = (color_t)mask;
+
+  if (0 != Compositor_check(base)) {
+    return -1;
+  }
+  // a compositor may not wrap itself, even through other compositors
+  for (PyObject* wrapped = (PyObject*)base; NULL != wrapped;
+       wrapped = ((CompositorObject*)wrapped)->base) {
+    if (self_in == wrapped) {
+      PyErr_SetString(PyExc_ValueError, "compositor may not wrap itself");
+      return -1;
+    }
+  }
+
+  if (!isfinite(params.opacity) || (params.opacity < 0.0)) {
+    PyErr_SetString(
+        PyExc_ValueError, "opacity must be finite and not negative");
+    return -1;
+  }
+  if (Py_None != color_obj) {
+    params.color = PyLong_AsLong(color_obj);
+    if (PyErr_Occurred()) {
+      return -1;
+    }
+    params.has_color = true;
+  }
+
+  // wrap the base compositor, which is kept alive for its args
+  params.fn = base->fn;
+  params.args = base->args;
+  Py_INCREF(base);
+  Py_XDECREF(self->base);
+  self->base = (PyObject*)base;
+  self->params = params;
+  self->fn = compositor_parameterized;
+  self->args = &self->params;
+
+  return 0;
+}
+
+static PyGetSetDef tp_getset[] = {
+    {"base", get_base, NULL, "wrapped compositor", NULL},
+    {"opacity", get_opacity, NULL, "scale of the source color", NULL},
+    {"color", get_color, NULL, "constant source color", NULL},
+    {"mask", get_mask, NULL, "bits of the destination which are written",
+     NULL},
+    {NULL},
+};
+
 PyTypeObject CompositorType = {
     PyVarObject_HEAD_INIT(NULL, 0).tp_name = "_sicgl_core.Compositor",
     .tp_doc = PyDoc_STR("sicgl compositor"),
     .tp_basicsize = sizeof(CompositorObject),
     .tp_itemsize = 0,
     .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = PyType_GenericNew,
+    .tp_dealloc = tp_dealloc,
+    .tp_init = tp_init,
+    .tp_getset = tp_getset,
 };
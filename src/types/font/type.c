@@ -0,0 +1,699 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pysicgl/types/font.h"
+
+// limit of the sizes and offsets read from BDF fonts, and of the extent
+// and spacing of packed fonts, which keeps the layout of a glyph well
+// within ext_t
+#define BDF_MAX_EXTENT (32767)
+
+// limit of the extent of a rasterized run, which keeps the pen and the
+// coordinates of its glyphs within ext_t
+#define RUN_MAX_EXTENT (INT32_MAX / 2)
+
+// utilities for C consumers
+////////////////////////////
+
+/**
+ * @brief Forget every cached run.
+ *
+ * @param self
+ */
+static void clear_runs(FontObject* self) {
+  for (size_t idx = 0; idx < FONT_RUN_CACHE_SIZE; idx++) {
+    font_run_t* run = &self->runs[idx];
+    Py_CLEAR(run->text);
+    PyMem_Free(run->coverage);
+    run->coverage = NULL;
+  }
+}
+
+/**
+ * @brief Release the glyphs and cached runs of the font.
+ *
+ * @param self
+ */
+static void reset_font(FontObject* self) {
+  clear_runs(self);
+  PyMem_Free(self->atlas);
+  PyMem_Free(self->glyphs);
+  self->atlas = NULL;
+  self->atlas_size = 0;
+  self->glyphs = NULL;
+  self->num_glyphs = 0;
+  memset(self->direct, 0, sizeof(self->direct));
+  self->fallback = NULL;
+  self->ascent = 0;
+  self->descent = 0;
+}
+
+/**
+ * @brief Append a glyph and room for its coverage to the atlas.
+ *
+ * @param self
+ * @param glyph the glyph, its offset is filled in.
+ * @param capacity in and out, number of glyphs the table can hold.
+ * @return uint8_t* zeroed coverage of the glyph, or NULL when out of memory.
+ */
+static uint8_t* add_glyph(
+    FontObject* self, font_glyph_t glyph, size_t* capacity) {
+  if (self->num_glyphs == *capacity) {
+    size_t grown = (0 == *capacity) ? 128 : 2 * *capacity;
+    font_glyph_t* glyphs =
+        PyMem_Realloc(self->glyphs, grown * sizeof(font_glyph_t));
+    if (NULL == glyphs) {
+      return NULL;
+    }
+    self->glyphs = glyphs;
+    *capacity = grown;
+  }
+  size_t size = (size_t)glyph.width * (size_t)glyph.height;
+  uint8_t* atlas = PyMem_Realloc(self->atlas, self->atlas_size + size + 1);
+  if (NULL == atlas) {
+    return NULL;
+  }
+  self->atlas = atlas;
+  glyph.offset = self->atlas_size;
+  self->atlas_size += size;
+  self->glyphs[self->num_glyphs++] = glyph;
+  memset(&atlas[glyph.offset], 0, size);
+  return &atlas[glyph.offset];
+}
+
+static int compare_glyphs(const void* a, const void* b) {
+  uint32_t first = ((const font_glyph_t*)a)->code;
+  uint32_t second = ((const font_glyph_t*)b)->code;
+  return (first > second) - (first < second);
+}
+
+/**
+ * @brief Sort the glyphs for searching and index the small code points.
+ *
+ * @param self
+ * @param fallback code point drawn in place of missing glyphs, or -1.
+ */
+static void index_glyphs(FontObject* self, long fallback) {
+  qsort(self->glyphs, self->num_glyphs, sizeof(font_glyph_t), compare_glyphs);
+  memset(self->direct, 0, sizeof(self->direct));
+  for (size_t idx = 0; idx < self->num_glyphs; idx++) {
+    uint32_t code = self->glyphs[idx].code;
+    if ((code < FONT_DIRECT_GLYPHS) && (0 == self->direct[code])) {
+      self->direct[code] = (uint32_t)idx + 1;
+    }
+  }
+  self->fallback =
+      (fallback >= 0) ? Font_get_glyph(self, (uint32_t)fallback) : NULL;
+}
+
+/**
+ * @brief Find the glyph for a code point.
+ *
+ * @param self
+ * @param code
+ * @return const font_glyph_t* the glyph, or NULL when the font has none.
+ */
+const font_glyph_t* Font_get_glyph(FontObject* self, uint32_t code) {
+  if (code < FONT_DIRECT_GLYPHS) {
+    uint32_t index = self->direct[code];
+    return (0 == index) ? NULL : &self->glyphs[index - 1];
+  }
+  font_glyph_t key = {.code = code};
+  return bsearch(
+      &key, self->glyphs, self->num_glyphs, sizeof(font_glyph_t),
+      compare_glyphs);
+}
+
+static inline const font_glyph_t* glyph_or_fallback(
+    FontObject* self, uint32_t code) {
+  const font_glyph_t* glyph = Font_get_glyph(self, code);
+  return (NULL == glyph) ? self->fallback : glyph;
+}
+
+/**
+ * @brief Rasterize a string into a cache entry.
+ *
+ * The glyphs are laid out once to find the extent of the run and then
+ * their coverage is copied out of the atlas. Lines are broken at '\n'.
+ *
+ * @param self
+ * @param text a str.
+ * @param run the entry to fill, its previous contents are released.
+ * @return int 0 on success, -ENOMEM when out of memory, -EOVERFLOW when
+ *  the run is larger than RUN_MAX_EXTENT.
+ */
+static int rasterize_run(FontObject* self, PyObject* text, font_run_t* run) {
+  int ret = 0;
+  int kind = PyUnicode_KIND(text);
+  const void* data = PyUnicode_DATA(text);
+  Py_ssize_t length = PyUnicode_GET_LENGTH(text);
+  ext_t line_height = self->ascent + self->descent;
+
+  // lay out the glyphs to find the extent of the run, the sums of many
+  // glyphs may exceed ext_t before the extent is checked
+  int64_t left = 0;
+  int64_t right = 0;
+  int64_t pen = 0;
+  int64_t lines = 1;
+  for (Py_ssize_t idx = 0; idx < length; idx++) {
+    Py_UCS4 code = PyUnicode_READ(kind, data, idx);
+    if ('\n' == code) {
+      pen = 0;
+      lines++;
+      continue;
+    }
+    const font_glyph_t* glyph = glyph_or_fallback(self, code);
+    if (NULL == glyph) {
+      continue;
+    }
+    if (pen + glyph->left < left) {
+      left = pen + glyph->left;
+    }
+    if (pen + glyph->left + glyph->width > right) {
+      right = pen + glyph->left + glyph->width;
+    }
+    pen += glyph->advance;
+    if (pen > right) {
+      right = pen;
+    }
+  }
+
+  if ((left < -RUN_MAX_EXTENT) || (right > RUN_MAX_EXTENT) ||
+      (lines * line_height > RUN_MAX_EXTENT)) {
+    ret = -EOVERFLOW;
+    goto out;
+  }
+
+  size_t width = (size_t)(right - left);
+  size_t height = (size_t)lines * (size_t)line_height;
+  uint8_t* coverage = PyMem_Malloc(width * height + 1);
+  if (NULL == coverage) {
+    ret = -ENOMEM;
+    goto out;
+  }
+  memset(coverage, 0, width * height);
+
+  // copy the coverage of each glyph, clipped to its line
+  pen = 0;
+  ext_t line_top = 0;
+  for (Py_ssize_t idx = 0; idx < length; idx++) {
+    Py_UCS4 code = PyUnicode_READ(kind, data, idx);
+    if ('\n' == code) {
+      pen = 0;
+      line_top += line_height;
+      continue;
+    }
+    const font_glyph_t* glyph = glyph_or_fallback(self, code);
+    if (NULL == glyph) {
+      continue;
+    }
+    const uint8_t* source = &self->atlas[glyph->offset];
+    ext_t u0 = (ext_t)(pen + glyph->left - left);
+    for (ext_t y = 0; y < glyph->height; y++) {
+      ext_t v = glyph->top + y;
+      if ((v < 0) || (v >= line_height)) {
+        continue;
+      }
+      uint8_t* out = &coverage[(size_t)(line_top + v) * width + u0];
+      const uint8_t* in = &source[y * glyph->width];
+      for (ext_t x = 0; x < glyph->width; x++) {
+        if (in[x] > out[x]) {
+          out[x] = in[x];
+        }
+      }
+    }
+    pen += glyph->advance;
+  }
+
+  Py_CLEAR(run->text);
+  PyMem_Free(run->coverage);
+  Py_INCREF(text);
+  run->text = text;
+  run->hash = PyObject_Hash(text);
+  run->coverage = coverage;
+  run->width = (ext_t)width;
+  run->height = (ext_t)height;
+  run->left = (ext_t)left;
+
+out:
+  return ret;
+}
+
+/**
+ * @brief Get the rasterized run of a string, rasterizing it on a miss.
+ *
+ * The least recently used entry is replaced on a miss, so text which is
+ * redrawn every frame is only rasterized once.
+ *
+ * @param self
+ * @param text
+ * @return const font_run_t* the run, or NULL with the Python error
+ *  indicator set.
+ */
+const font_run_t* Font_get_run(FontObject* self, PyObject* text) {
+  if (!PyUnicode_Check(text)) {
+    PyErr_SetString(PyExc_TypeError, "text must be a str");
+    return NULL;
+  }
+  Py_hash_t hash = PyObject_Hash(text);
+  if (-1 == hash) {
+    return NULL;
+  }
+
+  font_run_t* oldest = &self->runs[0];
+  for (size_t idx = 0; idx < FONT_RUN_CACHE_SIZE; idx++) {
+    font_run_t* run = &self->runs[idx];
+    if ((NULL != run->text) && (run->hash == hash) &&
+        ((run->text == text) || (0 == PyUnicode_Compare(run->text, text)))) {
+      run->used = ++self->clock;
+      return run;
+    }
+    if ((NULL == run->text) ||
+        ((NULL != oldest->text) && (run->used < oldest->used))) {
+      oldest = run;
+    }
+  }
+
+  int ret = rasterize_run(self, text, oldest);
+  if (-ENOMEM == ret) {
+    PyErr_NoMemory();
+    return NULL;
+  } else if (0 != ret) {
+    PyErr_SetString(PyExc_ValueError, "text is too large to rasterize");
+    return NULL;
+  }
+  oldest->used = ++self->clock;
+  return oldest;
+}
+
+/**
+ * @brief Parse an integer at the start of a string.
+ *
+ * @param cursor in and out, moved past the integer.
+ * @param value output.
+ * @return int 0 on success, -1 when there is no integer.
+ */
+static int parse_long(const char** cursor, long* value) {
+  char* end;
+  *value = strtol(*cursor, &end, 10);
+  if (end == *cursor) {
+    return -1;
+  }
+  *cursor = end;
+  return 0;
+}
+
+/**
+ * @brief Match a keyword at the start of a line.
+ *
+ * @param cursor in and out, moved past the keyword when it matches.
+ * @param word
+ * @return bool whether the line starts with the keyword.
+ */
+static bool match_keyword(const char** cursor, const char* word) {
+  size_t length = strlen(word);
+  if (0 != strncmp(*cursor, word, length)) {
+    return false;
+  }
+  char next = (*cursor)[length];
+  if ((' ' != next) && ('\t' != next) && ('\n' != next) &&
+      ('\r' != next) && ('\0' != next)) {
+    return false;
+  }
+  *cursor += length;
+  return true;
+}
+
+static inline bool within_extent(long value) {
+  return (value >= -BDF_MAX_EXTENT) && (value <= BDF_MAX_EXTENT);
+}
+
+static inline int hex_digit(char digit) {
+  if ((digit >= '0') && (digit <= '9')) {
+    return digit - '0';
+  } else if ((digit >= 'a') && (digit <= 'f')) {
+    return digit - 'a' + 10;
+  } else if ((digit >= 'A') && (digit <= 'F')) {
+    return digit - 'A' + 10;
+  }
+  return -1;
+}
+
+/**
+ * @brief Load the glyphs of a font in the Glyph Bitmap Distribution Format.
+ *
+ * Only the properties needed for layout are read: the font bounding box,
+ * FONT_ASCENT, FONT_DESCENT and DEFAULT_CHAR, and for each glyph its
+ * ENCODING, DWIDTH, BBX and BITMAP. Unencoded glyphs are skipped. Sizes
+ * and offsets beyond BDF_MAX_EXTENT are rejected, and a bitmap with fewer
+ * rows than its BBX ends at ENDCHAR.
+ *
+ * @param self
+ * @param source the contents of the file, NUL terminated.
+ * @return int 0 on success, -1 with the Python error indicator set.
+ */
+static int load_bdf(FontObject* self, const char* source) {
+  int ret = 0;
+  size_t capacity = 0;
+  long bounds[4] = {0, 0, 0, 0};
+  long ascent = -1;
+  long descent = -1;
+  long fallback = -1;
+
+  // the glyph being read
+  long code = -1;
+  long advance = 0;
+  long box[4] = {0, 0, 0, 0};
+  uint8_t* coverage = NULL;
+  ext_t columns = 0;
+  ext_t rows = 0;
+  ext_t row = 0;
+  bool in_char = false;
+
+  const char* line = source;
+  while ('\0' != *line) {
+    const char* end = strchr(line, '\n');
+    if (NULL == end) {
+      end = line + strlen(line);
+    }
+    const char* cursor = line;
+    while ((' ' == *cursor) || ('\t' == *cursor)) {
+      cursor++;
+    }
+
+    const char* keyword = cursor;
+    if ((NULL != coverage) && (row < rows) &&
+        !match_keyword(&keyword, "ENDCHAR")) {
+      // a row of the bitmap, most significant bit first
+      for (ext_t x = 0; x < columns; x++) {
+        const char* digit = &cursor[x / 4];
+        if ((digit >= end) || (hex_digit(*digit) < 0)) {
+          break;
+        }
+        if (hex_digit(*digit) & (0x8 >> (x % 4))) {
+          coverage[(size_t)row * (size_t)columns + x] = 255;
+        }
+      }
+      row++;
+    } else if (match_keyword(&cursor, "FONTBOUNDINGBOX")) {
+      for (size_t idx = 0; idx < 4; idx++) {
+        if ((0 != parse_long(&cursor, &bounds[idx])) ||
+            !within_extent(bounds[idx])) {
+          goto malformed;
+        }
+      }
+    } else if (match_keyword(&cursor, "FONT_ASCENT")) {
+      if ((0 != parse_long(&cursor, &ascent)) || !within_extent(ascent)) {
+        goto malformed;
+      }
+    } else if (match_keyword(&cursor, "FONT_DESCENT")) {
+      if ((0 != parse_long(&cursor, &descent)) || !within_extent(descent)) {
+        goto malformed;
+      }
+    } else if (match_keyword(&cursor, "DEFAULT_CHAR")) {
+      if (0 != parse_long(&cursor, &fallback)) {
+        goto malformed;
+      }
+    } else if (match_keyword(&cursor, "STARTCHAR")) {
+      in_char = true;
+      code = -1;
+      advance = bounds[0];
+      memcpy(box, bounds, sizeof(box));
+    } else if (in_char && match_keyword(&cursor, "ENCODING")) {
+      if (0 != parse_long(&cursor, &code)) {
+        goto malformed;
+      }
+    } else if (in_char && match_keyword(&cursor, "DWIDTH")) {
+      if ((0 != parse_long(&cursor, &advance)) || !within_extent(advance)) {
+        goto malformed;
+      }
+    } else if (in_char && match_keyword(&cursor, "BBX")) {
+      for (size_t idx = 0; idx < 4; idx++) {
+        if ((0 != parse_long(&cursor, &box[idx])) ||
+            !within_extent(box[idx])) {
+          goto malformed;
+        }
+      }
+    } else if (in_char && match_keyword(&cursor, "BITMAP")) {
+      if ((box[0] < 0) || (box[1] < 0)) {
+        goto malformed;
+      }
+      if ((ascent < 0) || (descent < 0)) {
+        ascent = (ascent < 0) ? bounds[1] + bounds[3] : ascent;
+        descent = (descent < 0) ? -bounds[3] : descent;
+      }
+      columns = (ext_t)box[0];
+      rows = (ext_t)box[1];
+      row = 0;
+      if ((code >= 0) && (code <= 0x10FFFF)) {
+        font_glyph_t glyph = {
+            .code = (uint32_t)code,
+            .width = columns,
+            .height = rows,
+            .left = (ext_t)box[2],
+            .top = (ext_t)(ascent - box[3] - box[1]),
+            .advance = (ext_t)advance,
+        };
+        coverage = add_glyph(self, glyph, &capacity);
+        if (NULL == coverage) {
+          PyErr_NoMemory();
+          ret = -1;
+          goto out;
+        }
+      } else {
+        // unencoded glyphs are read into nothing
+        rows = 0;
+      }
+    } else if (match_keyword(&cursor, "ENDCHAR")) {
+      in_char = false;
+      coverage = NULL;
+      rows = 0;
+    }
+
+    line = ('\0' == *end) ? end : end + 1;
+  }
+
+  if (0 == self->num_glyphs) {
+    goto malformed;
+  }
+  self->ascent = (ext_t)((ascent < 0) ? bounds[1] + bounds[3] : ascent);
+  self->descent = (ext_t)((descent < 0) ? -bounds[3] : descent);
+  index_glyphs(self, fallback);
+  goto out;
+
+malformed:
+  PyErr_SetString(PyExc_ValueError, "malformed BDF font");
+  ret = -1;
+
+out:
+  return ret;
+}
+
+/**
+ * @brief Load a monospace font of packed one bit per pixel glyphs.
+ *
+ * Each glyph is height rows of ceil(width / 8) bytes, most significant bit
+ * first, and glyphs follow one another for consecutive code points.
+ *
+ * @param self
+ * @param data
+ * @param size number of bytes of data.
+ * @param width
+ * @param height
+ * @param first code point of the first glyph.
+ * @param spacing added to the width to advance the pen.
+ * @return int 0 on success, -ENOMEM when out of memory.
+ */
+static int load_packed(
+    FontObject* self, const uint8_t* data, size_t size, ext_t width,
+    ext_t height, uint32_t first, ext_t spacing) {
+  size_t capacity = 0;
+  size_t stride = ((size_t)width + 7) / 8;
+  size_t glyph_size = stride * (size_t)height;
+  size_t count = size / glyph_size;
+  for (size_t idx = 0; idx < count; idx++) {
+    font_glyph_t glyph = {
+        .code = first + (uint32_t)idx,
+        .width = width,
+        .height = height,
+        .left = 0,
+        .top = 0,
+        .advance = width + spacing,
+    };
+    uint8_t* coverage = add_glyph(self, glyph, &capacity);
+    if (NULL == coverage) {
+      return -ENOMEM;
+    }
+    const uint8_t* bits = &data[idx * glyph_size];
+    for (ext_t y = 0; y < height; y++) {
+      for (ext_t x = 0; x < width; x++) {
+        if (bits[y * stride + x / 8] & (0x80 >> (x % 8))) {
+          coverage[y * width + x] = 255;
+        }
+      }
+    }
+  }
+  self->ascent = height;
+  self->descent = 0;
+  index_glyphs(self, -1);
+  return 0;
+}
+
+// getset
+/////////
+
+static PyObject* get_ascent(PyObject* self_in, void* closure) {
+  (void)closure;
+  return PyLong_FromLong(((FontObject*)self_in)->ascent);
+}
+
+static PyObject* get_descent(PyObject* self_in, void* closure) {
+  (void)closure;
+  return PyLong_FromLong(((FontObject*)self_in)->descent);
+}
+
+static PyObject* get_line_height(PyObject* self_in, void* closure) {
+  (void)closure;
+  FontObject* self = (FontObject*)self_in;
+  return PyLong_FromLong(self->ascent + self->descent);
+}
+
+static PyObject* get_glyphs(PyObject* self_in, void* closure) {
+  (void)closure;
+  return PyLong_FromSize_t(((FontObject*)self_in)->num_glyphs);
+}
+
+// methods
+//////////
+
+static PyObject* from_bdf(PyObject* cls, PyObject* source_obj) {
+  const char* source;
+  if (PyUnicode_Check(source_obj)) {
+    source = PyUnicode_AsUTF8(source_obj);
+  } else if (PyBytes_Check(source_obj)) {
+    source = PyBytes_AsString(source_obj);
+  } else {
+    PyErr_SetString(PyExc_TypeError, "source must be str or bytes");
+    return NULL;
+  }
+  if (NULL == source) {
+    return NULL;
+  }
+
+  FontObject* self = (FontObject*)PyObject_CallNoArgs(cls);
+  if (NULL == self) {
+    return NULL;
+  }
+  if (0 != load_bdf(self, source)) {
+    Py_DECREF(self);
+    return NULL;
+  }
+
+  return (PyObject*)self;
+}
+
+static PyObject* measure(PyObject* self_in, PyObject* text) {
+  const font_run_t* run = Font_get_run((FontObject*)self_in, text);
+  if (NULL == run) {
+    return NULL;
+  }
+  return Py_BuildValue("(ii)", run->width + run->left, run->height);
+}
+
+static PyObject* clear_cache(PyObject* self_in, PyObject* args) {
+  (void)args;
+  clear_runs((FontObject*)self_in);
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static void tp_dealloc(PyObject* self_in) {
+  FontObject* self = (FontObject*)self_in;
+  reset_font(self);
+  Py_TYPE(self)->tp_free(self);
+}
+
+static int tp_init(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  FontObject* self = (FontObject*)self_in;
+  Py_buffer data = {.obj = NULL};
+  ext_t width = 0;
+  ext_t height = 0;
+  unsigned int first = ' ';
+  int spacing = 0;
+  char* keywords[] = {
+      "data",
+      "extent",
+      "first",
+      "spacing",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "|y*(ii)Ii", keywords, &data, &width, &height, &first,
+          &spacing)) {
+    return -1;
+  }
+
+  reset_font(self);
+  if (NULL == data.obj) {
+    // an empty font, glyphs are loaded by the class methods
+    return 0;
+  }
+
+  int ret = 0;
+  if ((width <= 0) || (height <= 0)) {
+    PyErr_SetString(PyExc_ValueError, "extent must be positive");
+    ret = -1;
+  } else if (
+      !within_extent(width) || !within_extent(height) ||
+      !within_extent(spacing)) {
+    PyErr_SetString(PyExc_ValueError, "extent or spacing is too large");
+    ret = -1;
+  } else if (0 != load_packed(
+                      self, data.buf, (size_t)data.len, width, height, first,
+                      spacing)) {
+    PyErr_NoMemory();
+    ret = -1;
+  }
+  PyBuffer_Release(&data);
+  return ret;
+}
+
+static PyMethodDef tp_methods[] = {
+    {"from_bdf", (PyCFunction)from_bdf, METH_O | METH_CLASS,
+     "load a font in the Glyph Bitmap Distribution Format"},
+    {"measure", (PyCFunction)measure, METH_O,
+     "return the (width, height) of a string drawn with the font"},
+    {"clear_cache", (PyCFunction)clear_cache, METH_NOARGS,
+     "forget the rasterized strings kept by the font"},
+    {NULL},
+};
+
+static PyGetSetDef tp_getset[] = {
+    {"ascent", get_ascent, NULL,
+     "pixels from the top of a line to its baseline", NULL},
+    {"descent", get_descent, NULL,
+     "pixels from the baseline to the bottom of a line", NULL},
+    {"line_height", get_line_height, NULL, "pixels between lines of text",
+     NULL},
+    {"glyphs", get_glyphs, NULL, "number of glyphs in the font", NULL},
+    {NULL},
+};
+
+PyTypeObject FontType = {
+    PyVarObject_HEAD_INIT(NULL, 0).tp_name = "_sicgl_core.Font",
+    .tp_doc = PyDoc_STR("bitmap font with a glyph atlas and run cache"),
+    .tp_basicsize = sizeof(FontObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = PyType_GenericNew,
+    .tp_dealloc = tp_dealloc,
+    .tp_init = tp_init,
+    .tp_getset = tp_getset,
+    .tp_methods = tp_methods,
+};
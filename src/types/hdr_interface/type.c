@@ -0,0 +1,591 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <string.h>
+
+#include "pysicgl/types/hdr_interface.h"
+#include "pysicgl/types/interface.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// floats per pixel
+#define HDR_CHANNELS (4)
+
+// utilities for C consumers
+////////////////////////////
+
+/**
+ * @brief Convert a row of colors to floats with one at full scale.
+ *
+ * @param colors
+ * @param count number of pixels.
+ * @param out output row, HDR_CHANNELS floats per pixel.
+ */
+static void colors_to_floats(
+    const color_t* colors, size_t count, float* out) {
+  const float unit = 1.0f / 255.0f;
+  for (size_t idx = 0; idx < count; idx++) {
+    color_t color = colors[idx];
+    out[HDR_CHANNELS * idx + 0] = (float)color_channel_red(color) * unit;
+    out[HDR_CHANNELS * idx + 1] = (float)color_channel_green(color) * unit;
+    out[HDR_CHANNELS * idx + 2] = (float)color_channel_blue(color) * unit;
+    out[HDR_CHANNELS * idx + 3] = (float)color_channel_alpha(color) * unit;
+  }
+}
+
+/**
+ * @brief Combine a row of source pixels into a row of the interface.
+ *
+ * The mode is chosen once per row so that each loop is a straight run of
+ * float arithmetic the compiler can vectorize. The alpha of the source is
+ * scaled before it weights the color.
+ *
+ * @param destination
+ * @param source
+ * @param count number of pixels.
+ * @param mode
+ * @param scale
+ */
+static void combine_row(
+    float* destination, const float* source, size_t count, hdr_mode_t mode,
+    float scale) {
+  switch (mode) {
+    case HDR_MODE_ADD:
+      for (size_t idx = 0; idx < count; idx++) {
+        float* d = &destination[HDR_CHANNELS * idx];
+        const float* s = &source[HDR_CHANNELS * idx];
+        float alpha = s[3] * scale;
+        d[0] += s[0] * alpha;
+        d[1] += s[1] * alpha;
+        d[2] += s[2] * alpha;
+        d[3] += alpha * (1.0f - d[3]);
+      }
+      break;
+
+    case HDR_MODE_OVER:
+      for (size_t idx = 0; idx < count; idx++) {
+        float* d = &destination[HDR_CHANNELS * idx];
+        const float* s = &source[HDR_CHANNELS * idx];
+        float alpha = s[3] * scale;
+        alpha = (alpha > 1.0f) ? 1.0f : alpha;
+        float remaining = 1.0f - alpha;
+        d[0] = s[0] * alpha + d[0] * remaining;
+        d[1] = s[1] * alpha + d[1] * remaining;
+        d[2] = s[2] * alpha + d[2] * remaining;
+        d[3] = alpha + d[3] * remaining;
+      }
+      break;
+
+    case HDR_MODE_MULTIPLY:
+      for (size_t idx = 0; idx < count; idx++) {
+        float* d = &destination[HDR_CHANNELS * idx];
+        const float* s = &source[HDR_CHANNELS * idx];
+        float alpha = s[3] * scale;
+        d[0] *= 1.0f + (s[0] - 1.0f) * alpha;
+        d[1] *= 1.0f + (s[1] - 1.0f) * alpha;
+        d[2] *= 1.0f + (s[2] - 1.0f) * alpha;
+      }
+      break;
+
+    case HDR_MODE_MAX:
+      for (size_t idx = 0; idx < count; idx++) {
+        float* d = &destination[HDR_CHANNELS * idx];
+        const float* s = &source[HDR_CHANNELS * idx];
+        float alpha = s[3] * scale;
+        for (size_t channel = 0; channel < 3; channel++) {
+          float value = s[channel] * alpha;
+          d[channel] = (value > d[channel]) ? value : d[channel];
+        }
+        d[3] = (alpha > d[3]) ? alpha : d[3];
+      }
+      break;
+  }
+}
+
+/**
+ * @brief Quantize a row of floats to colors.
+ *
+ * The color channels are multiplied by the exposure and tone mapped, then
+ * every channel is clamped to [0, 1] and rounded to 8 bits. With SSE2 the
+ * four channels of a pixel are processed together.
+ *
+ * @param source
+ * @param count number of pixels.
+ * @param exposure
+ * @param tone_map
+ * @param out output row.
+ */
+static void quantize_row(
+    const float* source, size_t count, float exposure,
+    hdr_tone_map_t tone_map, color_t* out) {
+#if defined(__SSE2__)
+  const __m128 gain = _mm_setr_ps(exposure, exposure, exposure, 1.0f);
+  const __m128 rgb = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 full = _mm_set1_ps(255.0f);
+  const __m128 half = _mm_set1_ps(0.5f);
+  for (size_t idx = 0; idx < count; idx++) {
+    __m128 pixel = _mm_mul_ps(_mm_loadu_ps(&source[HDR_CHANNELS * idx]), gain);
+    if (HDR_TONE_MAP_REINHARD == tone_map) {
+      // alpha is divided by one
+      pixel = _mm_div_ps(pixel, _mm_add_ps(one, _mm_and_ps(pixel, rgb)));
+    }
+    pixel = _mm_min_ps(_mm_max_ps(pixel, zero), one);
+    __m128i channels =
+        _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(pixel, full), half));
+    int32_t lanes[HDR_CHANNELS];
+    _mm_storeu_si128((__m128i*)lanes, channels);
+    out[idx] = color_from_channels(lanes[0], lanes[1], lanes[2], lanes[3]);
+  }
+#else
+  for (size_t idx = 0; idx < count; idx++) {
+    const float* s = &source[HDR_CHANNELS * idx];
+    color_t channels[HDR_CHANNELS];
+    for (size_t channel = 0; channel < HDR_CHANNELS; channel++) {
+      float value = s[channel];
+      if (channel < 3) {
+        value *= exposure;
+        if (HDR_TONE_MAP_REINHARD == tone_map) {
+          value = value / (1.0f + value);
+        }
+      }
+      value = (value < 0.0f) ? 0.0f : (value > 1.0f) ? 1.0f : value;
+      channels[channel] = (color_t)(value * 255.0f + 0.5f);
+    }
+    out[idx] =
+        color_from_channels(channels[0], channels[1], channels[2], channels[3]);
+  }
+#endif
+}
+
+/**
+ * @brief Find the overlap of two screens in global coordinates.
+ *
+ * @return int 1 when they overlap, 0 otherwise.
+ */
+static int overlap(
+    screen_t* a, screen_t* b, ext_t* u0, ext_t* v0, ext_t* u1, ext_t* v1) {
+  *u0 = (a->_gu0 > b->_gu0) ? a->_gu0 : b->_gu0;
+  *v0 = (a->_gv0 > b->_gv0) ? a->_gv0 : b->_gv0;
+  *u1 = (a->_gu1 < b->_gu1) ? a->_gu1 : b->_gu1;
+  *v1 = (a->_gv1 < b->_gv1) ? a->_gv1 : b->_gv1;
+  return ((*u0 <= *u1) && (*v0 <= *v1)) ? 1 : 0;
+}
+
+/**
+ * @brief Check that the interface is initialized and covers its screen.
+ *
+ * The screen may be changed at any time, so this is checked on each use.
+ *
+ * @param self
+ * @return int 0 on success, -1 with the Python error indicator set.
+ */
+static int check_memory(HDRInterfaceObject* self) {
+  if ((NULL == self->screen) || (NULL == self->storage)) {
+    PyErr_SetString(PyExc_ValueError, "HDR interface is not initialized");
+    return -1;
+  }
+  screen_t* screen = self->screen->screen;
+  if ((size_t)screen->width * (size_t)screen->height > self->length) {
+    PyErr_SetString(PyExc_ValueError, "HDR memory is too small");
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Hold the memory for use without the interpreter lock.
+ *
+ * Another thread may initialize the interface again or change its screen,
+ * so the storage is referenced and the screen is copied.
+ *
+ * @param self
+ * @param hold output, released with HDRInterface_release.
+ * @return int 0 on success, -1 with the Python error indicator set.
+ */
+int HDRInterface_hold(HDRInterfaceObject* self, hdr_hold_t* hold) {
+  if (0 != check_memory(self)) {
+    return -1;
+  }
+  Py_INCREF(self->storage);
+  hold->storage = self->storage;
+  hold->memory = self->memory;
+  hold->length = self->length;
+  hold->screen = *self->screen->screen;
+  return 0;
+}
+
+/**
+ * @brief Release a hold on an interface.
+ *
+ * @param hold
+ */
+void HDRInterface_release(hdr_hold_t* hold) { Py_DECREF(hold->storage); }
+
+/**
+ * @brief Combine a source into the interface.
+ *
+ * Both screens are placed in global coordinates and output is clipped to
+ * the interface. Exactly one of the source pixel pointers is given.
+ *
+ * The interpreter lock is released while combining. The interface is held
+ * for the call, the source must stay valid until this returns.
+ *
+ * @param self
+ * @param source_screen
+ * @param source_colors pixels of a regular interface, or NULL.
+ * @param source_floats pixels of a high dynamic range interface, or NULL.
+ * @param mode
+ * @param scale multiplies the alpha of the source.
+ * @return int 0 on success, -1 with the Python error indicator set.
+ */
+int HDRInterface_compose(
+    HDRInterfaceObject* self, screen_t* source_screen,
+    const color_t* source_colors, const float* source_floats, hdr_mode_t mode,
+    float scale) {
+  int ret = 0;
+  float* row = NULL;
+  hdr_hold_t hold;
+  if (0 != HDRInterface_hold(self, &hold)) {
+    return -1;
+  }
+  screen_t* screen = &hold.screen;
+  ext_t u0, v0, u1, v1;
+  if (0 == overlap(screen, source_screen, &u0, &v0, &u1, &v1)) {
+    goto out;
+  }
+
+  // colors are converted one row at a time
+  size_t count = (size_t)(u1 - u0 + 1);
+  if (NULL != source_colors) {
+    row = PyMem_Malloc((count + 1) * HDR_CHANNELS * sizeof(float));
+    if (NULL == row) {
+      PyErr_NoMemory();
+      ret = -1;
+      goto out;
+    }
+  }
+
+  Py_BEGIN_ALLOW_THREADS;
+  for (ext_t v = v0; v <= v1; v++) {
+    size_t source_offset =
+        (size_t)(v - source_screen->_gv0) * (size_t)source_screen->width +
+        (size_t)(u0 - source_screen->_gu0);
+    float* destination =
+        &hold.memory
+             [HDR_CHANNELS *
+              ((size_t)(v - screen->_gv0) * (size_t)screen->width +
+               (size_t)(u0 - screen->_gu0))];
+    const float* source;
+    if (NULL != source_colors) {
+      colors_to_floats(&source_colors[source_offset], count, row);
+      source = row;
+    } else {
+      source = &source_floats[HDR_CHANNELS * source_offset];
+    }
+    combine_row(destination, source, count, mode, scale);
+  }
+  Py_END_ALLOW_THREADS;
+
+out:
+  PyMem_Free(row);
+  HDRInterface_release(&hold);
+  return ret;
+}
+
+/**
+ * @brief Quantize the interface into a regular interface.
+ *
+ * The interpreter lock is released while quantizing. The interface is held
+ * for the call, the destination must stay valid until this returns, see
+ * Interface_hold.
+ *
+ * @param self
+ * @param interface destination, clipped in global coordinates.
+ * @param exposure multiplies the color channels before tone mapping.
+ * @param tone_map
+ * @return int 0 on success, -1 with the Python error indicator set.
+ */
+int HDRInterface_tone_map(
+    HDRInterfaceObject* self, interface_t* interface, float exposure,
+    hdr_tone_map_t tone_map) {
+  if (0 != Interface_check(interface)) {
+    return -1;
+  }
+  hdr_hold_t hold;
+  if (0 != HDRInterface_hold(self, &hold)) {
+    return -1;
+  }
+  screen_t* destination = interface->screen;
+  screen_t* screen = &hold.screen;
+  ext_t u0, v0, u1, v1;
+  if (0 == overlap(screen, destination, &u0, &v0, &u1, &v1)) {
+    HDRInterface_release(&hold);
+    return 0;
+  }
+
+  size_t count = (size_t)(u1 - u0 + 1);
+  Py_BEGIN_ALLOW_THREADS;
+  for (ext_t v = v0; v <= v1; v++) {
+    const float* source =
+        &hold.memory
+             [HDR_CHANNELS *
+              ((size_t)(v - screen->_gv0) * (size_t)screen->width +
+               (size_t)(u0 - screen->_gu0))];
+    color_t* out =
+        &interface->memory
+             [(v - destination->_gv0) * destination->width +
+              (u0 - destination->_gu0)];
+    quantize_row(source, count, exposure, tone_map, out);
+  }
+  Py_END_ALLOW_THREADS;
+
+  HDRInterface_release(&hold);
+  return 0;
+}
+
+// getset
+/////////
+
+static PyObject* get_screen(PyObject* self_in, void* closure) {
+  (void)closure;
+  HDRInterfaceObject* self = (HDRInterfaceObject*)self_in;
+  PyObject* screen =
+      (NULL == self->screen) ? Py_None : (PyObject*)self->screen;
+  Py_INCREF(screen);
+  return screen;
+}
+
+// methods
+//////////
+
+static PyObject* clear(PyObject* self_in, PyObject* args) {
+  HDRInterfaceObject* self = (HDRInterfaceObject*)self_in;
+  float color[HDR_CHANNELS] = {0.0f, 0.0f, 0.0f, 0.0f};
+  if (!PyArg_ParseTuple(
+          args, "|(ffff)", &color[0], &color[1], &color[2], &color[3])) {
+    return NULL;
+  }
+  if (0 != check_memory(self)) {
+    return NULL;
+  }
+
+  for (size_t idx = 0; idx < self->length; idx++) {
+    memcpy(&self->memory[HDR_CHANNELS * idx], color, sizeof(color));
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static PyObject* get_pixel(PyObject* self_in, PyObject* args) {
+  HDRInterfaceObject* self = (HDRInterfaceObject*)self_in;
+  ext_t u, v;
+  if (!PyArg_ParseTuple(args, "(ii)", &u, &v)) {
+    return NULL;
+  }
+  if (0 != check_memory(self)) {
+    return NULL;
+  }
+
+  screen_t* screen = self->screen->screen;
+  if ((u < 0) || (u >= screen->width) || (v < 0) || (v >= screen->height)) {
+    PyErr_SetString(PyExc_IndexError, "coordinates out of range");
+    return NULL;
+  }
+  const float* pixel =
+      &self->memory
+           [HDR_CHANNELS * ((size_t)v * (size_t)screen->width + (size_t)u)];
+  return Py_BuildValue(
+      "(dddd)", (double)pixel[0], (double)pixel[1], (double)pixel[2],
+      (double)pixel[3]);
+}
+
+static PyObject* compose(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  HDRInterfaceObject* self = (HDRInterfaceObject*)self_in;
+  PyObject* source_obj;
+  int mode = HDR_MODE_ADD;
+  float scale = 1.0f;
+  char* keywords[] = {
+      "source",
+      "mode",
+      "scale",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O|if", keywords, &source_obj, &mode, &scale)) {
+    return NULL;
+  }
+  if ((mode < HDR_MODE_ADD) || (mode > HDR_MODE_MAX)) {
+    PyErr_SetString(PyExc_ValueError, "unknown mode");
+    return NULL;
+  }
+
+  int ret = 0;
+  if (PyObject_TypeCheck(source_obj, &InterfaceType)) {
+    interface_hold_t hold;
+    if (0 != Interface_hold((InterfaceObject*)source_obj, &hold)) {
+      return NULL;
+    }
+    ret = HDRInterface_compose(
+        self, &hold.screen, hold.interface.memory, NULL, (hdr_mode_t)mode,
+        scale);
+    Interface_release(&hold);
+  } else if (PyObject_TypeCheck(source_obj, &HDRInterfaceType)) {
+    hdr_hold_t hold;
+    if (0 != HDRInterface_hold((HDRInterfaceObject*)source_obj, &hold)) {
+      return NULL;
+    }
+    ret = HDRInterface_compose(
+        self, &hold.screen, NULL, hold.memory, (hdr_mode_t)mode, scale);
+    HDRInterface_release(&hold);
+  } else {
+    PyErr_SetString(
+        PyExc_TypeError, "source must be an Interface or HDRInterface");
+    return NULL;
+  }
+  if (0 != ret) {
+    return NULL;
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static PyObject* scale(PyObject* self_in, PyObject* args) {
+  HDRInterfaceObject* self = (HDRInterfaceObject*)self_in;
+  float factor;
+  if (!PyArg_ParseTuple(args, "f", &factor)) {
+    return NULL;
+  }
+
+  hdr_hold_t hold;
+  if (0 != HDRInterface_hold(self, &hold)) {
+    return NULL;
+  }
+
+  // scales only the color components, alpha channel is untouched
+  float* memory = hold.memory;
+  size_t length = hold.length;
+  Py_BEGIN_ALLOW_THREADS;
+  for (size_t idx = 0; idx < length; idx++) {
+    memory[HDR_CHANNELS * idx + 0] *= factor;
+    memory[HDR_CHANNELS * idx + 1] *= factor;
+    memory[HDR_CHANNELS * idx + 2] *= factor;
+  }
+  Py_END_ALLOW_THREADS;
+  HDRInterface_release(&hold);
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static PyObject* tone_map(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  HDRInterfaceObject* self = (HDRInterfaceObject*)self_in;
+  InterfaceObject* interface_obj;
+  float exposure = 1.0f;
+  int method = HDR_TONE_MAP_CLAMP;
+  char* keywords[] = {
+      "interface",
+      "exposure",
+      "operator",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!|fi", keywords, &InterfaceType, &interface_obj,
+          &exposure, &method)) {
+    return NULL;
+  }
+  if ((method < HDR_TONE_MAP_CLAMP) || (method > HDR_TONE_MAP_REINHARD)) {
+    PyErr_SetString(PyExc_ValueError, "unknown tone map operator");
+    return NULL;
+  }
+
+  interface_hold_t hold;
+  if (0 != Interface_hold(interface_obj, &hold)) {
+    return NULL;
+  }
+  int ret = HDRInterface_tone_map(
+      self, &hold.interface, exposure, (hdr_tone_map_t)method);
+  Interface_release(&hold);
+  if (0 != ret) {
+    return NULL;
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static void tp_dealloc(PyObject* self_in) {
+  HDRInterfaceObject* self = (HDRInterfaceObject*)self_in;
+  Py_XDECREF(self->screen);
+  Py_XDECREF(self->storage);
+  Py_TYPE(self)->tp_free(self);
+}
+
+static int tp_init(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  HDRInterfaceObject* self = (HDRInterfaceObject*)self_in;
+  ScreenObject* screen_obj;
+  char* keywords[] = {
+      "screen",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!", keywords, &ScreenType, &screen_obj)) {
+    return -1;
+  }
+
+  screen_t* screen = screen_obj->screen;
+  size_t length = (size_t)screen->width * (size_t)screen->height;
+  size_t size = (length + 1) * HDR_CHANNELS * sizeof(float);
+  PyObject* storage = PyByteArray_FromStringAndSize(NULL, (Py_ssize_t)size);
+  if (NULL == storage) {
+    return -1;
+  }
+  float* memory = (float*)PyByteArray_AS_STRING(storage);
+  memset(memory, 0, size);
+
+  Py_XSETREF(self->storage, storage);
+  self->memory = memory;
+  self->length = length;
+  Py_INCREF(screen_obj);
+  Py_XSETREF(self->screen, screen_obj);
+
+  return 0;
+}
+
+static PyMethodDef tp_methods[] = {
+    {"clear", (PyCFunction)clear, METH_VARARGS,
+     "set every pixel to (r, g, b, a), zero by default"},
+    {"get_pixel", (PyCFunction)get_pixel, METH_VARARGS,
+     "get the (r, g, b, a) floats of the pixel at (u, v)"},
+    {"compose", (PyCFunction)compose, METH_VARARGS | METH_KEYWORDS,
+     "combine an Interface or HDRInterface into the interface"},
+    {"scale", (PyCFunction)scale, METH_VARARGS,
+     "multiply the color channels of every pixel"},
+    {"tone_map", (PyCFunction)tone_map, METH_VARARGS | METH_KEYWORDS,
+     "quantize the interface into a regular interface"},
+    {NULL},
+};
+
+static PyGetSetDef tp_getset[] = {
+    {"screen", get_screen, NULL, "screen", NULL},
+    {NULL},
+};
+
+PyTypeObject HDRInterfaceType = {
+    PyVarObject_HEAD_INIT(NULL, 0).tp_name = "_sicgl_core.HDRInterface",
+    .tp_doc = PyDoc_STR("interface of float channels for accumulation"),
+    .tp_basicsize = sizeof(HDRInterfaceObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = PyType_GenericNew,
+    .tp_dealloc = tp_dealloc,
+    .tp_init = tp_init,
+    .tp_getset = tp_getset,
+    .tp_methods = tp_methods,
+};
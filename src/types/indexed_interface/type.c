@@ -0,0 +1,486 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <string.h>
+
+#include "pysicgl/types/indexed_interface.h"
+#include "pysicgl/types/interface.h"
+
+// utilities for C consumers
+////////////////////////////
+
+/**
+ * @brief Copy the palette into a table covering every index.
+ *
+ * Indices past the end of the palette select transparent black.
+ *
+ * @param self
+ * @param table output, INDEXED_PALETTE_SIZE colors.
+ */
+static void fill_palette_table(IndexedInterfaceObject* self, color_t* table) {
+  color_sequence_t* sequence = &self->palette->sequence;
+  size_t length = (sequence->length < INDEXED_PALETTE_SIZE)
+                      ? sequence->length
+                      : INDEXED_PALETTE_SIZE;
+  memcpy(table, sequence->colors, length * sizeof(color_t));
+  memset(
+      &table[length], 0, (INDEXED_PALETTE_SIZE - length) * sizeof(color_t));
+}
+
+/**
+ * @brief Look up the colors of a row of indices.
+ *
+ * @param table palette table.
+ * @param indices
+ * @param count number of pixels.
+ * @param out output row.
+ */
+static inline void expand_row(
+    const color_t* table, const uint8_t* indices, size_t count,
+    color_t* out) {
+  size_t idx = 0;
+  for (; idx + 4 <= count; idx += 4) {
+    out[idx + 0] = table[indices[idx + 0]];
+    out[idx + 1] = table[indices[idx + 1]];
+    out[idx + 2] = table[indices[idx + 2]];
+    out[idx + 3] = table[indices[idx + 3]];
+  }
+  for (; idx < count; idx++) {
+    out[idx] = table[indices[idx]];
+  }
+}
+
+/**
+ * @brief Check that the memory covers the screen.
+ *
+ * @param self
+ * @return int 0 on success, -1 with the Python error indicator set.
+ */
+static int check_memory(IndexedInterfaceObject* self) {
+  if ((NULL == self->screen) || (NULL == self->palette)) {
+    PyErr_SetString(PyExc_ValueError, "indexed interface is not initialized");
+    return -1;
+  }
+  screen_t* screen = self->screen->screen;
+  if ((NULL == self->memory) ||
+      ((size_t)screen->width * (size_t)screen->height > self->length)) {
+    PyErr_SetString(PyExc_ValueError, "indexed memory is too small");
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Hold the indices for use without the interpreter lock.
+ *
+ * Another thread may initialize the interface again or change its screen,
+ * so the index memory is referenced and the screen is copied.
+ *
+ * @param self
+ * @param buffer output, released by the caller with PyBuffer_Release.
+ * @param screen output copy of the screen.
+ * @return int 0 on success, -1 with the Python error indicator set.
+ */
+static int hold_memory(
+    IndexedInterfaceObject* self, Py_buffer* buffer, screen_t* screen) {
+  if (0 != check_memory(self)) {
+    return -1;
+  }
+  if (0 != PyObject_GetBuffer(
+               self->memory_buffer.obj, buffer, PyBUF_SIMPLE)) {
+    return -1;
+  }
+  *screen = *self->screen->screen;
+  return 0;
+}
+
+/**
+ * @brief Expand the indices into true color pixels of an interface.
+ *
+ * Both screens are placed in global coordinates and output is clipped to
+ * the destination interface.
+ *
+ * The interpreter lock is released while expanding. The indices are held
+ * for the call, the destination must stay valid until this returns, see
+ * Interface_hold.
+ *
+ * @param self
+ * @param interface destination interface.
+ * @param compositor compositor, or NULL to copy the expanded pixels.
+ * @return int 0 on success, -1 with the Python error indicator set.
+ */
+int IndexedInterface_expand(
+    IndexedInterfaceObject* self, interface_t* interface,
+    CompositorObject* compositor) {
+  int ret = 0;
+  color_t* row = NULL;
+  if (0 != Interface_check(interface)) {
+    return -1;
+  }
+  screen_t* screen = interface->screen;
+  Py_buffer buffer;
+  screen_t source_screen;
+  if (0 != hold_memory(self, &buffer, &source_screen)) {
+    return -1;
+  }
+
+  screen_t* source = &source_screen;
+  const uint8_t* memory = buffer.buf;
+  ext_t u0 = (source->_gu0 > screen->_gu0) ? source->_gu0 : screen->_gu0;
+  ext_t v0 = (source->_gv0 > screen->_gv0) ? source->_gv0 : screen->_gv0;
+  ext_t u1 = (source->_gu1 < screen->_gu1) ? source->_gu1 : screen->_gu1;
+  ext_t v1 = (source->_gv1 < screen->_gv1) ? source->_gv1 : screen->_gv1;
+  if ((u0 > u1) || (v0 > v1)) {
+    goto out;
+  }
+
+  color_t table[INDEXED_PALETTE_SIZE];
+  fill_palette_table(self, table);
+  size_t count = (size_t)(u1 - u0 + 1);
+  if (NULL != compositor) {
+    row = PyMem_Malloc(count * sizeof(color_t));
+    if (NULL == row) {
+      PyErr_NoMemory();
+      ret = -1;
+      goto out;
+    }
+  }
+
+  Py_BEGIN_ALLOW_THREADS;
+  for (ext_t v = v0; v <= v1; v++) {
+    const uint8_t* indices =
+        &memory[(v - source->_gv0) * source->width + (u0 - source->_gu0)];
+    color_t* output = &interface->memory
+                           [(v - screen->_gv0) * screen->width +
+                            (u0 - screen->_gu0)];
+    if (NULL == compositor) {
+      expand_row(table, indices, count, output);
+    } else {
+      expand_row(table, indices, count, row);
+      compositor->fn(row, output, count, compositor->args);
+    }
+  }
+  Py_END_ALLOW_THREADS;
+
+out:
+  PyMem_Free(row);
+  PyBuffer_Release(&buffer);
+  return ret;
+}
+
+// getset
+/////////
+
+static PyObject* get_screen(PyObject* self_in, void* closure) {
+  (void)closure;
+  IndexedInterfaceObject* self = (IndexedInterfaceObject*)self_in;
+  PyObject* screen =
+      (NULL == self->screen) ? Py_None : (PyObject*)self->screen;
+  Py_INCREF(screen);
+  return screen;
+}
+
+static PyObject* get_memory(PyObject* self_in, void* closure) {
+  (void)closure;
+  IndexedInterfaceObject* self = (IndexedInterfaceObject*)self_in;
+  return PyMemoryView_FromBuffer(&self->memory_buffer);
+}
+
+static PyObject* get_palette(PyObject* self_in, void* closure) {
+  (void)closure;
+  IndexedInterfaceObject* self = (IndexedInterfaceObject*)self_in;
+  PyObject* palette =
+      (NULL == self->palette) ? Py_None : (PyObject*)self->palette;
+  Py_INCREF(palette);
+  return palette;
+}
+
+static int set_palette(PyObject* self_in, PyObject* value, void* closure) {
+  (void)closure;
+  IndexedInterfaceObject* self = (IndexedInterfaceObject*)self_in;
+  if ((NULL == value) || !PyObject_TypeCheck(value, &ColorSequenceType)) {
+    PyErr_SetString(PyExc_TypeError, "palette must be a ColorSequence");
+    return -1;
+  }
+  Py_INCREF(value);
+  Py_XSETREF(self->palette, (ColorSequenceObject*)value);
+  return 0;
+}
+
+// methods
+//////////
+
+/**
+ * @brief Check that an index selects one of the palette colors.
+ *
+ * @return int 0 on success, -1 with the Python error indicator set.
+ */
+static int check_index(int index) {
+  if ((index < 0) || (index >= INDEXED_PALETTE_SIZE)) {
+    PyErr_SetString(PyExc_ValueError, "index must be in the range [0, 255]");
+    return -1;
+  }
+  return 0;
+}
+
+static PyObject* fill(PyObject* self_in, PyObject* args) {
+  IndexedInterfaceObject* self = (IndexedInterfaceObject*)self_in;
+  int index;
+  if (!PyArg_ParseTuple(args, "i", &index)) {
+    return NULL;
+  }
+  if ((0 != check_index(index)) || (0 != check_memory(self))) {
+    return NULL;
+  }
+
+  screen_t* screen = self->screen->screen;
+  memset(
+      self->memory, index, (size_t)screen->width * (size_t)screen->height);
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static PyObject* pixel(PyObject* self_in, PyObject* args) {
+  IndexedInterfaceObject* self = (IndexedInterfaceObject*)self_in;
+  int index;
+  ext_t u, v;
+  if (!PyArg_ParseTuple(args, "i(ii)", &index, &u, &v)) {
+    return NULL;
+  }
+  if ((0 != check_index(index)) || (0 != check_memory(self))) {
+    return NULL;
+  }
+
+  screen_t* screen = self->screen->screen;
+  if ((u >= 0) && (u < screen->width) && (v >= 0) && (v < screen->height)) {
+    self->memory[v * screen->width + u] = (uint8_t)index;
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static PyObject* get_pixel(PyObject* self_in, PyObject* args) {
+  IndexedInterfaceObject* self = (IndexedInterfaceObject*)self_in;
+  ext_t u, v;
+  if (!PyArg_ParseTuple(args, "(ii)", &u, &v)) {
+    return NULL;
+  }
+  if (0 != check_memory(self)) {
+    return NULL;
+  }
+
+  screen_t* screen = self->screen->screen;
+  if ((u < 0) || (u >= screen->width) || (v < 0) || (v >= screen->height)) {
+    PyErr_SetString(PyExc_IndexError, "coordinates out of range");
+    return NULL;
+  }
+  return PyLong_FromLong(self->memory[v * screen->width + u]);
+}
+
+static PyObject* rectangle_filled(PyObject* self_in, PyObject* args) {
+  IndexedInterfaceObject* self = (IndexedInterfaceObject*)self_in;
+  int index;
+  ext_t u0, v0, u1, v1;
+  if (!PyArg_ParseTuple(args, "i(ii)(ii)", &index, &u0, &v0, &u1, &v1)) {
+    return NULL;
+  }
+  if ((0 != check_index(index)) || (0 != check_memory(self))) {
+    return NULL;
+  }
+
+  screen_t* screen = self->screen->screen;
+  ext_t swap;
+  if (u0 > u1) {
+    swap = u0, u0 = u1, u1 = swap;
+  }
+  if (v0 > v1) {
+    swap = v0, v0 = v1, v1 = swap;
+  }
+  u0 = (u0 < 0) ? 0 : u0;
+  v0 = (v0 < 0) ? 0 : v0;
+  u1 = (u1 >= screen->width) ? screen->width - 1 : u1;
+  v1 = (v1 >= screen->height) ? screen->height - 1 : v1;
+  for (ext_t v = v0; v <= v1; v++) {
+    if (u0 <= u1) {
+      memset(
+          &self->memory[v * screen->width + u0], index,
+          (size_t)(u1 - u0 + 1));
+    }
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static PyObject* expand(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  IndexedInterfaceObject* self = (IndexedInterfaceObject*)self_in;
+  InterfaceObject* interface_obj;
+  PyObject* compositor_obj = Py_None;
+  char* keywords[] = {
+      "interface",
+      "compositor",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!|O", keywords, &InterfaceType, &interface_obj,
+          &compositor_obj)) {
+    return NULL;
+  }
+
+  CompositorObject* compositor = NULL;
+  if (Py_None != compositor_obj) {
+    if (!PyObject_TypeCheck(compositor_obj, &CompositorType)) {
+      PyErr_SetString(PyExc_TypeError, "compositor must be a Compositor");
+      return NULL;
+    }
+    compositor = (CompositorObject*)compositor_obj;
+    if (0 != Compositor_check(compositor)) {
+      return NULL;
+    }
+  }
+
+  interface_hold_t hold;
+  if (0 != Interface_hold(interface_obj, &hold)) {
+    return NULL;
+  }
+  int ret = IndexedInterface_expand(self, &hold.interface, compositor);
+  Interface_release(&hold);
+  if (0 != ret) {
+    return NULL;
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static PyObject* expand_rgb(PyObject* self_in, PyObject* args) {
+  IndexedInterfaceObject* self = (IndexedInterfaceObject*)self_in;
+  Py_buffer output;
+  if (!PyArg_ParseTuple(args, "w*", &output)) {
+    return NULL;
+  }
+
+  PyObject* result = NULL;
+  Py_buffer buffer;
+  screen_t screen;
+  if (0 != hold_memory(self, &buffer, &screen)) {
+    PyBuffer_Release(&output);
+    return NULL;
+  }
+  size_t pixels = (size_t)screen.width * (size_t)screen.height;
+  if ((size_t)output.len < 3 * pixels) {
+    PyErr_SetString(PyExc_ValueError, "output is too small");
+    goto out;
+  }
+
+  // the table holds the packed bytes of each color
+  uint8_t table[INDEXED_PALETTE_SIZE][3];
+  color_t colors[INDEXED_PALETTE_SIZE];
+  fill_palette_table(self, colors);
+  for (size_t idx = 0; idx < INDEXED_PALETTE_SIZE; idx++) {
+    table[idx][0] = (uint8_t)color_channel_red(colors[idx]);
+    table[idx][1] = (uint8_t)color_channel_green(colors[idx]);
+    table[idx][2] = (uint8_t)color_channel_blue(colors[idx]);
+  }
+
+  const uint8_t* indices = buffer.buf;
+  uint8_t* out = output.buf;
+  Py_BEGIN_ALLOW_THREADS;
+  for (size_t idx = 0; idx < pixels; idx++) {
+    memcpy(&out[3 * idx], table[indices[idx]], 3);
+  }
+  Py_END_ALLOW_THREADS;
+
+  Py_INCREF(Py_None);
+  result = Py_None;
+
+out:
+  PyBuffer_Release(&buffer);
+  PyBuffer_Release(&output);
+  return result;
+}
+
+static void tp_dealloc(PyObject* self_in) {
+  IndexedInterfaceObject* self = (IndexedInterfaceObject*)self_in;
+  if (NULL != self->memory_buffer.obj) {
+    PyBuffer_Release(&self->memory_buffer);
+  }
+  Py_XDECREF(self->screen);
+  Py_XDECREF(self->palette);
+  Py_TYPE(self)->tp_free(self);
+}
+
+static int tp_init(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  IndexedInterfaceObject* self = (IndexedInterfaceObject*)self_in;
+  ScreenObject* screen_obj;
+  PyObject* memory_obj;
+  ColorSequenceObject* palette_obj;
+  char* keywords[] = {
+      "screen",
+      "memory",
+      "palette",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!YO!", keywords, &ScreenType, &screen_obj,
+          &memory_obj, &ColorSequenceType, &palette_obj)) {
+    return -1;
+  }
+
+  Py_buffer buffer;
+  if (0 != PyObject_GetBuffer(memory_obj, &buffer, PyBUF_WRITABLE)) {
+    return -1;
+  }
+  if (NULL != self->memory_buffer.obj) {
+    PyBuffer_Release(&self->memory_buffer);
+  }
+  self->memory_buffer = buffer;
+  self->memory = buffer.buf;
+  self->length = (size_t)buffer.len;
+
+  Py_INCREF(screen_obj);
+  Py_XSETREF(self->screen, screen_obj);
+  Py_INCREF(palette_obj);
+  Py_XSETREF(self->palette, palette_obj);
+
+  return 0;
+}
+
+static PyMethodDef tp_methods[] = {
+    {"fill", (PyCFunction)fill, METH_VARARGS, "set every pixel to an index"},
+    {"pixel", (PyCFunction)pixel, METH_VARARGS,
+     "set the index of the pixel at (u, v)"},
+    {"get_pixel", (PyCFunction)get_pixel, METH_VARARGS,
+     "get the index of the pixel at (u, v)"},
+    {"rectangle_filled", (PyCFunction)rectangle_filled, METH_VARARGS,
+     "set the pixels of a rectangle to an index"},
+    {"expand", (PyCFunction)expand, METH_VARARGS | METH_KEYWORDS,
+     "look up the palette colors of the indices into an interface"},
+    {"expand_rgb", (PyCFunction)expand_rgb, METH_VARARGS,
+     "look up the palette colors of the indices into packed 8-bit RGB"},
+    {NULL},
+};
+
+static PyGetSetDef tp_getset[] = {
+    {"screen", get_screen, NULL, "screen", NULL},
+    {"memory", get_memory, NULL, "index memory", NULL},
+    {"palette", get_palette, set_palette, "colors selected by the indices",
+     NULL},
+    {NULL},
+};
+
+PyTypeObject IndexedInterfaceType = {
+    PyVarObject_HEAD_INIT(NULL, 0).tp_name = "_sicgl_core.IndexedInterface",
+    .tp_doc = PyDoc_STR("interface of 8-bit palette indices"),
+    .tp_basicsize = sizeof(IndexedInterfaceObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = PyType_GenericNew,
+    .tp_dealloc = tp_dealloc,
+    .tp_init = tp_init,
+    .tp_getset = tp_getset,
+    .tp_methods = tp_methods,
+};
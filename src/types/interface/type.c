@@ -17,6 +17,59 @@
 // utilities for C consumers
 ////////////////////////////
 
+/**
+ * @brief Check that an interface has memory for every pixel of its screen.
+ *
+ * @param interface
+ * @return int 0 when valid, -1 with the Python error indicator set.
+ */
+int Interface_check(interface_t* interface) {
+  screen_t* screen = interface->screen;
+  if ((NULL == screen) || (NULL == interface->memory) ||
+      ((size_t)screen->width * (size_t)screen->height > interface->length)) {
+    PyErr_SetString(PyExc_ValueError, "interface memory is too small");
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Hold an interface for use without the interpreter lock.
+ *
+ * Other threads may replace the memory or change the screen of the
+ * interface once the lock is released. The hold exports its own buffer
+ * of the memory, which keeps it alive and fixed in size, and copies the
+ * screen. Drawing through hold->interface is then safe until the hold is
+ * released.
+ *
+ * @param self
+ * @param hold output hold, released with Interface_release.
+ * @return int 0 on success, -1 with the Python error indicator set.
+ */
+int Interface_hold(InterfaceObject* self, interface_hold_t* hold) {
+  if (0 != Interface_check(&self->interface)) {
+    return -1;
+  }
+  if (0 != PyObject_GetBuffer(
+               self->memory_buffer.obj, &hold->buffer, PyBUF_WRITABLE)) {
+    return -1;
+  }
+  hold->screen = *self->interface.screen;
+  hold->interface.screen = &hold->screen;
+  hold->interface.memory = hold->buffer.buf;
+  hold->interface.length = hold->buffer.len / bytes_per_pixel();
+  return 0;
+}
+
+/**
+ * @brief Release a hold on an interface.
+ *
+ * @param hold
+ */
+void Interface_release(interface_hold_t* hold) {
+  PyBuffer_Release(&hold->buffer);
+}
+
 /**
  * @brief Removes the screen object from the interface.
  *
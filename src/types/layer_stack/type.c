@@ -0,0 +1,771 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "pysicgl/types/layer_stack.h"
+#include "pysicgl/utilities/color.h"
+
+// number of pixels of a destination row which are flattened at once, small
+// enough that the span and the matching source spans of a deep stack stay
+// in cache while every layer is composed onto it
+#define LAYER_STACK_TILE_WIDTH (256)
+
+// a visible layer clipped to a region
+typedef struct _active_layer_t {
+  layer_t* layer;
+  color_t* memory;
+  ext_t stride;
+  // global location of the first source pixel
+  ext_t gu, gv;
+  // clipped region in global coordinates
+  layer_region_t region;
+} active_layer_t;
+
+static const layer_region_t empty_region = {0, 0, -1, -1};
+
+static inline bool region_empty(layer_region_t region) {
+  return (region.u0 > region.u1) || (region.v0 > region.v1);
+}
+
+static layer_region_t region_union(layer_region_t a, layer_region_t b) {
+  if (region_empty(a)) {
+    return b;
+  } else if (region_empty(b)) {
+    return a;
+  }
+  return (layer_region_t){
+      .u0 = (a.u0 < b.u0) ? a.u0 : b.u0,
+      .v0 = (a.v0 < b.v0) ? a.v0 : b.v0,
+      .u1 = (a.u1 > b.u1) ? a.u1 : b.u1,
+      .v1 = (a.v1 > b.v1) ? a.v1 : b.v1,
+  };
+}
+
+static layer_region_t region_intersect(layer_region_t a, layer_region_t b) {
+  return (layer_region_t){
+      .u0 = (a.u0 > b.u0) ? a.u0 : b.u0,
+      .v0 = (a.v0 > b.v0) ? a.v0 : b.v0,
+      .u1 = (a.u1 < b.u1) ? a.u1 : b.u1,
+      .v1 = (a.v1 < b.v1) ? a.v1 : b.v1,
+  };
+}
+
+static inline layer_region_t screen_region(screen_t* screen) {
+  return (layer_region_t){
+      screen->_gu0, screen->_gv0, screen->_gu1, screen->_gv1};
+}
+
+/**
+ * @brief Get the global region covered by the pixels of a layer.
+ *
+ * The layer is placed at its screen and is no larger than its pixels.
+ *
+ * @param layer
+ * @return layer_region_t
+ */
+static layer_region_t layer_region(layer_t* layer) {
+  screen_t* source = layer->interface->interface.screen;
+  layer_region_t region = screen_region(layer->screen->screen);
+  if (region.u1 > region.u0 + source->width - 1) {
+    region.u1 = region.u0 + source->width - 1;
+  }
+  if (region.v1 > region.v0 + source->height - 1) {
+    region.v1 = region.v0 + source->height - 1;
+  }
+  return region;
+}
+
+/**
+ * @brief Mark the whole of a layer dirty, including where it was drawn.
+ *
+ * @param layer
+ */
+static void damage_layer(layer_t* layer) {
+  layer->dirty = true;
+  layer->damage = region_union(
+      layer->damage, region_union(layer->drawn, layer_region(layer)));
+}
+
+// utilities for C consumers
+////////////////////////////
+
+/**
+ * @brief Check that a destination may be flattened onto.
+ *
+ * The layers are checked again as well since their interfaces may have
+ * been changed since they were added.
+ *
+ * @param self
+ * @param destination
+ * @return int 0 when valid, -1 with the Python error indicator set.
+ */
+static int check_destination(
+    LayerStackObject* self, interface_t* destination) {
+  if (0 != Interface_check(destination)) {
+    return -1;
+  }
+  for (size_t idx = 0; idx < self->length; idx++) {
+    interface_t* layer = &self->layers[idx].interface->interface;
+    if (0 != Interface_check(layer)) {
+      return -1;
+    }
+    if (layer->memory == destination->memory) {
+      PyErr_SetString(
+          PyExc_ValueError, "a layer may not share memory with destination");
+      return -1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Clip a layer to a region.
+ *
+ * @param layer
+ * @param region
+ * @param active output clipped layer.
+ * @return bool true when the layer contributes to the region.
+ */
+static bool clip_layer(
+    layer_t* layer, layer_region_t region, active_layer_t* active) {
+  if (!layer->visible || (layer->opacity <= 0.0)) {
+    return false;
+  }
+
+  layer_region_t covered = layer_region(layer);
+  active->layer = layer;
+  active->memory = layer->interface->interface.memory;
+  active->stride = layer->interface->interface.screen->width;
+  active->gu = covered.u0;
+  active->gv = covered.v0;
+  active->region = region_intersect(covered, region);
+
+  return !region_empty(active->region);
+}
+
+/**
+ * @brief Compose a range of layers onto a region of pixel memory.
+ *
+ * The region is visited once in spans of at most LAYER_STACK_TILE_WIDTH
+ * pixels and every layer which covers a span is composed onto it before
+ * moving on, so each pixel is read and written once regardless of the
+ * number of layers. Opacity scales the color components of a layer.
+ *
+ * @param self
+ * @param first first layer to compose.
+ * @param last one past the last layer to compose.
+ * @param memory pixel memory laid out as the screen.
+ * @param screen
+ * @param region region to compose, within the screen.
+ * @return int 0 on success, -1 with the Python error indicator set.
+ */
+static int compose_layers(
+    LayerStackObject* self, size_t first, size_t last, color_t* memory,
+    screen_t* screen, layer_region_t region) {
+  int ret = 0;
+  active_layer_t* active = NULL;
+  color_t* scratch = NULL;
+
+  if ((first >= last) || region_empty(region)) {
+    goto out;
+  }
+
+  active = PyMem_Malloc((last - first) * sizeof(active_layer_t));
+  scratch = PyMem_Malloc(LAYER_STACK_TILE_WIDTH * sizeof(color_t));
+  if ((NULL == active) || (NULL == scratch)) {
+    PyErr_NoMemory();
+    ret = -1;
+    goto out;
+  }
+
+  size_t num_active = 0;
+  for (size_t idx = first; idx < last; idx++) {
+    if (clip_layer(&self->layers[idx], region, &active[num_active])) {
+      num_active++;
+    }
+  }
+  if (0 == num_active) {
+    goto out;
+  }
+
+  for (ext_t v = region.v0; v <= region.v1; v++) {
+    color_t* row = &memory[(v - screen->_gv0) * screen->width];
+    for (ext_t u0 = region.u0; u0 <= region.u1;
+         u0 += LAYER_STACK_TILE_WIDTH) {
+      ext_t u1 = u0 + LAYER_STACK_TILE_WIDTH - 1;
+      if (u1 > region.u1) {
+        u1 = region.u1;
+      }
+
+      for (size_t idx = 0; idx < num_active; idx++) {
+        active_layer_t* layer = &active[idx];
+        layer_region_t* covered = &layer->region;
+        if ((v < covered->v0) || (v > covered->v1) || (u1 < covered->u0) ||
+            (u0 > covered->u1)) {
+          continue;
+        }
+
+        ext_t start = (u0 > covered->u0) ? u0 : covered->u0;
+        ext_t end = (u1 < covered->u1) ? u1 : covered->u1;
+        size_t count = end - start + 1;
+        color_t* source =
+            &layer->memory
+                 [(v - layer->gv) * layer->stride + (start - layer->gu)];
+        if (layer->layer->opacity < 1.0) {
+          color_scale_row(scratch, source, count, layer->layer->opacity);
+          source = scratch;
+        }
+
+        CompositorObject* compositor = layer->layer->compositor;
+        compositor->fn(
+            source, &row[start - screen->_gu0], count, compositor->args);
+      }
+    }
+  }
+
+out:
+  PyMem_Free(scratch);
+  PyMem_Free(active);
+  return ret;
+}
+
+/**
+ * @brief Discard the cache used by incremental flattening.
+ *
+ * The next incremental flatten recomposites every layer onto the
+ * destination as it is at that time.
+ *
+ * @param self
+ */
+void LayerStack_invalidate(LayerStackObject* self) {
+  PyMem_Free(self->base);
+  PyMem_Free(self->cache);
+  self->base = NULL;
+  self->cache = NULL;
+  self->cached = 0;
+  self->target = NULL;
+}
+
+/**
+ * @brief Flatten the layers of the stack onto a destination interface.
+ *
+ * Layers are composed in order, bottom first.
+ *
+ * @param self
+ * @param destination
+ * @return int 0 on success, -1 with the Python error indicator set.
+ */
+int LayerStack_flatten(LayerStackObject* self, interface_t* destination) {
+  if (0 != check_destination(self, destination)) {
+    return -1;
+  }
+
+  // the destination no longer holds the result of the last incremental
+  // flatten
+  LayerStack_invalidate(self);
+
+  return compose_layers(
+      self, 0, self->length, destination->memory, destination->screen,
+      screen_region(destination->screen));
+}
+
+/**
+ * @brief Flatten the layers of the stack, recompositing only what changed.
+ *
+ * The destination is assumed to hold the result of the previous
+ * incremental flatten. The composition of the unchanged layers beneath the
+ * first dirty layer is cached, so only the dirty layer and those above it
+ * are composed again and only within the region damaged since the last
+ * flatten. When nothing is dirty the destination is not touched.
+ *
+ * The first incremental flatten onto a destination keeps a copy of it as
+ * the background beneath the layers.
+ *
+ * @param self
+ * @param destination
+ * @return int 0 on success, -1 with the Python error indicator set.
+ */
+int LayerStack_flatten_incremental(
+    LayerStackObject* self, interface_t* destination) {
+  int ret = 0;
+  if (0 != check_destination(self, destination)) {
+    ret = -1;
+    goto out;
+  }
+
+  screen_t* screen = destination->screen;
+  layer_region_t full = screen_region(screen);
+  size_t pixels = (size_t)screen->width * (size_t)screen->height;
+
+  // start over when the destination is not the one which is cached
+  if ((self->target != destination->memory) ||
+      (self->target_screen.width != screen->width) ||
+      (self->target_screen.height != screen->height) ||
+      (self->target_screen._gu0 != screen->_gu0) ||
+      (self->target_screen._gv0 != screen->_gv0)) {
+    LayerStack_invalidate(self);
+    self->base = PyMem_Malloc(pixels * sizeof(color_t));
+    self->cache = PyMem_Malloc(pixels * sizeof(color_t));
+    if ((NULL == self->base) || (NULL == self->cache)) {
+      LayerStack_invalidate(self);
+      PyErr_NoMemory();
+      ret = -1;
+      goto out;
+    }
+    memcpy(self->base, destination->memory, pixels * sizeof(color_t));
+    memcpy(self->cache, self->base, pixels * sizeof(color_t));
+    self->target = destination->memory;
+    self->target_screen = *screen;
+    self->dirty_from = 0;
+    self->damage = full;
+  }
+
+  // find the first layer to recomposite and the region to recomposite
+  size_t first = self->dirty_from;
+  layer_region_t damage = self->damage;
+  for (size_t idx = 0; idx < self->length; idx++) {
+    layer_t* layer = &self->layers[idx];
+    if (layer->dirty) {
+      if (idx < first) {
+        first = idx;
+      }
+      damage = region_union(damage, layer->damage);
+    }
+  }
+  if (first > self->length) {
+    first = self->length;
+  }
+  damage = region_intersect(damage, full);
+
+  if (!region_empty(damage)) {
+    // a cached layer changed, rebuild the cache from the background
+    if (first < self->cached) {
+      memcpy(self->cache, self->base, pixels * sizeof(color_t));
+      self->cached = 0;
+    }
+
+    // extend the cache with the unchanged layers beneath the first dirty one
+    if (first > self->cached) {
+      ret = compose_layers(
+          self, self->cached, first, self->cache, screen, full);
+      if (0 != ret) {
+        LayerStack_invalidate(self);
+        goto out;
+      }
+      self->cached = first;
+    }
+
+    // restore the damaged region and compose the remaining layers onto it
+    size_t count = damage.u1 - damage.u0 + 1;
+    for (ext_t v = damage.v0; v <= damage.v1; v++) {
+      size_t offset =
+          (v - screen->_gv0) * screen->width + (damage.u0 - screen->_gu0);
+      memcpy(
+          &destination->memory[offset], &self->cache[offset],
+          count * sizeof(color_t));
+    }
+    ret = compose_layers(
+        self, first, self->length, destination->memory, screen, damage);
+    if (0 != ret) {
+      LayerStack_invalidate(self);
+      goto out;
+    }
+  }
+
+  // the destination is now up to date
+  for (size_t idx = 0; idx < self->length; idx++) {
+    layer_t* layer = &self->layers[idx];
+    layer->dirty = false;
+    layer->damage = empty_region;
+    if (layer->visible && (layer->opacity > 0.0)) {
+      layer->drawn = region_intersect(layer_region(layer), full);
+    } else {
+      layer->drawn = empty_region;
+    }
+  }
+  self->dirty_from = SIZE_MAX;
+  self->damage = empty_region;
+
+out:
+  return ret;
+}
+
+/**
+ * @brief Append a layer to the top of the stack.
+ *
+ * @param self
+ * @param layer the layer, references are taken on its objects.
+ * @return int 0 on success, -ENOMEM when out of memory.
+ */
+static int append_layer(LayerStackObject* self, layer_t* layer) {
+  int ret = 0;
+  if (self->length == self->capacity) {
+    size_t capacity = (0 == self->capacity) ? 4 : 2 * self->capacity;
+    layer_t* layers =
+        PyMem_Realloc(self->layers, capacity * sizeof(layer_t));
+    if (NULL == layers) {
+      ret = -ENOMEM;
+      goto out;
+    }
+    self->layers = layers;
+    self->capacity = capacity;
+  }
+
+  Py_INCREF(layer->interface);
+  Py_INCREF(layer->screen);
+  Py_INCREF(layer->compositor);
+  layer->drawn = empty_region;
+  layer->damage = empty_region;
+  damage_layer(layer);
+  self->layers[self->length] = *layer;
+  self->length++;
+
+out:
+  return ret;
+}
+
+/**
+ * @brief Release the references held by a layer.
+ *
+ * @param layer
+ */
+static void release_layer(layer_t* layer) {
+  Py_XDECREF(layer->interface);
+  Py_XDECREF(layer->screen);
+  Py_XDECREF(layer->compositor);
+}
+
+/**
+ * @brief Look up a layer by index, negative indices count from the top.
+ *
+ * @param self
+ * @param index
+ * @return layer_t* the layer, or NULL with IndexError set.
+ */
+static layer_t* get_layer(LayerStackObject* self, Py_ssize_t index) {
+  if (index < 0) {
+    index += self->length;
+  }
+  if ((index < 0) || ((size_t)index >= self->length)) {
+    PyErr_SetString(PyExc_IndexError, "layer index out of range");
+    return NULL;
+  }
+  return &self->layers[index];
+}
+
+// getset
+/////////
+
+static PyObject* get_layers(PyObject* self_in, void* closure) {
+  (void)closure;
+  LayerStackObject* self = (LayerStackObject*)self_in;
+  PyObject* layers = PyList_New(self->length);
+  if (NULL == layers) {
+    return NULL;
+  }
+  for (size_t idx = 0; idx < self->length; idx++) {
+    layer_t* layer = &self->layers[idx];
+    PyObject* item = Py_BuildValue(
+        "(OOOdO)", layer->interface, layer->screen, layer->compositor,
+        layer->opacity, layer->visible ? Py_True : Py_False);
+    if (NULL == item) {
+      Py_DECREF(layers);
+      return NULL;
+    }
+    PyList_SET_ITEM(layers, idx, item);
+  }
+  return layers;
+}
+
+// methods
+//////////
+
+static PyObject* add(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  LayerStackObject* self = (LayerStackObject*)self_in;
+  layer_t layer = {
+      .opacity = 1.0,
+      .visible = true,
+  };
+  int visible = 1;
+  char* keywords[] = {
+      "interface",
+      "screen",
+      "compositor",
+      "opacity",
+      "visible",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!O!O!|dp", keywords, &InterfaceType, &layer.interface,
+          &ScreenType, &layer.screen, &CompositorType, &layer.compositor,
+          &layer.opacity, &visible)) {
+    return NULL;
+  }
+  layer.visible = visible;
+
+  if ((0 != Interface_check(&layer.interface->interface)) ||
+      (0 != Compositor_check(layer.compositor))) {
+    return NULL;
+  }
+
+  int ret = append_layer(self, &layer);
+  if (0 != ret) {
+    PyErr_NoMemory();
+    return NULL;
+  }
+
+  return PyLong_FromSize_t(self->length - 1);
+}
+
+static PyObject* remove_layer(PyObject* self_in, PyObject* args) {
+  LayerStackObject* self = (LayerStackObject*)self_in;
+  Py_ssize_t index;
+  if (!PyArg_ParseTuple(args, "n", &index)) {
+    return NULL;
+  }
+
+  layer_t* layer = get_layer(self, index);
+  if (NULL == layer) {
+    return NULL;
+  }
+
+  layer_t removed = *layer;
+  size_t position = layer - self->layers;
+  memmove(
+      layer, layer + 1, (self->length - position - 1) * sizeof(layer_t));
+  self->length--;
+  release_layer(&removed);
+
+  // uncover where the layer was drawn, recompositing from its position
+  self->damage = region_union(self->damage, removed.drawn);
+  if (position < self->dirty_from) {
+    self->dirty_from = position;
+  }
+  if (position < self->cached) {
+    self->cached--;
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static PyObject* clear(PyObject* self_in, PyObject* args) {
+  (void)args;
+  LayerStackObject* self = (LayerStackObject*)self_in;
+  while (self->length > 0) {
+    self->length--;
+    release_layer(&self->layers[self->length]);
+  }
+  LayerStack_invalidate(self);
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static PyObject* update(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  LayerStackObject* self = (LayerStackObject*)self_in;
+  Py_ssize_t index;
+  CompositorObject* compositor = NULL;
+  double opacity = -1.0;
+  int visible = -1;
+  char* keywords[] = {
+      "index",
+      "compositor",
+      "opacity",
+      "visible",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "n|$O!dp", keywords, &index, &CompositorType,
+          &compositor, &opacity, &visible)) {
+    return NULL;
+  }
+  if ((NULL != compositor) && (0 != Compositor_check(compositor))) {
+    return NULL;
+  }
+
+  layer_t* layer = get_layer(self, index);
+  if (NULL == layer) {
+    return NULL;
+  }
+
+  if (NULL != compositor) {
+    Py_INCREF(compositor);
+    Py_DECREF(layer->compositor);
+    layer->compositor = compositor;
+  }
+  if (opacity >= 0.0) {
+    layer->opacity = opacity;
+  }
+  if (visible >= 0) {
+    layer->visible = visible;
+  }
+  damage_layer(layer);
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static PyObject* mark_dirty(
+    PyObject* self_in, PyObject* args, PyObject* kwds) {
+  LayerStackObject* self = (LayerStackObject*)self_in;
+  Py_ssize_t index;
+  PyObject* region_obj = Py_None;
+  char* keywords[] = {
+      "index",
+      "region",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "n|O", keywords, &index, &region_obj)) {
+    return NULL;
+  }
+
+  layer_t* layer = get_layer(self, index);
+  if (NULL == layer) {
+    return NULL;
+  }
+
+  if (Py_None == region_obj) {
+    damage_layer(layer);
+  } else {
+    // the region is given in the coordinates of the layer pixels
+    layer_region_t region;
+    if (!PyArg_ParseTuple(
+            region_obj, "(ii)(ii)", &region.u0, &region.v0, &region.u1,
+            &region.v1)) {
+      return NULL;
+    }
+    if (region.u0 > region.u1) {
+      ext_t tmp = region.u0;
+      region.u0 = region.u1;
+      region.u1 = tmp;
+    }
+    if (region.v0 > region.v1) {
+      ext_t tmp = region.v0;
+      region.v0 = region.v1;
+      region.v1 = tmp;
+    }
+    layer_region_t covered = layer_region(layer);
+    region.u0 += covered.u0;
+    region.u1 += covered.u0;
+    region.v0 += covered.v0;
+    region.v1 += covered.v0;
+    layer->dirty = true;
+    layer->damage =
+        region_union(layer->damage, region_intersect(region, covered));
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static PyObject* invalidate(PyObject* self_in, PyObject* args) {
+  (void)args;
+  LayerStack_invalidate((LayerStackObject*)self_in);
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static PyObject* flatten(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  LayerStackObject* self = (LayerStackObject*)self_in;
+  InterfaceObject* interface_obj;
+  int incremental = 0;
+  char* keywords[] = {
+      "interface",
+      "incremental",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!|p", keywords, &InterfaceType, &interface_obj,
+          &incremental)) {
+    return NULL;
+  }
+
+  int ret;
+  if (incremental) {
+    ret = LayerStack_flatten_incremental(self, &interface_obj->interface);
+  } else {
+    ret = LayerStack_flatten(self, &interface_obj->interface);
+  }
+  if (0 != ret) {
+    return NULL;
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static Py_ssize_t mp_length(PyObject* self_in) {
+  LayerStackObject* self = (LayerStackObject*)self_in;
+  return self->length;
+}
+
+static void tp_dealloc(PyObject* self_in) {
+  LayerStackObject* self = (LayerStackObject*)self_in;
+  for (size_t idx = 0; idx < self->length; idx++) {
+    release_layer(&self->layers[idx]);
+  }
+  PyMem_Free(self->layers);
+  LayerStack_invalidate(self);
+  Py_TYPE(self)->tp_free(self);
+}
+
+static int tp_init(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  (void)self_in;
+  char* keywords[] = {
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "", keywords)) {
+    return -1;
+  }
+  return 0;
+}
+
+static PyMethodDef tp_methods[] = {
+    {"add", (PyCFunction)add, METH_VARARGS | METH_KEYWORDS,
+     "add a layer to the top of the stack and return its index"},
+    {"remove", (PyCFunction)remove_layer, METH_VARARGS,
+     "remove the layer at an index"},
+    {"clear", (PyCFunction)clear, METH_NOARGS, "remove all layers"},
+    {"update", (PyCFunction)update, METH_VARARGS | METH_KEYWORDS,
+     "change the compositor, opacity or visibility of a layer"},
+    {"mark_dirty", (PyCFunction)mark_dirty, METH_VARARGS | METH_KEYWORDS,
+     "mark a region of a layer, or all of it, for recompositing"},
+    {"invalidate", (PyCFunction)invalidate, METH_NOARGS,
+     "discard the cache used by incremental flattening"},
+    {"flatten", (PyCFunction)flatten, METH_VARARGS | METH_KEYWORDS,
+     "compose the visible layers onto an interface in a single pass, "
+     "incrementally recompositing only dirty layers when requested"},
+    {NULL},
+};
+
+static PyMappingMethods tp_as_mapping = {
+    .mp_length = mp_length,
+};
+
+static PyGetSetDef tp_getset[] = {
+    {"layers", get_layers, NULL,
+     "list of (interface, screen, compositor, opacity, visible)", NULL},
+    {NULL},
+};
+
+PyTypeObject LayerStackType = {
+    PyVarObject_HEAD_INIT(NULL, 0).tp_name = "_sicgl_core.LayerStack",
+    .tp_doc = PyDoc_STR("ordered stack of layers flattened in one pass"),
+    .tp_basicsize = sizeof(LayerStackObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = PyType_GenericNew,
+    .tp_dealloc = tp_dealloc,
+    .tp_init = tp_init,
+    .tp_getset = tp_getset,
+    .tp_methods = tp_methods,
+    .tp_as_mapping = &tp_as_mapping,
+};
@@ -0,0 +1,331 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "pysicgl/submodules/functional/drawing/target.h"
+#include "pysicgl/types/interface.h"
+#include "pysicgl/types/rle_sprite.h"
+#include "pysicgl/types/screen.h"
+
+// utilities for C consumers
+////////////////////////////
+
+static inline bool is_transparent(color_t color) {
+  return 0 == color_channel_alpha(color);
+}
+
+/**
+ * @brief Release the runs and pixels of a sprite.
+ *
+ * @param self
+ */
+static void reset_sprite(RLESpriteObject* self) {
+  PyMem_Free(self->runs);
+  PyMem_Free(self->rows);
+  PyMem_Free(self->pixels);
+  self->runs = NULL;
+  self->rows = NULL;
+  self->pixels = NULL;
+  self->num_runs = 0;
+  self->num_pixels = 0;
+  self->width = 0;
+  self->height = 0;
+}
+
+/**
+ * @brief Encode pixels as runs which skip fully transparent pixels.
+ *
+ * The pixels are scanned once to size the runs and once more to fill them
+ * in, any previous contents of the sprite are replaced.
+ *
+ * @param self
+ * @param pixels first pixel of the source.
+ * @param stride distance between rows of the source.
+ * @param width
+ * @param height
+ * @return int 0 on success, -ENOMEM when out of memory.
+ */
+int RLESprite_encode(
+    RLESpriteObject* self, const color_t* pixels, ext_t stride, ext_t width,
+    ext_t height) {
+  size_t num_runs = 0;
+  size_t num_pixels = 0;
+  for (ext_t y = 0; y < height; y++) {
+    const color_t* row = &pixels[(size_t)y * (size_t)stride];
+    for (ext_t x = 0; x < width; x++) {
+      if (is_transparent(row[x])) {
+        continue;
+      }
+      if ((0 == x) || is_transparent(row[x - 1])) {
+        num_runs++;
+      }
+      num_pixels++;
+    }
+  }
+
+  rle_run_t* runs = PyMem_Malloc((num_runs + 1) * sizeof(rle_run_t));
+  size_t* rows = PyMem_Malloc(((size_t)height + 1) * sizeof(size_t));
+  color_t* packed = PyMem_Malloc((num_pixels + 1) * sizeof(color_t));
+  if ((NULL == runs) || (NULL == rows) || (NULL == packed)) {
+    PyMem_Free(runs);
+    PyMem_Free(rows);
+    PyMem_Free(packed);
+    return -ENOMEM;
+  }
+
+  size_t run = 0;
+  size_t offset = 0;
+  for (ext_t y = 0; y < height; y++) {
+    const color_t* row = &pixels[(size_t)y * (size_t)stride];
+    rows[y] = run;
+    ext_t x = 0;
+    while (x < width) {
+      if (is_transparent(row[x])) {
+        x++;
+        continue;
+      }
+      ext_t start = x;
+      while ((x < width) && !is_transparent(row[x])) {
+        x++;
+      }
+      runs[run++] = (rle_run_t){
+          .u = start,
+          .length = x - start,
+          .offset = offset,
+      };
+      memcpy(
+          &packed[offset], &row[start], (size_t)(x - start) * sizeof(color_t));
+      offset += (size_t)(x - start);
+    }
+  }
+  rows[height] = run;
+
+  reset_sprite(self);
+  self->runs = runs;
+  self->rows = rows;
+  self->pixels = packed;
+  self->num_runs = num_runs;
+  self->num_pixels = num_pixels;
+  self->width = width;
+  self->height = height;
+  return 0;
+}
+
+/**
+ * @brief Draw the runs of a sprite into an interface.
+ *
+ * Rows outside the drawable region are skipped without visiting their
+ * runs, each run is clipped and then copied or handed to the compositor.
+ * Clipping is done in 64 bits so that far away sprites cannot overflow.
+ *
+ * @param self
+ * @param interface
+ * @param u top left of the sprite in interface coordinates.
+ * @param v
+ * @param u0 drawable region in interface coordinates, inclusive.
+ * @param v0
+ * @param u1
+ * @param v1
+ * @param compositor compositor, or NULL to copy the runs.
+ */
+void RLESprite_draw(
+    RLESpriteObject* self, interface_t* interface, int64_t u, int64_t v,
+    ext_t u0, ext_t v0, ext_t u1, ext_t v1, CompositorObject* compositor) {
+  int64_t y0 = (v0 > v) ? v0 - v : 0;
+  int64_t y1 = (v1 - v < self->height - 1) ? v1 - v : self->height - 1;
+  size_t stride = (size_t)interface->screen->width;
+  for (int64_t y = y0; y <= y1; y++) {
+    color_t* row = &interface->memory[(size_t)(v + y) * stride];
+    for (size_t idx = self->rows[y]; idx < self->rows[y + 1]; idx++) {
+      const rle_run_t* run = &self->runs[idx];
+      int64_t start = u + run->u;
+      int64_t end = start + run->length - 1;
+      int64_t skip = (u0 > start) ? u0 - start : 0;
+      if (end > u1) {
+        end = u1;
+      }
+      if (start + skip > end) {
+        continue;
+      }
+      size_t count = (size_t)(end - start - skip + 1);
+      color_t* source = &self->pixels[run->offset + (size_t)skip];
+      color_t* destination = &row[(size_t)(start + skip)];
+      if (NULL == compositor) {
+        memcpy(destination, source, count * sizeof(color_t));
+      } else {
+        compositor->fn(source, destination, count, compositor->args);
+      }
+    }
+  }
+}
+
+// getset
+/////////
+
+static PyObject* get_extent(PyObject* self_in, void* closure) {
+  (void)closure;
+  RLESpriteObject* self = (RLESpriteObject*)self_in;
+  return Py_BuildValue("(ii)", self->width, self->height);
+}
+
+static PyObject* get_runs(PyObject* self_in, void* closure) {
+  (void)closure;
+  return PyLong_FromSize_t(((RLESpriteObject*)self_in)->num_runs);
+}
+
+static PyObject* get_pixels(PyObject* self_in, void* closure) {
+  (void)closure;
+  return PyLong_FromSize_t(((RLESpriteObject*)self_in)->num_pixels);
+}
+
+// methods
+//////////
+
+static PyObject* draw(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  RLESpriteObject* self = (RLESpriteObject*)self_in;
+  InterfaceObject* interface_obj;
+  ext_t u, v;
+  PyObject* screen_obj = Py_None;
+  PyObject* compositor_obj = Py_None;
+  char* keywords[] = {
+      "interface",
+      "position",
+      "screen",
+      "compositor",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!(ii)|OO", keywords, &InterfaceType, &interface_obj,
+          &u, &v, &screen_obj, &compositor_obj)) {
+    return NULL;
+  }
+
+  screen_t* screen = NULL;
+  if (Py_None != screen_obj) {
+    if (!PyObject_TypeCheck(screen_obj, &ScreenType)) {
+      PyErr_SetString(PyExc_TypeError, "screen must be a Screen");
+      return NULL;
+    }
+    screen = ((ScreenObject*)screen_obj)->screen;
+  }
+  CompositorObject* compositor = NULL;
+  if (Py_None != compositor_obj) {
+    if (!PyObject_TypeCheck(compositor_obj, &CompositorType)) {
+      PyErr_SetString(PyExc_TypeError, "compositor must be a Compositor");
+      return NULL;
+    }
+    compositor = (CompositorObject*)compositor_obj;
+    if (0 != Compositor_check(compositor)) {
+      return NULL;
+    }
+  }
+
+  draw_target_t target;
+  int ret = draw_target_init(
+      &target, &interface_obj->interface, 0, screen, NULL == screen);
+  if (ret < 0) {
+    return NULL;
+  }
+  if ((ret > 0) && (self->height > 0)) {
+    RLESprite_draw(
+        self, &interface_obj->interface, (int64_t)u + (int64_t)target.du,
+        (int64_t)v + (int64_t)target.dv, target.u0, target.v0, target.u1,
+        target.v1, compositor);
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static void tp_dealloc(PyObject* self_in) {
+  RLESpriteObject* self = (RLESpriteObject*)self_in;
+  reset_sprite(self);
+  Py_TYPE(self)->tp_free(self);
+}
+
+static int tp_init(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  RLESpriteObject* self = (RLESpriteObject*)self_in;
+  PyObject* source_obj;
+  ext_t width = 0;
+  ext_t height = 0;
+  char* keywords[] = {
+      "source",
+      "extent",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O|(ii)", keywords, &source_obj, &width, &height)) {
+    return -1;
+  }
+
+  int ret = 0;
+  if (PyObject_TypeCheck(source_obj, &InterfaceType)) {
+    interface_t* interface = &((InterfaceObject*)source_obj)->interface;
+    if (0 != Interface_check(interface)) {
+      return -1;
+    }
+    screen_t* screen = interface->screen;
+    ret = RLESprite_encode(
+        self, interface->memory, screen->width, screen->width,
+        screen->height);
+  } else {
+    // a buffer of pixels of the given extent
+    Py_buffer buffer;
+    if (0 != PyObject_GetBuffer(source_obj, &buffer, PyBUF_SIMPLE)) {
+      return -1;
+    }
+    if ((width <= 0) || (height <= 0)) {
+      PyErr_SetString(
+          PyExc_ValueError, "extent is required for a buffer source");
+      ret = -1;
+    } else if (
+        (size_t)buffer.len <
+        (size_t)width * (size_t)height * sizeof(color_t)) {
+      PyErr_SetString(PyExc_ValueError, "buffer is too small for extent");
+      ret = -1;
+    } else {
+      ret = RLESprite_encode(self, buffer.buf, width, width, height);
+    }
+    PyBuffer_Release(&buffer);
+    if (-1 == ret) {
+      return -1;
+    }
+  }
+
+  if (-ENOMEM == ret) {
+    PyErr_NoMemory();
+    return -1;
+  }
+  return 0;
+}
+
+static PyMethodDef tp_methods[] = {
+    {"draw", (PyCFunction)draw, METH_VARARGS | METH_KEYWORDS,
+     "draw the sprite with its top left at (u, v)"},
+    {NULL},
+};
+
+static PyGetSetDef tp_getset[] = {
+    {"extent", get_extent, NULL, "(width, height) of the sprite", NULL},
+    {"runs", get_runs, NULL, "number of runs which are drawn", NULL},
+    {"pixels", get_pixels, NULL, "number of pixels which are drawn", NULL},
+    {NULL},
+};
+
+PyTypeObject RLESpriteType = {
+    PyVarObject_HEAD_INIT(NULL, 0).tp_name = "_sicgl_core.RLESprite",
+    .tp_doc = PyDoc_STR("sprite which skips its fully transparent pixels"),
+    .tp_basicsize = sizeof(RLESpriteObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = PyType_GenericNew,
+    .tp_dealloc = tp_dealloc,
+    .tp_init = tp_init,
+    .tp_getset = tp_getset,
+    .tp_methods = tp_methods,
+};
@@ -0,0 +1,844 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pysicgl/types/scalar_expression.h"
+
+#ifndef M_PI
+#define M_PI (3.14159265358979323846)
+#endif
+
+// limits keep register indices within 16 bits
+#define MAX_INSTRUCTIONS (1024)
+#define MAX_CONSTANTS (1024)
+
+// bounds the recursion of the parser
+#define MAX_DEPTH (64)
+
+// fixed registers
+#define REGISTER_U (0)
+#define REGISTER_V (1)
+#define REGISTER_T (2)
+#define NUM_FIXED_REGISTERS (3)
+
+// how often a value changes
+#define LEVEL_CALL (0)
+#define LEVEL_ROW (1)
+#define LEVEL_PIXEL (2)
+
+typedef enum _opcode_t {
+  OP_ADD = 0,
+  OP_SUB,
+  OP_MUL,
+  OP_DIV,
+  OP_MOD,
+  OP_POW,
+  OP_NEG,
+  OP_SIN,
+  OP_COS,
+  OP_TAN,
+  OP_ASIN,
+  OP_ACOS,
+  OP_ATAN,
+  OP_SQRT,
+  OP_ABS,
+  OP_EXP,
+  OP_LOG,
+  OP_FLOOR,
+  OP_CEIL,
+  OP_FRACT,
+  OP_ATAN2,
+  OP_MIN,
+  OP_MAX,
+  OP_HYPOT,
+} opcode_t;
+
+typedef struct _function_entry_t {
+  const char* name;
+  opcode_t opcode;
+  int arity;
+} function_entry_t;
+static const function_entry_t functions[] = {
+    {"sin", OP_SIN, 1},     {"cos", OP_COS, 1},     {"tan", OP_TAN, 1},
+    {"asin", OP_ASIN, 1},   {"acos", OP_ACOS, 1},   {"atan", OP_ATAN, 1},
+    {"sqrt", OP_SQRT, 1},   {"abs", OP_ABS, 1},     {"exp", OP_EXP, 1},
+    {"log", OP_LOG, 1},     {"floor", OP_FLOOR, 1}, {"ceil", OP_CEIL, 1},
+    {"fract", OP_FRACT, 1}, {"atan2", OP_ATAN2, 2}, {"pow", OP_POW, 2},
+    {"min", OP_MIN, 2},     {"max", OP_MAX, 2},     {"hypot", OP_HYPOT, 2},
+    {"mod", OP_MOD, 2},
+};
+static const size_t num_functions =
+    sizeof(functions) / sizeof(function_entry_t);
+
+/**
+ * @brief Apply an operation to a block of values.
+ *
+ * The opcode is dispatched once per block so that each case is a
+ * simple loop which the compiler is free to vectorize.
+ */
+static void apply(
+    uint8_t opcode, double* destination, const double* a, const double* b,
+    size_t count) {
+  switch (opcode) {
+    case OP_ADD:
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = a[idx] + b[idx];
+      }
+      break;
+    case OP_SUB:
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = a[idx] - b[idx];
+      }
+      break;
+    case OP_MUL:
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = a[idx] * b[idx];
+      }
+      break;
+    case OP_DIV:
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = a[idx] / b[idx];
+      }
+      break;
+    case OP_MOD:
+      // floored modulo so that fields wrap continuously
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = a[idx] - b[idx] * floor(a[idx] / b[idx]);
+      }
+      break;
+    case OP_POW:
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = pow(a[idx], b[idx]);
+      }
+      break;
+    case OP_NEG:
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = -a[idx];
+      }
+      break;
+    case OP_SIN:
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = sin(a[idx]);
+      }
+      break;
+    case OP_COS:
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = cos(a[idx]);
+      }
+      break;
+    case OP_TAN:
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = tan(a[idx]);
+      }
+      break;
+    case OP_ASIN:
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = asin(a[idx]);
+      }
+      break;
+    case OP_ACOS:
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = acos(a[idx]);
+      }
+      break;
+    case OP_ATAN:
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = atan(a[idx]);
+      }
+      break;
+    case OP_SQRT:
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = sqrt(a[idx]);
+      }
+      break;
+    case OP_ABS:
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = fabs(a[idx]);
+      }
+      break;
+    case OP_EXP:
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = exp(a[idx]);
+      }
+      break;
+    case OP_LOG:
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = log(a[idx]);
+      }
+      break;
+    case OP_FLOOR:
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = floor(a[idx]);
+      }
+      break;
+    case OP_CEIL:
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = ceil(a[idx]);
+      }
+      break;
+    case OP_FRACT:
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = a[idx] - floor(a[idx]);
+      }
+      break;
+    case OP_ATAN2:
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = atan2(a[idx], b[idx]);
+      }
+      break;
+    case OP_MIN:
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = (a[idx] < b[idx]) ? a[idx] : b[idx];
+      }
+      break;
+    case OP_MAX:
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = (a[idx] > b[idx]) ? a[idx] : b[idx];
+      }
+      break;
+    case OP_HYPOT:
+      for (size_t idx = 0; idx < count; idx++) {
+        destination[idx] = sqrt(a[idx] * a[idx] + b[idx] * b[idx]);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+// compiler
+///////////
+
+// a value produced while parsing, either a folded constant or a register
+typedef struct _operand_t {
+  bool constant;
+  double value;
+  uint16_t reg;
+  uint8_t level;
+} operand_t;
+
+// compiler state, instructions carry their level until they are sorted
+typedef struct _compiler_t {
+  const char* source;
+  const char* cursor;
+  ScalarExpressionObject* program;
+  uint8_t* levels;
+  unsigned depth;
+} compiler_t;
+
+static int parse_expression(compiler_t* compiler, operand_t* result);
+
+static int syntax_error(compiler_t* compiler, const char* message) {
+  PyErr_Format(
+      PyExc_ValueError, "%s at position %zd", message,
+      (Py_ssize_t)(compiler->cursor - compiler->source));
+  return -1;
+}
+
+static void skip_whitespace(compiler_t* compiler) {
+  while (isspace((unsigned char)*compiler->cursor)) {
+    compiler->cursor++;
+  }
+}
+
+static bool accept(compiler_t* compiler, char c) {
+  skip_whitespace(compiler);
+  if (c == *compiler->cursor) {
+    compiler->cursor++;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Place a constant operand into a register.
+ */
+static int materialize(compiler_t* compiler, operand_t* operand) {
+  ScalarExpressionObject* program = compiler->program;
+  if (!operand->constant) {
+    return 0;
+  }
+  if (program->num_constants >= MAX_CONSTANTS) {
+    return syntax_error(compiler, "too many constants");
+  }
+
+  program->constants[program->num_constants] = operand->value;
+  program->constant_registers[program->num_constants] =
+      program->num_registers;
+  program->num_constants++;
+
+  operand->constant = false;
+  operand->reg = program->num_registers++;
+  operand->level = LEVEL_CALL;
+  return 0;
+}
+
+/**
+ * @brief Emit an operation, folding it when all operands are constant.
+ *
+ * @param compiler
+ * @param opcode
+ * @param a first operand.
+ * @param b second operand, or NULL for unary operations.
+ * @param result the output operand.
+ * @return int
+ */
+static int emit(
+    compiler_t* compiler, opcode_t opcode, operand_t* a, operand_t* b,
+    operand_t* result) {
+  ScalarExpressionObject* program = compiler->program;
+
+  if (a->constant && ((NULL == b) || b->constant)) {
+    double rhs = (NULL == b) ? 0.0 : b->value;
+    result->constant = true;
+    apply(opcode, &result->value, &a->value, &rhs, 1);
+    return 0;
+  }
+
+  if (program->num_instructions >= MAX_INSTRUCTIONS) {
+    return syntax_error(compiler, "expression is too complex");
+  }
+  if ((0 != materialize(compiler, a)) ||
+      ((NULL != b) && (0 != materialize(compiler, b)))) {
+    return -1;
+  }
+
+  uint8_t level = a->level;
+  if ((NULL != b) && (b->level > level)) {
+    level = b->level;
+  }
+
+  scalar_expression_instruction_t* instruction =
+      &program->instructions[program->num_instructions];
+  instruction->opcode = opcode;
+  instruction->destination = program->num_registers++;
+  instruction->a = a->reg;
+  instruction->b = (NULL == b) ? a->reg : b->reg;
+  compiler->levels[program->num_instructions] = level;
+  program->num_instructions++;
+
+  result->constant = false;
+  result->reg = instruction->destination;
+  result->level = level;
+  return 0;
+}
+
+static int parse_primary(compiler_t* compiler, operand_t* result) {
+  skip_whitespace(compiler);
+  const char* start = compiler->cursor;
+
+  // parenthesized expression
+  if (accept(compiler, '(')) {
+    if (0 != parse_expression(compiler, result)) {
+      return -1;
+    }
+    if (!accept(compiler, ')')) {
+      return syntax_error(compiler, "expected ')'");
+    }
+    return 0;
+  }
+
+  // numeric literal
+  if (isdigit((unsigned char)*start) || ('.' == *start)) {
+    char* end;
+    double value = strtod(start, &end);
+    if (end == start) {
+      return syntax_error(compiler, "invalid number");
+    }
+    compiler->cursor = end;
+    result->constant = true;
+    result->value = value;
+    return 0;
+  }
+
+  // identifiers name variables, constants and functions
+  if (!isalpha((unsigned char)*start) && ('_' != *start)) {
+    if ('\0' == *start) {
+      return syntax_error(compiler, "unexpected end of expression");
+    }
+    return syntax_error(compiler, "unexpected character");
+  }
+  while (isalnum((unsigned char)*compiler->cursor) ||
+         ('_' == *compiler->cursor)) {
+    compiler->cursor++;
+  }
+  size_t length = compiler->cursor - start;
+
+#define IDENTIFIER_IS(name) \
+  ((strlen(name) == length) && (0 == strncmp(start, name, length)))
+
+  if (accept(compiler, '(')) {
+    for (size_t idx = 0; idx < num_functions; idx++) {
+      const function_entry_t* entry = &functions[idx];
+      if (!IDENTIFIER_IS(entry->name)) {
+        continue;
+      }
+
+      operand_t a, b;
+      if (0 != parse_expression(compiler, &a)) {
+        return -1;
+      }
+      if (2 == entry->arity) {
+        if (!accept(compiler, ',')) {
+          return syntax_error(compiler, "expected ','");
+        }
+        if (0 != parse_expression(compiler, &b)) {
+          return -1;
+        }
+      }
+      if (!accept(compiler, ')')) {
+        return syntax_error(compiler, "expected ')'");
+      }
+      return emit(
+          compiler, entry->opcode, &a, (2 == entry->arity) ? &b : NULL,
+          result);
+    }
+    compiler->cursor = start;
+    return syntax_error(compiler, "unknown function");
+  }
+
+  result->constant = false;
+  if (IDENTIFIER_IS("u") || IDENTIFIER_IS("x")) {
+    result->reg = REGISTER_U;
+    result->level = LEVEL_PIXEL;
+  } else if (IDENTIFIER_IS("v") || IDENTIFIER_IS("y")) {
+    result->reg = REGISTER_V;
+    result->level = LEVEL_ROW;
+  } else if (IDENTIFIER_IS("t")) {
+    result->reg = REGISTER_T;
+    result->level = LEVEL_CALL;
+  } else if (IDENTIFIER_IS("pi")) {
+    result->constant = true;
+    result->value = M_PI;
+  } else if (IDENTIFIER_IS("e")) {
+    result->constant = true;
+    result->value = M_E;
+  } else {
+    compiler->cursor = start;
+    return syntax_error(compiler, "unknown identifier");
+  }
+
+#undef IDENTIFIER_IS
+
+  return 0;
+}
+
+static int parse_unary(compiler_t* compiler, operand_t* result);
+
+static int parse_power(compiler_t* compiler, operand_t* result) {
+  if (0 != parse_primary(compiler, result)) {
+    return -1;
+  }
+
+  // exponentiation is right associative and binds tighter than negation
+  skip_whitespace(compiler);
+  bool power = accept(compiler, '^');
+  if (!power && ('*' == compiler->cursor[0]) &&
+      ('*' == compiler->cursor[1])) {
+    compiler->cursor += 2;
+    power = true;
+  }
+  if (power) {
+    operand_t exponent;
+    if (0 != parse_unary(compiler, &exponent)) {
+      return -1;
+    }
+    operand_t base = *result;
+    return emit(compiler, OP_POW, &base, &exponent, result);
+  }
+
+  return 0;
+}
+
+static int parse_unary(compiler_t* compiler, operand_t* result) {
+  // every recursive production passes through here
+  if (compiler->depth >= MAX_DEPTH) {
+    return syntax_error(compiler, "expression is nested too deeply");
+  }
+  compiler->depth++;
+
+  int ret;
+  if (accept(compiler, '-')) {
+    operand_t operand;
+    ret = parse_unary(compiler, &operand);
+    if (0 == ret) {
+      ret = emit(compiler, OP_NEG, &operand, NULL, result);
+    }
+  } else if (accept(compiler, '+')) {
+    ret = parse_unary(compiler, result);
+  } else {
+    ret = parse_power(compiler, result);
+  }
+
+  compiler->depth--;
+  return ret;
+}
+
+static int parse_term(compiler_t* compiler, operand_t* result) {
+  if (0 != parse_unary(compiler, result)) {
+    return -1;
+  }
+
+  while (true) {
+    skip_whitespace(compiler);
+    char c = *compiler->cursor;
+    opcode_t opcode;
+    if (('*' == c) && ('*' != compiler->cursor[1])) {
+      opcode = OP_MUL;
+    } else if ('/' == c) {
+      opcode = OP_DIV;
+    } else if ('%' == c) {
+      opcode = OP_MOD;
+    } else {
+      return 0;
+    }
+    compiler->cursor++;
+
+    operand_t lhs = *result;
+    operand_t rhs;
+    if (0 != parse_unary(compiler, &rhs)) {
+      return -1;
+    }
+    if (0 != emit(compiler, opcode, &lhs, &rhs, result)) {
+      return -1;
+    }
+  }
+}
+
+static int parse_expression(compiler_t* compiler, operand_t* result) {
+  if (0 != parse_term(compiler, result)) {
+    return -1;
+  }
+
+  while (true) {
+    opcode_t opcode;
+    if (accept(compiler, '+')) {
+      opcode = OP_ADD;
+    } else if (accept(compiler, '-')) {
+      opcode = OP_SUB;
+    } else {
+      return 0;
+    }
+
+    operand_t lhs = *result;
+    operand_t rhs;
+    if (0 != parse_term(compiler, &rhs)) {
+      return -1;
+    }
+    if (0 != emit(compiler, opcode, &lhs, &rhs, result)) {
+      return -1;
+    }
+  }
+}
+
+/**
+ * @brief Release the compiled program.
+ *
+ * @param self
+ */
+static void deallocate_program(ScalarExpressionObject* self) {
+  PyMem_Free(self->instructions);
+  PyMem_Free(self->constants);
+  PyMem_Free(self->constant_registers);
+  self->instructions = NULL;
+  self->constants = NULL;
+  self->constant_registers = NULL;
+  self->num_instructions = 0;
+  self->num_constants = 0;
+  self->num_registers = 0;
+}
+
+/**
+ * @brief Compile an expression into the object.
+ *
+ * @param self
+ * @param source the expression source text.
+ * @return int 0 on success, -1 with the Python error indicator set.
+ */
+static int compile(ScalarExpressionObject* self, const char* source) {
+  int ret = 0;
+  uint8_t* levels = NULL;
+  scalar_expression_instruction_t* sorted = NULL;
+
+  deallocate_program(self);
+  self->instructions =
+      PyMem_Malloc(MAX_INSTRUCTIONS * sizeof(scalar_expression_instruction_t));
+  self->constants = PyMem_Malloc(MAX_CONSTANTS * sizeof(double));
+  self->constant_registers = PyMem_Malloc(MAX_CONSTANTS * sizeof(uint16_t));
+  levels = PyMem_Malloc(MAX_INSTRUCTIONS * sizeof(uint8_t));
+  if ((NULL == self->instructions) || (NULL == self->constants) ||
+      (NULL == self->constant_registers) || (NULL == levels)) {
+    PyErr_NoMemory();
+    ret = -1;
+    goto out;
+  }
+  self->num_registers = NUM_FIXED_REGISTERS;
+
+  compiler_t compiler = {
+      .source = source,
+      .cursor = source,
+      .program = self,
+      .levels = levels,
+      .depth = 0,
+  };
+  operand_t result;
+  ret = parse_expression(&compiler, &result);
+  if (0 != ret) {
+    goto out;
+  }
+  skip_whitespace(&compiler);
+  if ('\0' != *compiler.cursor) {
+    ret = syntax_error(&compiler, "unexpected character");
+    goto out;
+  }
+  ret = materialize(&compiler, &result);
+  if (0 != ret) {
+    goto out;
+  }
+  self->result = result.reg;
+
+  // stable partition by level, dependencies always precede their users
+  sorted = PyMem_Malloc(
+      (self->num_instructions + 1) * sizeof(scalar_expression_instruction_t));
+  if (NULL == sorted) {
+    PyErr_NoMemory();
+    ret = -1;
+    goto out;
+  }
+  size_t count = 0;
+  for (uint8_t level = LEVEL_CALL; level <= LEVEL_PIXEL; level++) {
+    if (LEVEL_ROW == level) {
+      self->row_start = count;
+    } else if (LEVEL_PIXEL == level) {
+      self->pixel_start = count;
+    }
+    for (size_t idx = 0; idx < self->num_instructions; idx++) {
+      if (level == levels[idx]) {
+        sorted[count++] = self->instructions[idx];
+      }
+    }
+  }
+  PyMem_Free(self->instructions);
+  self->instructions = sorted;
+  sorted = NULL;
+
+out:
+  PyMem_Free(levels);
+  PyMem_Free(sorted);
+  if (0 != ret) {
+    deallocate_program(self);
+  }
+  return ret;
+}
+
+// utilities for C consumers
+////////////////////////////
+
+static inline double* get_register(double* registers, uint16_t reg) {
+  return &registers[(size_t)reg * SCALAR_EXPRESSION_BLOCK];
+}
+
+static inline void run(
+    double* registers, scalar_expression_instruction_t* instructions,
+    size_t start, size_t end) {
+  for (size_t idx = start; idx < end; idx++) {
+    scalar_expression_instruction_t* instruction = &instructions[idx];
+    apply(
+        instruction->opcode, get_register(registers, instruction->destination),
+        get_register(registers, instruction->a),
+        get_register(registers, instruction->b), SCALAR_EXPRESSION_BLOCK);
+  }
+}
+
+static inline void broadcast(double* registers, uint16_t reg, double value) {
+  double* destination = get_register(registers, reg);
+  for (size_t idx = 0; idx < SCALAR_EXPRESSION_BLOCK; idx++) {
+    destination[idx] = value;
+  }
+}
+
+/**
+ * @brief Prepare to evaluate an expression at time t.
+ *
+ * Constants are loaded and the instructions which do not depend on
+ * the pixel position are evaluated once here.
+ *
+ * @param evaluator
+ * @param expression compiled expression.
+ * @param t time value.
+ * @return int
+ */
+int ScalarExpression_evaluator_init(
+    scalar_expression_evaluator_t* evaluator,
+    ScalarExpressionObject* expression, double t) {
+  int ret = 0;
+  if ((NULL == evaluator) || (NULL == expression) ||
+      (NULL == expression->instructions)) {
+    ret = -EINVAL;
+    goto out;
+  }
+
+  evaluator->expression = expression;
+  evaluator->registers = PyMem_Malloc(
+      expression->num_registers * SCALAR_EXPRESSION_BLOCK * sizeof(double));
+  if (NULL == evaluator->registers) {
+    ret = -ENOMEM;
+    goto out;
+  }
+
+  double* registers = evaluator->registers;
+  broadcast(registers, REGISTER_T, t);
+  for (size_t idx = 0; idx < expression->num_constants; idx++) {
+    broadcast(
+        registers, expression->constant_registers[idx],
+        expression->constants[idx]);
+  }
+  run(registers, expression->instructions, 0, expression->row_start);
+
+out:
+  return ret;
+}
+
+/**
+ * @brief Evaluate the expression along a row.
+ *
+ * @param evaluator
+ * @param u0 horizontal coordinate of the first pixel.
+ * @param v vertical coordinate of the row.
+ * @param count number of pixels to evaluate.
+ * @param out output scalars. Non-finite results are replaced with 0.
+ * @return int
+ */
+int ScalarExpression_evaluator_row(
+    scalar_expression_evaluator_t* evaluator, ext_t u0, ext_t v,
+    size_t count, double* out) {
+  int ret = 0;
+  if ((NULL == evaluator) || (NULL == evaluator->registers)) {
+    ret = -EINVAL;
+    goto out;
+  }
+
+  ScalarExpressionObject* expression = evaluator->expression;
+  double* registers = evaluator->registers;
+  double* u = get_register(registers, REGISTER_U);
+  double* result = get_register(registers, expression->result);
+
+  broadcast(registers, REGISTER_V, v);
+  run(registers, expression->instructions, expression->row_start,
+      expression->pixel_start);
+
+  for (size_t start = 0; start < count; start += SCALAR_EXPRESSION_BLOCK) {
+    size_t block = count - start;
+    if (block > SCALAR_EXPRESSION_BLOCK) {
+      block = SCALAR_EXPRESSION_BLOCK;
+    }
+
+    for (size_t idx = 0; idx < SCALAR_EXPRESSION_BLOCK; idx++) {
+      u[idx] = (double)u0 + start + idx;
+    }
+    run(registers, expression->instructions, expression->pixel_start,
+        expression->num_instructions);
+
+    for (size_t idx = 0; idx < block; idx++) {
+      double value = result[idx];
+      out[start + idx] = isfinite(value) ? value : 0.0;
+    }
+  }
+
+out:
+  return ret;
+}
+
+/**
+ * @brief Release the registers of an evaluator.
+ *
+ * @param evaluator
+ */
+void ScalarExpression_evaluator_deinit(
+    scalar_expression_evaluator_t* evaluator) {
+  if (NULL == evaluator) {
+    return;
+  }
+  PyMem_Free(evaluator->registers);
+  evaluator->registers = NULL;
+}
+
+// getset
+/////////
+
+static PyObject* get_source(PyObject* self_in, void* closure) {
+  (void)closure;
+  ScalarExpressionObject* self = (ScalarExpressionObject*)self_in;
+  if (NULL == self->source) {
+    Py_INCREF(Py_None);
+    return Py_None;
+  }
+  Py_INCREF(self->source);
+  return self->source;
+}
+
+static PyObject* get_instructions(PyObject* self_in, void* closure) {
+  (void)closure;
+  ScalarExpressionObject* self = (ScalarExpressionObject*)self_in;
+  return PyLong_FromSize_t(self->num_instructions);
+}
+
+static void tp_dealloc(PyObject* self_in) {
+  ScalarExpressionObject* self = (ScalarExpressionObject*)self_in;
+  deallocate_program(self);
+  Py_XDECREF(self->source);
+  Py_TYPE(self)->tp_free(self);
+}
+
+static int tp_init(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  ScalarExpressionObject* self = (ScalarExpressionObject*)self_in;
+  PyObject* source_obj;
+  char* keywords[] = {
+      "source",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "U", keywords, &source_obj)) {
+    return -1;
+  }
+
+  const char* source = PyUnicode_AsUTF8(source_obj);
+  if (NULL == source) {
+    return -1;
+  }
+  if (0 != compile(self, source)) {
+    return -1;
+  }
+
+  Py_XDECREF(self->source);
+  self->source = source_obj;
+  Py_INCREF(self->source);
+
+  return 0;
+}
+
+static PyGetSetDef tp_getset[] = {
+    {"source", get_source, NULL, "expression source text", NULL},
+    {"instructions", get_instructions, NULL,
+     "number of compiled instructions", NULL},
+    {NULL},
+};
+
+PyTypeObject ScalarExpressionType = {
+    PyVarObject_HEAD_INIT(NULL, 0).tp_name = "_sicgl_core.ScalarExpression",
+    .tp_doc = PyDoc_STR("sicgl ScalarExpression"),
+    .tp_basicsize = sizeof(ScalarExpressionObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = PyType_GenericNew,
+    .tp_dealloc = tp_dealloc,
+    .tp_init = tp_init,
+    .tp_getset = tp_getset,
+};
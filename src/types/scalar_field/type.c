@@ -4,6 +4,7 @@
 
 #include <errno.h>
 #include <stdio.h>
+#include <string.h>
 #include <structmember.h>
 
 #include "pysicgl/types/scalar_field.h"
@@ -34,16 +35,19 @@ out:
  *
  * @param self
  * @param len
+ * @param storage
  * @return int
  */
-static int allocate_scalars(ScalarFieldObject* self, size_t len) {
+static int allocate_scalars(
+    ScalarFieldObject* self, size_t len, scalar_storage_t storage) {
   int ret = 0;
   if (NULL == self) {
     ret = -1;
     goto out;
   }
 
-  self->scalars = PyMem_Malloc(len * sizeof(double));
+  self->storage = storage;
+  self->scalars = PyMem_Calloc(len, ScalarField_element_size(storage));
   if (NULL == self->scalars) {
     ret = -ENOMEM;
     goto out;
@@ -54,6 +58,423 @@ out:
   return ret;
 }
 
+// utilities for C consumers
+////////////////////////////
+
+/**
+ * @brief Get the size of a single scalar.
+ *
+ * @param storage
+ * @return size_t size in bytes.
+ */
+size_t ScalarField_element_size(scalar_storage_t storage) {
+  switch (storage) {
+    case SCALAR_STORAGE_FLOAT32:
+      return sizeof(float);
+    case SCALAR_STORAGE_UINT16:
+      return sizeof(uint16_t);
+    case SCALAR_STORAGE_FLOAT64:
+    default:
+      return sizeof(double);
+  }
+}
+
+static inline uint16_t normalize_u16(double value) {
+  if (!(value > 0.0)) {
+    return 0;
+  } else if (value >= 1.0) {
+    return UINT16_MAX;
+  }
+  return (uint16_t)(value * UINT16_MAX + 0.5);
+}
+
+#define LOAD_FLOAT64(value) (value)
+#define LOAD_FLOAT32(value) ((double)(value))
+#define LOAD_UINT16(value) ((value) * (1.0 / UINT16_MAX))
+
+/**
+ * @brief Generate the row kernels for one storage format.
+ *
+ * Each storage format gets its own copy of the loops so that loads
+ * are converted inline rather than through a per-scalar switch.
+ */
+#define DEFINE_ROW_KERNELS(suffix, type, load)                                \
+  static void copy_row_##suffix(                                              \
+      const void* scalars, size_t start, size_t count, double* out) {         \
+    const type* in = (const type*)scalars + start;                            \
+    for (size_t idx = 0; idx < count; idx++) {                                \
+      out[idx] = load(in[idx]);                                               \
+    }                                                                         \
+  }                                                                           \
+  static void nearest_row_##suffix(                                           \
+      const void* scalars, size_t row0, size_t row1, double weight,           \
+      const ext_t* u0, const ext_t* u1, const double* weights, size_t count,  \
+      double* out) {                                                          \
+    (void)row1;                                                               \
+    (void)weight;                                                             \
+    (void)u1;                                                                 \
+    (void)weights;                                                            \
+    const type* in = (const type*)scalars + row0;                             \
+    for (size_t idx = 0; idx < count; idx++) {                                \
+      out[idx] = load(in[u0[idx]]);                                           \
+    }                                                                         \
+  }                                                                           \
+  static void bilinear_row_##suffix(                                          \
+      const void* scalars, size_t row0, size_t row1, double weight,           \
+      const ext_t* u0, const ext_t* u1, const double* weights, size_t count,  \
+      double* out) {                                                          \
+    const type* top = (const type*)scalars + row0;                            \
+    const type* bottom = (const type*)scalars + row1;                         \
+    for (size_t idx = 0; idx < count; idx++) {                                \
+      double t0 = load(top[u0[idx]]);                                         \
+      double t1 = load(top[u1[idx]]);                                         \
+      double b0 = load(bottom[u0[idx]]);                                      \
+      double b1 = load(bottom[u1[idx]]);                                      \
+      double upper = t0 + (t1 - t0) * weights[idx];                           \
+      double lower = b0 + (b1 - b0) * weights[idx];                           \
+      out[idx] = upper + (lower - upper) * weight;                            \
+    }                                                                         \
+  }
+
+DEFINE_ROW_KERNELS(float64, double, LOAD_FLOAT64)
+DEFINE_ROW_KERNELS(float32, float, LOAD_FLOAT32)
+DEFINE_ROW_KERNELS(uint16, uint16_t, LOAD_UINT16)
+
+#undef DEFINE_ROW_KERNELS
+
+typedef void (*copy_row_fn)(
+    const void* scalars, size_t start, size_t count, double* out);
+typedef void (*sample_row_fn)(
+    const void* scalars, size_t row0, size_t row1, double weight,
+    const ext_t* u0, const ext_t* u1, const double* weights, size_t count,
+    double* out);
+
+// kernels indexed by scalar_storage_t
+static const copy_row_fn copy_row_kernels[] = {
+    copy_row_float64,
+    copy_row_float32,
+    copy_row_uint16,
+};
+static const sample_row_fn nearest_row_kernels[] = {
+    nearest_row_float64,
+    nearest_row_float32,
+    nearest_row_uint16,
+};
+static const sample_row_fn bilinear_row_kernels[] = {
+    bilinear_row_float64,
+    bilinear_row_float32,
+    bilinear_row_uint16,
+};
+
+/**
+ * @brief Store a row of double precision scalars into the field.
+ *
+ * @param field
+ * @param start index of the first scalar.
+ * @param values values to store.
+ * @param count number of values.
+ */
+static void store_row(
+    ScalarFieldObject* field, size_t start, const double* values,
+    size_t count) {
+  switch (field->storage) {
+    case SCALAR_STORAGE_FLOAT32: {
+      float* out = (float*)field->scalars + start;
+      for (size_t idx = 0; idx < count; idx++) {
+        out[idx] = (float)values[idx];
+      }
+    } break;
+    case SCALAR_STORAGE_UINT16: {
+      uint16_t* out = (uint16_t*)field->scalars + start;
+      for (size_t idx = 0; idx < count; idx++) {
+        out[idx] = normalize_u16(values[idx]);
+      }
+    } break;
+    case SCALAR_STORAGE_FLOAT64:
+    default: {
+      double* out = (double*)field->scalars + start;
+      if (out != values) {
+        memcpy(out, values, count * sizeof(double));
+      }
+    } break;
+  }
+}
+
+/**
+ * @brief Map a destination pixel onto the source axis.
+ *
+ * @param idx destination index along the axis.
+ * @param source number of source samples along the axis.
+ * @param destination number of destination pixels along the axis.
+ * @param filter sampling filter.
+ * @param i0 output near source index.
+ * @param i1 output far source index.
+ * @param weight output weight of the far source index.
+ */
+static inline void sample_axis(
+    ext_t idx, ext_t source, ext_t destination, sample_filter_t filter,
+    ext_t* i0, ext_t* i1, double* weight) {
+  // pixel centers are aligned so that the field stretches evenly
+  double position = ((double)idx + 0.5) * source / destination;
+  if (SAMPLE_FILTER_NEAREST == filter) {
+    ext_t nearest = (ext_t)position;
+    if (nearest >= source) {
+      nearest = source - 1;
+    }
+    *i0 = nearest;
+    *i1 = nearest;
+    *weight = 0.0;
+    return;
+  }
+
+  position -= 0.5;
+  if (position <= 0.0) {
+    *i0 = 0;
+    *i1 = 0;
+    *weight = 0.0;
+  } else if (position >= source - 1) {
+    *i0 = source - 1;
+    *i1 = source - 1;
+    *weight = 0.0;
+  } else {
+    *i0 = (ext_t)position;
+    *i1 = *i0 + 1;
+    *weight = position - *i0;
+  }
+}
+
+/**
+ * @brief Prepare a sampler for a region of a screen.
+ *
+ * @param sampler
+ * @param field the scalar field to sample.
+ * @param screen the screen across which the field is stretched.
+ * @param width width of the field data.
+ * @param height height of the field data.
+ * @param filter sampling filter used when resampling.
+ * @param region the region of the screen which will be sampled
+ *  (global coordinates must be normalized).
+ * @return int 0 on success, -EINVAL when the field is too small
+ *  and -ENOMEM when scratch memory could not be allocated.
+ */
+int ScalarField_sampler_init(
+    scalar_field_sampler_t* sampler, ScalarFieldObject* field,
+    screen_t* screen, ext_t width, ext_t height, sample_filter_t filter,
+    screen_t* region) {
+  int ret = 0;
+  if ((NULL == sampler) || (NULL == field) || (NULL == screen) ||
+      (NULL == region)) {
+    ret = -EINVAL;
+    goto out;
+  }
+
+  sampler->field = field;
+  sampler->screen = screen;
+  sampler->filter = filter;
+  sampler->width = width;
+  sampler->height = height;
+  sampler->gu0 = region->_gu0;
+  sampler->columns = region->_gu1 - region->_gu0 + 1;
+  sampler->resample = (width != screen->width) || (height != screen->height);
+  sampler->u0 = NULL;
+  sampler->u1 = NULL;
+  sampler->weights = NULL;
+  sampler->row = NULL;
+
+  if ((width <= 0) || (height <= 0) ||
+      ((size_t)width * (size_t)height > field->length)) {
+    ret = -EINVAL;
+    goto out;
+  }
+
+  // a double precision field which matches the screen is read in place
+  size_t columns = sampler->columns;
+  if (!sampler->resample) {
+    if (SCALAR_STORAGE_FLOAT64 != field->storage) {
+      sampler->row = PyMem_Malloc(columns * sizeof(double));
+      if (NULL == sampler->row) {
+        ret = -ENOMEM;
+      }
+    }
+    goto out;
+  }
+
+  // compute the horizontal mapping once for all rows
+  sampler->u0 = PyMem_Malloc(2 * columns * sizeof(ext_t));
+  sampler->weights = PyMem_Malloc(columns * sizeof(double));
+  sampler->row = PyMem_Malloc(columns * sizeof(double));
+  if ((NULL == sampler->u0) || (NULL == sampler->weights) ||
+      (NULL == sampler->row)) {
+    ScalarField_sampler_deinit(sampler);
+    ret = -ENOMEM;
+    goto out;
+  }
+  sampler->u1 = &sampler->u0[columns];
+
+  for (size_t idx = 0; idx < columns; idx++) {
+    ext_t u = sampler->gu0 + (ext_t)idx - screen->_gu0;
+    sample_axis(
+        u, width, screen->width, filter, &sampler->u0[idx], &sampler->u1[idx],
+        &sampler->weights[idx]);
+  }
+
+out:
+  return ret;
+}
+
+/**
+ * @brief Get the scalars of one row of the sampled region.
+ *
+ * @param sampler
+ * @param v global vertical coordinate of the row.
+ * @param row output pointer to the scalars of the row. The memory
+ *  is owned by the sampler and is valid until the next call.
+ * @return int
+ */
+int ScalarField_sampler_row(
+    scalar_field_sampler_t* sampler, ext_t v, double** row) {
+  int ret = 0;
+  if ((NULL == sampler) || (NULL == row)) {
+    ret = -EINVAL;
+    goto out;
+  }
+
+  screen_t* screen = sampler->screen;
+  ScalarFieldObject* field = sampler->field;
+  ext_t y = v - screen->_gv0;
+
+  if (!sampler->resample) {
+    size_t start = y * screen->width + (sampler->gu0 - screen->_gu0);
+    if (SCALAR_STORAGE_FLOAT64 == field->storage) {
+      *row = (double*)field->scalars + start;
+    } else {
+      copy_row_kernels[field->storage](
+          field->scalars, start, sampler->columns, sampler->row);
+      *row = sampler->row;
+    }
+    goto out;
+  }
+
+  ext_t v0, v1;
+  double weight;
+  sample_axis(
+      y, sampler->height, screen->height, sampler->filter, &v0, &v1, &weight);
+
+  const sample_row_fn* kernels = (SAMPLE_FILTER_NEAREST == sampler->filter)
+                                     ? nearest_row_kernels
+                                     : bilinear_row_kernels;
+  kernels[field->storage](
+      field->scalars, (size_t)v0 * sampler->width,
+      (size_t)v1 * sampler->width, weight, sampler->u0, sampler->u1,
+      sampler->weights, sampler->columns, sampler->row);
+  *row = sampler->row;
+
+out:
+  return ret;
+}
+
+/**
+ * @brief Release the scratch memory of a sampler.
+ *
+ * @param sampler
+ */
+void ScalarField_sampler_deinit(scalar_field_sampler_t* sampler) {
+  if (NULL == sampler) {
+    return;
+  }
+
+  PyMem_Free(sampler->u0);
+  PyMem_Free(sampler->weights);
+  PyMem_Free(sampler->row);
+  sampler->u0 = NULL;
+  sampler->u1 = NULL;
+  sampler->weights = NULL;
+  sampler->row = NULL;
+}
+
+/**
+ * @brief Prepare to write rows of scalars into a field.
+ *
+ * @param writer
+ * @param field the scalar field to write.
+ * @param count the maximum number of scalars in a row.
+ * @return int
+ */
+int ScalarField_writer_init(
+    scalar_field_writer_t* writer, ScalarFieldObject* field, size_t count) {
+  int ret = 0;
+  if ((NULL == writer) || (NULL == field)) {
+    ret = -EINVAL;
+    goto out;
+  }
+
+  writer->field = field;
+  writer->row = NULL;
+
+  // double precision fields are written in place
+  if (SCALAR_STORAGE_FLOAT64 != field->storage) {
+    writer->row = PyMem_Malloc(count * sizeof(double));
+    if (NULL == writer->row) {
+      ret = -ENOMEM;
+      goto out;
+    }
+  }
+
+out:
+  return ret;
+}
+
+/**
+ * @brief Get the memory into which a row of scalars is computed.
+ *
+ * @param writer
+ * @param start index of the first scalar of the row.
+ * @return double* the row memory.
+ */
+double* ScalarField_writer_row(scalar_field_writer_t* writer, size_t start) {
+  if (NULL == writer->row) {
+    return (double*)writer->field->scalars + start;
+  }
+  return writer->row;
+}
+
+/**
+ * @brief Commit a row computed into ScalarField_writer_row.
+ *
+ * @param writer
+ * @param start index of the first scalar of the row.
+ * @param count number of scalars in the row.
+ */
+void ScalarField_writer_store(
+    scalar_field_writer_t* writer, size_t start, size_t count) {
+  if (NULL == writer->row) {
+    return;
+  }
+  store_row(writer->field, start, writer->row, count);
+}
+
+/**
+ * @brief Release the scratch memory of a writer.
+ *
+ * @param writer
+ */
+void ScalarField_writer_deinit(scalar_field_writer_t* writer) {
+  if (NULL == writer) {
+    return;
+  }
+  PyMem_Free(writer->row);
+  writer->row = NULL;
+}
+
+// getset
+/////////
+
+static PyObject* get_storage(PyObject* self_in, void* closure) {
+  (void)closure;
+  ScalarFieldObject* self = (ScalarFieldObject*)self_in;
+  return PyLong_FromLong(self->storage);
+}
+
 // methods
 //////////
 
@@ -65,11 +486,16 @@ static Py_ssize_t mp_length(PyObject* self_in) {
 static PyObject* mp_subscript(PyObject* self_in, PyObject* key) {
   ScalarFieldObject* self = (ScalarFieldObject*)self_in;
   size_t idx = PyLong_AsSize_t(key);
+  if (((size_t)-1 == idx) && PyErr_Occurred()) {
+    return NULL;
+  }
   if (idx >= self->length) {
     PyErr_SetNone(PyExc_IndexError);
     return NULL;
   }
-  return PyFloat_FromDouble(self->scalars[idx]);
+  double value;
+  copy_row_kernels[self->storage](self->scalars, idx, 1, &value);
+  return PyFloat_FromDouble(value);
 }
 
 static void tp_dealloc(PyObject* self_in) {
@@ -86,51 +512,57 @@ static int tp_init(PyObject* self_in, PyObject* args, PyObject* kwds) {
   ScalarFieldObject* self = (ScalarFieldObject*)self_in;
   char* keywords[] = {
       "scalars",
+      "storage",
       NULL,
   };
   PyObject* scalars_obj;
-  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O", keywords, &scalars_obj)) {
+  int storage = SCALAR_STORAGE_FLOAT64;
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O|i", keywords, &scalars_obj, &storage)) {
+    return -1;
+  }
+  if ((SCALAR_STORAGE_FLOAT64 != storage) &&
+      (SCALAR_STORAGE_FLOAT32 != storage) &&
+      (SCALAR_STORAGE_UINT16 != storage)) {
+    PyErr_SetString(PyExc_ValueError, "unknown scalar storage");
     return -1;
   }
 
-  if (PyList_Check(scalars_obj)) {
-    size_t len = PyList_Size(scalars_obj);
+  // release any scalars from a previous initialization
+  deallocate_scalars(self);
 
-    // allocate memory for the sequence
-    int ret = allocate_scalars(self, len);
+  if (PyLong_Check(scalars_obj)) {
+    // a length creates a zeroed field, typically filled by generators
+    size_t len = PyLong_AsSize_t(scalars_obj);
+    if (PyErr_Occurred()) {
+      return -1;
+    }
+    int ret = allocate_scalars(self, len, storage);
     if (0 != ret) {
       PyErr_SetNone(PyExc_OSError);
       return -1;
     }
 
-    // copy the colors into the sequence
-    for (size_t idx = 0; idx < len; idx++) {
-      PyObject* item = PyList_GetItem(scalars_obj, idx);
-      if (!PyFloat_Check(item)) {
-        PyErr_SetNone(PyExc_TypeError);
-        return -1;
-      }
-      self->scalars[idx] = PyFloat_AsDouble(item);
-    }
-
-  } else if (PyTuple_Check(scalars_obj)) {
-    size_t len = PyTuple_Size(scalars_obj);
+  } else if (PyList_Check(scalars_obj) || PyTuple_Check(scalars_obj)) {
+    PyObject** items = PySequence_Fast_ITEMS(scalars_obj);
+    size_t len = PySequence_Fast_GET_SIZE(scalars_obj);
 
     // allocate memory for the sequence
-    int ret = allocate_scalars(self, len);
+    int ret = allocate_scalars(self, len, storage);
     if (0 != ret) {
       PyErr_SetNone(PyExc_OSError);
       return -1;
     }
 
-    // copy the colors into the sequence
+    // convert the scalars into the storage format
     for (size_t idx = 0; idx < len; idx++) {
-      PyObject* item = PyTuple_GetItem(scalars_obj, idx);
+      PyObject* item = items[idx];
       if (!PyFloat_Check(item)) {
         PyErr_SetNone(PyExc_TypeError);
         return -1;
       }
-      self->scalars[idx] = PyFloat_AsDouble(item);
+      double value = PyFloat_AsDouble(item);
+      store_row(self, idx, &value, 1);
     }
 
   } else {
@@ -146,6 +578,11 @@ static PyMappingMethods tp_as_mapping = {
     .mp_subscript = mp_subscript,
 };
 
+static PyGetSetDef tp_getset[] = {
+    {"storage", get_storage, NULL, "storage format of the scalars", NULL},
+    {NULL},
+};
+
 PyTypeObject ScalarFieldType = {
     PyVarObject_HEAD_INIT(NULL, 0).tp_name = "_sicgl_core.ScalarField",
     .tp_doc = PyDoc_STR("sicgl ScalarField"),
@@ -155,5 +592,6 @@ PyTypeObject ScalarFieldType = {
     .tp_new = PyType_GenericNew,
     .tp_dealloc = tp_dealloc,
     .tp_init = tp_init,
+    .tp_getset = tp_getset,
     .tp_as_mapping = &tp_as_mapping,
 };
@@ -0,0 +1,475 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "pysicgl/submodules/functional/drawing/target.h"
+#include "pysicgl/types/interface.h"
+#include "pysicgl/types/screen.h"
+#include "pysicgl/types/sprite_atlas.h"
+
+// utilities for C consumers
+////////////////////////////
+
+/**
+ * @brief Pack a sprite into the atlas.
+ *
+ * Sprites are placed left to right on the current shelf, a new shelf is
+ * opened beneath it when the sprite does not fit. The atlas grows taller
+ * as shelves are added.
+ *
+ * @param self
+ * @param pixels first pixel of the sprite.
+ * @param stride distance between rows of the sprite.
+ * @param width
+ * @param height
+ * @return int the id of the sprite, -EINVAL when it is wider than the atlas
+ *  or -ENOMEM when out of memory.
+ */
+int SpriteAtlas_add(
+    SpriteAtlasObject* self, const color_t* pixels, ext_t stride, ext_t width,
+    ext_t height) {
+  if ((width <= 0) || (height <= 0) || (width > self->width)) {
+    return -EINVAL;
+  }
+
+  if (self->num_sprites == self->capacity) {
+    size_t grown = (0 == self->capacity) ? 16 : 2 * self->capacity;
+    sprite_t* sprites =
+        PyMem_Realloc(self->sprites, grown * sizeof(sprite_t));
+    if (NULL == sprites) {
+      return -ENOMEM;
+    }
+    self->sprites = sprites;
+    self->capacity = grown;
+  }
+
+  ext_t u = self->shelf_u;
+  ext_t v = self->shelf_v;
+  ext_t shelf_height = self->shelf_height;
+  if (u + width > self->width) {
+    u = 0;
+    v += shelf_height;
+    shelf_height = 0;
+  }
+  if (height > shelf_height) {
+    shelf_height = height;
+  }
+  if (v + height > self->height) {
+    // at least double the height to keep adding sprites cheap
+    ext_t grown = 2 * self->height;
+    if (grown < v + height) {
+      grown = v + height;
+    }
+    color_t* memory = PyMem_Realloc(
+        self->pixels, (size_t)self->width * (size_t)grown * sizeof(color_t));
+    if (NULL == memory) {
+      return -ENOMEM;
+    }
+    memset(
+        &memory[(size_t)self->width * (size_t)self->height], 0,
+        (size_t)self->width * (size_t)(grown - self->height) *
+            sizeof(color_t));
+    self->pixels = memory;
+    self->height = grown;
+  }
+
+  for (ext_t y = 0; y < height; y++) {
+    memcpy(
+        &self->pixels[(size_t)(v + y) * (size_t)self->width + (size_t)u],
+        &pixels[(size_t)y * (size_t)stride], (size_t)width * sizeof(color_t));
+  }
+
+  self->shelf_u = u + width;
+  self->shelf_v = v;
+  self->shelf_height = shelf_height;
+  self->sprites[self->num_sprites] = (sprite_t){
+      .u = u,
+      .v = v,
+      .width = width,
+      .height = height,
+  };
+  return (int)self->num_sprites++;
+}
+
+/**
+ * @brief Draw a batch of sprites into an interface.
+ *
+ * Each sprite is clipped to the drawable region and its rows are copied, or
+ * handed to its compositor, straight out of the atlas. Clipping is done in
+ * 64 bits so that far away sprites cannot overflow.
+ *
+ * @param self
+ * @param interface
+ * @param batch sprites to draw, in order.
+ * @param count number of sprites in the batch.
+ * @param u0 drawable region in interface coordinates, inclusive.
+ * @param v0
+ * @param u1
+ * @param v1
+ */
+void SpriteAtlas_draw(
+    SpriteAtlasObject* self, interface_t* interface, const sprite_draw_t* batch,
+    size_t count, ext_t u0, ext_t v0, ext_t u1, ext_t v1) {
+  ext_t stride = interface->screen->width;
+  for (size_t idx = 0; idx < count; idx++) {
+    const sprite_draw_t* item = &batch[idx];
+    const sprite_t* sprite = &item->sprite;
+    int64_t x0 = (u0 > item->u) ? u0 - item->u : 0;
+    int64_t y0 = (v0 > item->v) ? v0 - item->v : 0;
+    int64_t x1 = (u1 - item->u < sprite->width - 1) ? u1 - item->u
+                                                    : sprite->width - 1;
+    int64_t y1 = (v1 - item->v < sprite->height - 1) ? v1 - item->v
+                                                     : sprite->height - 1;
+    if ((x0 > x1) || (y0 > y1)) {
+      continue;
+    }
+
+    size_t width = (size_t)(x1 - x0 + 1);
+    color_t* source =
+        &self->pixels
+             [(size_t)(sprite->v + y0) * (size_t)self->width +
+              (size_t)(sprite->u + x0)];
+    color_t* destination =
+        &interface->memory
+             [(size_t)(item->v + y0) * (size_t)stride +
+              (size_t)(item->u + x0)];
+    for (int64_t y = y0; y <= y1; y++) {
+      if (NULL == item->compositor) {
+        memcpy(destination, source, width * sizeof(color_t));
+      } else {
+        item->compositor->fn(
+            source, destination, width, item->compositor->args);
+      }
+      source += self->width;
+      destination += stride;
+    }
+  }
+}
+
+static int check_atlas(SpriteAtlasObject* self) {
+  if (NULL == self->names) {
+    PyErr_SetString(PyExc_ValueError, "sprite atlas is not initialized");
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Find a sprite by id or by name.
+ *
+ * @param self
+ * @param sprite_obj an int id or a str name.
+ * @return const sprite_t* the sprite, or NULL with the Python error
+ *  indicator set.
+ */
+static const sprite_t* get_sprite(
+    SpriteAtlasObject* self, PyObject* sprite_obj) {
+  if (PyUnicode_Check(sprite_obj)) {
+    PyObject* id = PyDict_GetItemWithError(self->names, sprite_obj);
+    if (NULL == id) {
+      if (!PyErr_Occurred()) {
+        PyErr_SetObject(PyExc_KeyError, sprite_obj);
+      }
+      return NULL;
+    }
+    sprite_obj = id;
+  }
+  Py_ssize_t id = PyLong_AsSsize_t(sprite_obj);
+  if ((-1 == id) && PyErr_Occurred()) {
+    return NULL;
+  }
+  if ((id < 0) || ((size_t)id >= self->num_sprites)) {
+    PyErr_SetString(PyExc_IndexError, "sprite id out of range");
+    return NULL;
+  }
+  return &self->sprites[id];
+}
+
+// getset
+/////////
+
+static PyObject* get_extent(PyObject* self_in, void* closure) {
+  (void)closure;
+  SpriteAtlasObject* self = (SpriteAtlasObject*)self_in;
+  return Py_BuildValue("(ii)", self->width, self->height);
+}
+
+static PyObject* get_names(PyObject* self_in, void* closure) {
+  (void)closure;
+  SpriteAtlasObject* self = (SpriteAtlasObject*)self_in;
+  if (NULL == self->names) {
+    Py_INCREF(Py_None);
+    return Py_None;
+  }
+  return PyDict_Copy(self->names);
+}
+
+static PyObject* get_sprites(PyObject* self_in, void* closure) {
+  (void)closure;
+  return PyLong_FromSize_t(((SpriteAtlasObject*)self_in)->num_sprites);
+}
+
+// methods
+//////////
+
+static PyObject* add(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  SpriteAtlasObject* self = (SpriteAtlasObject*)self_in;
+  InterfaceObject* interface_obj;
+  PyObject* name = Py_None;
+  char* keywords[] = {
+      "interface",
+      "name",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!|O", keywords, &InterfaceType, &interface_obj,
+          &name)) {
+    return NULL;
+  }
+  if ((Py_None != name) && !PyUnicode_Check(name)) {
+    PyErr_SetString(PyExc_TypeError, "name must be a str");
+    return NULL;
+  }
+  if (0 != check_atlas(self)) {
+    return NULL;
+  }
+
+  interface_t* interface = &interface_obj->interface;
+  if (0 != Interface_check(interface)) {
+    return NULL;
+  }
+  screen_t* screen = interface->screen;
+
+  int id = SpriteAtlas_add(
+      self, interface->memory, screen->width, screen->width, screen->height);
+  if (-ENOMEM == id) {
+    return PyErr_NoMemory();
+  } else if (id < 0) {
+    PyErr_SetString(PyExc_ValueError, "sprite does not fit in the atlas");
+    return NULL;
+  }
+
+  PyObject* id_obj = PyLong_FromLong(id);
+  if ((NULL != id_obj) && (Py_None != name) &&
+      (0 != PyDict_SetItem(self->names, name, id_obj))) {
+    Py_CLEAR(id_obj);
+  }
+  return id_obj;
+}
+
+static PyObject* sprite_extent(PyObject* self_in, PyObject* sprite_obj) {
+  SpriteAtlasObject* self = (SpriteAtlasObject*)self_in;
+  if (0 != check_atlas(self)) {
+    return NULL;
+  }
+  const sprite_t* sprite = get_sprite(self, sprite_obj);
+  if (NULL == sprite) {
+    return NULL;
+  }
+  return Py_BuildValue("(ii)", sprite->width, sprite->height);
+}
+
+static PyObject* draw(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  SpriteAtlasObject* self = (SpriteAtlasObject*)self_in;
+  InterfaceObject* interface_obj;
+  PyObject* batch_obj;
+  PyObject* screen_obj = Py_None;
+  PyObject* compositor_obj = Py_None;
+  char* keywords[] = {
+      "interface",
+      "batch",
+      "screen",
+      "compositor",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!O|OO", keywords, &InterfaceType, &interface_obj,
+          &batch_obj, &screen_obj, &compositor_obj)) {
+    return NULL;
+  }
+  if (0 != check_atlas(self)) {
+    return NULL;
+  }
+
+  screen_t* screen = NULL;
+  if (Py_None != screen_obj) {
+    if (!PyObject_TypeCheck(screen_obj, &ScreenType)) {
+      PyErr_SetString(PyExc_TypeError, "screen must be a Screen");
+      return NULL;
+    }
+    screen = ((ScreenObject*)screen_obj)->screen;
+  }
+  if ((Py_None != compositor_obj) &&
+      !PyObject_TypeCheck(compositor_obj, &CompositorType)) {
+    PyErr_SetString(PyExc_TypeError, "compositor must be a Compositor");
+    return NULL;
+  }
+  if ((Py_None != compositor_obj) &&
+      (0 != Compositor_check((CompositorObject*)compositor_obj))) {
+    return NULL;
+  }
+
+  // a private copy, since parsing the batch may run Python code which
+  // mutates the caller's sequence
+  PyObject* batch_seq = PySequence_Tuple(batch_obj);
+  if (NULL == batch_seq) {
+    return NULL;
+  }
+  PyObject* result = NULL;
+  size_t generation = self->generation;
+  size_t count = (size_t)PyTuple_GET_SIZE(batch_seq);
+  sprite_draw_t* batch = PyMem_Malloc((count + 1) * sizeof(sprite_draw_t));
+  if (NULL == batch) {
+    PyErr_NoMemory();
+    goto out;
+  }
+
+  // resolve the whole batch before the target, since parsing it may run
+  // Python code, the compositors stay referenced by the copied items
+  for (size_t idx = 0; idx < count; idx++) {
+    PyObject* item = PyTuple_GET_ITEM(batch_seq, idx);
+    PyObject* sprite_obj;
+    ext_t u, v;
+    PyObject* item_compositor = compositor_obj;
+    if (!PyTuple_Check(item)) {
+      PyErr_SetString(
+          PyExc_TypeError,
+          "batch items must be (sprite, (u, v)[, compositor])");
+      goto out;
+    }
+    if (!PyArg_ParseTuple(
+            item, "O(ii)|O", &sprite_obj, &u, &v, &item_compositor)) {
+      goto out;
+    }
+    if ((Py_None != item_compositor) &&
+        !PyObject_TypeCheck(item_compositor, &CompositorType)) {
+      PyErr_SetString(PyExc_TypeError, "compositor must be a Compositor");
+      goto out;
+    }
+    if ((Py_None != item_compositor) &&
+        (0 != Compositor_check((CompositorObject*)item_compositor))) {
+      goto out;
+    }
+    const sprite_t* sprite = get_sprite(self, sprite_obj);
+    if (NULL == sprite) {
+      goto out;
+    }
+    batch[idx].sprite = *sprite;
+    batch[idx].u = u;
+    batch[idx].v = v;
+    batch[idx].compositor = (Py_None == item_compositor)
+                                ? NULL
+                                : (CompositorObject*)item_compositor;
+  }
+  // sprites copied before a reinitialization no longer fit the pixels
+  if (generation != self->generation) {
+    PyErr_SetString(
+        PyExc_ValueError, "sprite atlas was reinitialized while drawing");
+    goto out;
+  }
+
+  draw_target_t target;
+  int ret = draw_target_init(
+      &target, &interface_obj->interface, 0, screen, NULL == screen);
+  if (ret < 0) {
+    goto out;
+  }
+  if (ret > 0) {
+    for (size_t idx = 0; idx < count; idx++) {
+      batch[idx].u += (int64_t)target.du;
+      batch[idx].v += (int64_t)target.dv;
+    }
+    SpriteAtlas_draw(
+        self, &interface_obj->interface, batch, count, target.u0, target.v0,
+        target.u1, target.v1);
+  }
+
+  Py_INCREF(Py_None);
+  result = Py_None;
+
+out:
+  PyMem_Free(batch);
+  Py_DECREF(batch_seq);
+  return result;
+}
+
+static void tp_dealloc(PyObject* self_in) {
+  SpriteAtlasObject* self = (SpriteAtlasObject*)self_in;
+  PyMem_Free(self->pixels);
+  PyMem_Free(self->sprites);
+  Py_XDECREF(self->names);
+  Py_TYPE(self)->tp_free(self);
+}
+
+static int tp_init(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  SpriteAtlasObject* self = (SpriteAtlasObject*)self_in;
+  int width = 256;
+  char* keywords[] = {
+      "width",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|i", keywords, &width)) {
+    return -1;
+  }
+  if (width <= 0) {
+    PyErr_SetString(PyExc_ValueError, "width must be positive");
+    return -1;
+  }
+
+  PyObject* names = PyDict_New();
+  if (NULL == names) {
+    return -1;
+  }
+  Py_XSETREF(self->names, names);
+  PyMem_Free(self->pixels);
+  PyMem_Free(self->sprites);
+  self->pixels = NULL;
+  self->width = width;
+  self->height = 0;
+  self->sprites = NULL;
+  self->num_sprites = 0;
+  self->capacity = 0;
+  self->shelf_v = 0;
+  self->shelf_height = 0;
+  self->shelf_u = 0;
+  self->generation++;
+
+  return 0;
+}
+
+static PyMethodDef tp_methods[] = {
+    {"add", (PyCFunction)add, METH_VARARGS | METH_KEYWORDS,
+     "copy the pixels of an interface into the atlas and return the sprite "
+     "id"},
+    {"sprite_extent", (PyCFunction)sprite_extent, METH_O,
+     "return the (width, height) of a sprite given by id or name"},
+    {"draw", (PyCFunction)draw, METH_VARARGS | METH_KEYWORDS,
+     "draw a batch of (sprite, (u, v)[, compositor]) tuples to an "
+     "interface"},
+    {NULL},
+};
+
+static PyGetSetDef tp_getset[] = {
+    {"extent", get_extent, NULL, "(width, height) of the packed pixels",
+     NULL},
+    {"names", get_names, NULL, "dict mapping sprite names to ids", NULL},
+    {"sprites", get_sprites, NULL, "number of sprites in the atlas", NULL},
+    {NULL},
+};
+
+PyTypeObject SpriteAtlasType = {
+    PyVarObject_HEAD_INIT(NULL, 0).tp_name = "_sicgl_core.SpriteAtlas",
+    .tp_doc = PyDoc_STR("packed sprites drawn in batches"),
+    .tp_basicsize = sizeof(SpriteAtlasObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = PyType_GenericNew,
+    .tp_dealloc = tp_dealloc,
+    .tp_init = tp_init,
+    .tp_getset = tp_getset,
+    .tp_methods = tp_methods,
+};
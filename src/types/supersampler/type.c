@@ -0,0 +1,455 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+// python includes first (clang-format)
+
+#include <stdint.h>
+#include <string.h>
+
+#include "pysicgl/types/supersampler.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// channels are summed two at a time in the 16 bit lanes of a word
+#define LANE_MASK (0x00FF00FFu)
+
+// lanes are divided by a reciprocal in 16.16 fixed point
+#define RECIPROCAL_SHIFT (16)
+
+// utilities for C consumers
+////////////////////////////
+
+/**
+ * @brief Box filter one row of blocks down to single pixels.
+ *
+ * Each word is split into two words holding two channels in 16 bit lanes
+ * so that four channels are summed with two additions. Kept inline so that
+ * the wrappers for common factors are compiled with a constant factor and
+ * divide with shifts.
+ *
+ * @param source first pixel of the first row of blocks.
+ * @param stride distance between rows of the source.
+ * @param factor width and height of each block.
+ * @param count number of output pixels.
+ * @param out output row.
+ */
+static inline void downsample_row(
+    const color_t* source, ext_t stride, ext_t factor, size_t count,
+    color_t* out) {
+  const uint32_t samples = (uint32_t)(factor * factor);
+  const uint32_t reciprocal =
+      ((1u << RECIPROCAL_SHIFT) + samples / 2) / samples;
+  const uint32_t half_lanes = (samples / 2) * 0x00010001u;
+  for (size_t idx = 0; idx < count; idx++) {
+    const color_t* block = &source[idx * factor];
+    uint32_t even = 0;
+    uint32_t odd = 0;
+    for (ext_t y = 0; y < factor; y++) {
+      const color_t* row = &block[y * stride];
+      for (ext_t x = 0; x < factor; x++) {
+        uint32_t color = (uint32_t)row[x];
+        even += color & LANE_MASK;
+        odd += (color >> 8) & LANE_MASK;
+      }
+    }
+    if (0 == (samples & (samples - 1))) {
+      // powers of two divide every lane at once
+      uint32_t shift = (2 == factor) ? 2 : (4 == factor) ? 4 : 6;
+      even = ((even + half_lanes) >> shift) & LANE_MASK;
+      odd = ((odd + half_lanes) >> shift) & LANE_MASK;
+    } else {
+      const uint32_t round = 1u << (RECIPROCAL_SHIFT - 1);
+      even = (((even & 0xFFFF) * reciprocal + round) >> RECIPROCAL_SHIFT) |
+             ((((even >> 16) * reciprocal + round) >> RECIPROCAL_SHIFT)
+              << 16);
+      odd = (((odd & 0xFFFF) * reciprocal + round) >> RECIPROCAL_SHIFT) |
+            ((((odd >> 16) * reciprocal + round) >> RECIPROCAL_SHIFT) << 16);
+    }
+    out[idx] = (color_t)(even | (odd << 8));
+  }
+}
+
+typedef void (*downsample_row_fn)(
+    const color_t* source, ext_t stride, ext_t factor, size_t count,
+    color_t* out);
+
+#if defined(__SSE2__)
+/**
+ * @brief Box filter one row of 2x2 blocks with SSE2.
+ *
+ * Two blocks are filtered per iteration. Their pixels are widened to 16
+ * bit lanes, the rows and then the columns of each block are added, and
+ * the rounded averages are narrowed back to bytes. The results match
+ * downsample_row exactly.
+ */
+static void downsample_row_2(
+    const color_t* source, ext_t stride, ext_t factor, size_t count,
+    color_t* out) {
+  (void)factor;
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i round = _mm_set1_epi16(2);
+  size_t idx = 0;
+  for (; idx + 2 <= count; idx += 2) {
+    const color_t* upper = &source[2 * idx];
+    __m128i top = _mm_loadu_si128((const __m128i*)upper);
+    __m128i bottom = _mm_loadu_si128((const __m128i*)&upper[stride]);
+    __m128i left = _mm_add_epi16(
+        _mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+    __m128i right = _mm_add_epi16(
+        _mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+    left = _mm_add_epi16(left, _mm_srli_si128(left, 8));
+    right = _mm_add_epi16(right, _mm_srli_si128(right, 8));
+    __m128i sums = _mm_unpacklo_epi64(left, right);
+    sums = _mm_srli_epi16(_mm_add_epi16(sums, round), 2);
+    _mm_storel_epi64((__m128i*)&out[idx], _mm_packus_epi16(sums, zero));
+  }
+  if (idx < count) {
+    downsample_row(&source[2 * idx], stride, 2, count - idx, &out[idx]);
+  }
+}
+
+/**
+ * @brief Box filter one row of 4x4 blocks with SSE2.
+ *
+ * Each row of a block is one load, the sixteen samples of every channel
+ * are summed in 16 bit lanes.
+ */
+static void downsample_row_4(
+    const color_t* source, ext_t stride, ext_t factor, size_t count,
+    color_t* out) {
+  (void)factor;
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i round = _mm_set1_epi16(8);
+  for (size_t idx = 0; idx < count; idx++) {
+    const color_t* block = &source[4 * idx];
+    __m128i sums = zero;
+    for (ext_t y = 0; y < 4; y++) {
+      __m128i row = _mm_loadu_si128((const __m128i*)&block[y * stride]);
+      sums = _mm_add_epi16(sums, _mm_unpacklo_epi8(row, zero));
+      sums = _mm_add_epi16(sums, _mm_unpackhi_epi8(row, zero));
+    }
+    sums = _mm_add_epi16(sums, _mm_srli_si128(sums, 8));
+    sums = _mm_srli_epi16(_mm_add_epi16(sums, round), 4);
+    out[idx] = (color_t)_mm_cvtsi128_si32(_mm_packus_epi16(sums, zero));
+  }
+}
+#else
+static void downsample_row_2(
+    const color_t* source, ext_t stride, ext_t factor, size_t count,
+    color_t* out) {
+  (void)factor;
+  downsample_row(source, stride, 2, count, out);
+}
+
+static void downsample_row_4(
+    const color_t* source, ext_t stride, ext_t factor, size_t count,
+    color_t* out) {
+  (void)factor;
+  downsample_row(source, stride, 4, count, out);
+}
+#endif
+
+static void downsample_row_any(
+    const color_t* source, ext_t stride, ext_t factor, size_t count,
+    color_t* out) {
+  downsample_row(source, stride, factor, count, out);
+}
+
+/**
+ * @brief Check that a supersampler has been initialized.
+ *
+ * @param self
+ * @return int 0 when valid, -1 with the Python error indicator set.
+ */
+static int check_sampler(SupersamplerObject* self) {
+  if (NULL == self->interface) {
+    PyErr_SetString(PyExc_ValueError, "supersampler is not initialized");
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Box filter the supersampled interface down onto an interface.
+ *
+ * The supersampled screen is placed where the target screen was when the
+ * sampler was made, output is clipped to the destination interface.
+ *
+ * The interpreter lock is released while filtering. The supersampled
+ * interface is held for the call, the destination must stay valid until
+ * this returns, see Interface_hold.
+ *
+ * @param self
+ * @param interface destination interface.
+ * @param compositor compositor, or NULL to copy the filtered pixels.
+ * @return int 0 on success, -1 with the Python error indicator set.
+ */
+int Supersampler_resolve(
+    SupersamplerObject* self, interface_t* interface,
+    CompositorObject* compositor) {
+  int ret = 0;
+  color_t* row = NULL;
+  if ((0 != check_sampler(self)) || (0 != Interface_check(interface))) {
+    return -1;
+  }
+  interface_hold_t hold;
+  if (0 != Interface_hold(self->interface, &hold)) {
+    return -1;
+  }
+
+  // the sampler may be initialized again by another thread
+  ext_t factor = self->factor;
+  ext_t origin_u = self->u0;
+  ext_t origin_v = self->v0;
+  ext_t width = self->width;
+  ext_t height = self->height;
+
+  screen_t* screen = interface->screen;
+  interface_t* source = &hold.interface;
+  ext_t stride = width * factor;
+  if ((size_t)stride * (size_t)(height * factor) > source->length) {
+    PyErr_SetString(PyExc_ValueError, "supersampled memory is too small");
+    ret = -1;
+    goto out;
+  }
+
+  // the target in global coordinates clipped to the destination
+  ext_t u0 = (origin_u > screen->_gu0) ? origin_u : screen->_gu0;
+  ext_t v0 = (origin_v > screen->_gv0) ? origin_v : screen->_gv0;
+  ext_t u1 = origin_u + width - 1;
+  ext_t v1 = origin_v + height - 1;
+  if (u1 > screen->_gu1) {
+    u1 = screen->_gu1;
+  }
+  if (v1 > screen->_gv1) {
+    v1 = screen->_gv1;
+  }
+  if ((u0 > u1) || (v0 > v1)) {
+    goto out;
+  }
+
+  downsample_row_fn row_fn = (2 == factor)   ? downsample_row_2
+                             : (4 == factor) ? downsample_row_4
+                                             : downsample_row_any;
+  size_t count = (size_t)(u1 - u0 + 1);
+  if (NULL != compositor) {
+    row = PyMem_Malloc(count * sizeof(color_t));
+    if (NULL == row) {
+      PyErr_NoMemory();
+      ret = -1;
+      goto out;
+    }
+  }
+
+  Py_BEGIN_ALLOW_THREADS;
+  for (ext_t v = v0; v <= v1; v++) {
+    const color_t* blocks =
+        &source->memory
+             [(v - origin_v) * factor * stride + (u0 - origin_u) * factor];
+    color_t* output = &interface->memory
+                           [(v - screen->_gv0) * screen->width +
+                            (u0 - screen->_gu0)];
+    if (NULL == compositor) {
+      row_fn(blocks, stride, factor, count, output);
+    } else {
+      row_fn(blocks, stride, factor, count, row);
+      compositor->fn(row, output, count, compositor->args);
+    }
+  }
+  Py_END_ALLOW_THREADS;
+
+out:
+  PyMem_Free(row);
+  Interface_release(&hold);
+  return ret;
+}
+
+// getset
+/////////
+
+static PyObject* get_interface(PyObject* self_in, void* closure) {
+  (void)closure;
+  SupersamplerObject* self = (SupersamplerObject*)self_in;
+  PyObject* interface =
+      (NULL == self->interface) ? Py_None : (PyObject*)self->interface;
+  Py_INCREF(interface);
+  return interface;
+}
+
+static PyObject* get_screen(PyObject* self_in, void* closure) {
+  (void)closure;
+  SupersamplerObject* self = (SupersamplerObject*)self_in;
+  PyObject* screen =
+      (NULL == self->screen) ? Py_None : (PyObject*)self->screen;
+  Py_INCREF(screen);
+  return screen;
+}
+
+static PyObject* get_factor(PyObject* self_in, void* closure) {
+  (void)closure;
+  return PyLong_FromLong(((SupersamplerObject*)self_in)->factor);
+}
+
+// methods
+//////////
+
+static PyObject* clear(PyObject* self_in, PyObject* args) {
+  SupersamplerObject* self = (SupersamplerObject*)self_in;
+  color_t color = 0;
+  if (!PyArg_ParseTuple(args, "|i", &color)) {
+    return NULL;
+  }
+  if (0 != check_sampler(self)) {
+    return NULL;
+  }
+
+  interface_t* interface = &self->interface->interface;
+  for (size_t idx = 0; idx < interface->length; idx++) {
+    interface->memory[idx] = color;
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static PyObject* resolve(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  SupersamplerObject* self = (SupersamplerObject*)self_in;
+  InterfaceObject* interface_obj;
+  PyObject* compositor_obj = Py_None;
+  char* keywords[] = {
+      "interface",
+      "compositor",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!|O", keywords, &InterfaceType, &interface_obj,
+          &compositor_obj)) {
+    return NULL;
+  }
+
+  CompositorObject* compositor = NULL;
+  if (Py_None != compositor_obj) {
+    if (!PyObject_TypeCheck(compositor_obj, &CompositorType)) {
+      PyErr_SetString(PyExc_TypeError, "compositor must be a Compositor");
+      return NULL;
+    }
+    compositor = (CompositorObject*)compositor_obj;
+    if (0 != Compositor_check(compositor)) {
+      return NULL;
+    }
+  }
+
+  interface_hold_t hold;
+  if (0 != Interface_hold(interface_obj, &hold)) {
+    return NULL;
+  }
+  int ret = Supersampler_resolve(self, &hold.interface, compositor);
+  Interface_release(&hold);
+  if (0 != ret) {
+    return NULL;
+  }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static void tp_dealloc(PyObject* self_in) {
+  SupersamplerObject* self = (SupersamplerObject*)self_in;
+  Py_XDECREF(self->screen);
+  Py_XDECREF(self->interface);
+  Py_TYPE(self)->tp_free(self);
+}
+
+static int tp_init(PyObject* self_in, PyObject* args, PyObject* kwds) {
+  SupersamplerObject* self = (SupersamplerObject*)self_in;
+  int ret = 0;
+  ScreenObject* screen_obj;
+  int factor = 2;
+  PyObject* screen = NULL;
+  PyObject* memory = NULL;
+  PyObject* interface = NULL;
+  char* keywords[] = {
+      "screen",
+      "factor",
+      NULL,
+  };
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O!|i", keywords, &ScreenType, &screen_obj, &factor)) {
+    return -1;
+  }
+  if ((factor < 2) || (factor > SUPERSAMPLER_MAX_FACTOR)) {
+    PyErr_Format(
+        PyExc_ValueError, "factor must be in the range [2, %d]",
+        SUPERSAMPLER_MAX_FACTOR);
+    return -1;
+  }
+
+  // mirror the target screen at a higher resolution in global coordinates
+  screen_t* target = screen_obj->screen;
+  screen = PyObject_CallFunction(
+      (PyObject*)&ScreenType, "(ii)(ii)", target->width * factor,
+      target->height * factor, target->_gu0 * factor, target->_gv0 * factor);
+  if (NULL == screen) {
+    ret = -1;
+    goto out;
+  }
+  size_t pixels = (size_t)target->width * (size_t)target->height *
+                  (size_t)factor * (size_t)factor;
+  memory = PyByteArray_FromStringAndSize(NULL, pixels * sizeof(color_t));
+  if (NULL == memory) {
+    ret = -1;
+    goto out;
+  }
+  memset(PyByteArray_AS_STRING(memory), 0, pixels * sizeof(color_t));
+  interface = PyObject_CallFunction(
+      (PyObject*)&InterfaceType, "OO", screen, memory);
+  if (NULL == interface) {
+    ret = -1;
+    goto out;
+  }
+  Py_INCREF(screen_obj);
+  Py_XSETREF(self->screen, screen_obj);
+  Py_XSETREF(self->interface, (InterfaceObject*)interface);
+  interface = NULL;
+  self->factor = factor;
+  self->u0 = target->_gu0;
+  self->v0 = target->_gv0;
+  self->width = target->width;
+  self->height = target->height;
+
+out:
+  Py_XDECREF(screen);
+  Py_XDECREF(memory);
+  Py_XDECREF(interface);
+  return ret;
+}
+
+static PyMethodDef tp_methods[] = {
+    {"clear", (PyCFunction)clear, METH_VARARGS,
+     "fill the supersampled interface with a color, zero by default"},
+    {"resolve", (PyCFunction)resolve, METH_VARARGS | METH_KEYWORDS,
+     "box filter the supersampled interface down onto an interface"},
+    {NULL},
+};
+
+static PyGetSetDef tp_getset[] = {
+    {"interface", get_interface, NULL,
+     "the interface to draw into at the higher resolution", NULL},
+    {"screen", get_screen, NULL, "the screen which is supersampled", NULL},
+    {"factor", get_factor, NULL, "supersampling factor on each axis", NULL},
+    {NULL},
+};
+
+PyTypeObject SupersamplerType = {
+    PyVarObject_HEAD_INIT(NULL, 0).tp_name = "_sicgl_core.Supersampler",
+    .tp_doc = PyDoc_STR("draws at a higher resolution and filters it down"),
+    .tp_basicsize = sizeof(SupersamplerObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = PyType_GenericNew,
+    .tp_dealloc = tp_dealloc,
+    .tp_init = tp_init,
+    .tp_getset = tp_getset,
+    .tp_methods = tp_methods,
+};
@@ -0,0 +1,77 @@
+import threading
+
+import pytest
+import pysicgl
+from tests.testutils import make_interface, rgba
+
+
+def test_bloom_parameters():
+    bloom = pysicgl.Bloom(threshold=0.5, intensity=2.0, levels=3, radius=1)
+    assert bloom.threshold == 0.5
+    assert bloom.intensity == 2.0
+    assert bloom.levels == 3
+    assert bloom.radius == 1
+
+    with pytest.raises(ValueError):
+        pysicgl.Bloom(levels=0)
+    with pytest.raises(ValueError):
+        pysicgl.Bloom(radius=-1)
+
+
+def test_bloom_below_threshold():
+    interface = make_interface((16, 16))
+    gray = pysicgl.functional.color_from_rgba((64, 64, 64, 255))
+    pysicgl.functional.interface_fill(interface, gray)
+    before = bytes(interface.memory)
+
+    pysicgl.Bloom(threshold=0.5).apply(interface)
+    assert bytes(interface.memory) == before
+
+
+def test_bloom_spreads_glow():
+    interface = make_interface((32, 32))
+    black = pysicgl.functional.color_from_rgba((0, 0, 0, 255))
+    white = pysicgl.functional.color_from_rgba((255, 255, 255, 255))
+    pysicgl.functional.interface_fill(interface, black)
+    for u in range(14, 18):
+        for v in range(14, 18):
+            pysicgl.functional.interface_pixel(interface, white, (u, v))
+
+    bloom = pysicgl.Bloom(threshold=0.5, intensity=1.0, levels=2)
+    bloom.apply(interface)
+
+    # the glow reaches dark pixels near the bright square but not the corners
+    assert rgba(interface, (12, 15))[0] > 0
+    assert rgba(interface, (0, 0)) == (0, 0, 0, 255)
+    assert rgba(interface, (15, 15)) == (255, 255, 255, 255)
+
+    # the same object may be reused for an interface of a different extent
+    small = make_interface((5, 3))
+    pysicgl.functional.interface_fill(small, white)
+    bloom.apply(small)
+    assert rgba(small, (2, 1)) == (255, 255, 255, 255)
+
+
+def test_bloom_from_threads():
+    bloom = pysicgl.Bloom(threshold=0.0, levels=3)
+    white = pysicgl.functional.color_from_rgba((255, 255, 255, 255))
+
+    results = []
+
+    # applications on other threads take their own scratch memory
+    def apply(extent):
+        interface = make_interface(extent)
+        for _ in range(20):
+            pysicgl.functional.interface_fill(interface, white)
+            bloom.apply(interface)
+            results.append(rgba(interface, (0, 0)))
+
+    threads = [
+        threading.Thread(target=apply, args=(extent,))
+        for extent in ((64, 48), (17, 9), (128, 4))
+    ]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    assert results == [(255, 255, 255, 255)] * 60
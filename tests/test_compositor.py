@@ -1,3 +1,4 @@
+import pytest
 import pysicgl
 
 
@@ -48,3 +49,151 @@ def test_builtin_compositors():
         assert hasattr(pysicgl.composition, compositor_name)
         compositor = getattr(pysicgl.composition, compositor_name)
         assert isinstance(compositor, pysicgl.Compositor)
+
+
+def test_parameterized_compositors():
+    screen = pysicgl.Screen((2, 1))
+    interface = pysicgl.Interface(
+        screen, pysicgl.allocate_pixel_memory(screen.pixels)
+    )
+    background = pysicgl.functional.color_from_rgba((10, 20, 30, 40))
+    sprite = pysicgl.functional.color_from_rgba((100, 200, 100, 255))
+    sprite_memory = pysicgl.allocate_pixel_memory(screen.pixels)
+    sprite_interface = pysicgl.Interface(screen, sprite_memory)
+    pysicgl.functional.interface_fill(sprite_interface, sprite)
+
+    def compose(compositor):
+        pysicgl.functional.interface_fill(interface, background)
+        pysicgl.functional.compose(interface, screen, sprite_memory, compositor)
+        return pysicgl.functional.color_to_rgba(
+            pysicgl.functional.get_pixel_at_offset(interface, 0)
+        )
+
+    half = pysicgl.Compositor(pysicgl.composition.DIRECT_SET, opacity=0.5)
+    assert half.base is pysicgl.composition.DIRECT_SET
+    assert half.opacity == 0.5
+    assert compose(half) == (50, 100, 50, 255)
+
+    red = pysicgl.functional.color_from_rgba((255, 0, 0, 0))
+    fill = pysicgl.Compositor(pysicgl.composition.DIRECT_SET, color=red)
+    assert fill.color == red
+    assert compose(fill) == (255, 0, 0, 0)
+
+    mask = pysicgl.functional.color_from_rgba((0, 255, 0, 0))
+    green_only = pysicgl.Compositor(
+        pysicgl.composition.CHANNEL_SUM_CLAMPED, opacity=0.25, mask=mask
+    )
+    assert compose(green_only) == (10, 70, 30, 40)
+
+    # parameterized compositors may be wrapped again
+    nested = pysicgl.Compositor(half, opacity=0.5)
+    assert compose(nested) == (25, 50, 25, 255)
+
+    # masks are unsigned and may use every bit of a color
+    full = pysicgl.Compositor(pysicgl.composition.DIRECT_SET, mask=0xFFFFFFFF)
+    assert full.mask == 0xFFFFFFFF
+    assert compose(full) == (100, 200, 100, 255)
+
+
+def test_compositor_errors():
+    screen = pysicgl.Screen((1, 1))
+    interface = pysicgl.Interface(
+        screen, pysicgl.allocate_pixel_memory(screen.pixels)
+    )
+    bare = pysicgl.Compositor.__new__(pysicgl.Compositor)
+    with pytest.raises(ValueError):
+        pysicgl.functional.interface_compose(interface, (0, 0), interface, bare)
+    with pytest.raises(ValueError):
+        pysicgl.Compositor(bare)
+
+    # a compositor may not end up wrapping itself
+    outer = pysicgl.Compositor(pysicgl.composition.DIRECT_SET)
+    inner = pysicgl.Compositor(outer)
+    with pytest.raises(ValueError):
+        outer.__init__(outer)
+    with pytest.raises(ValueError):
+        outer.__init__(inner)
+    assert outer.base is pysicgl.composition.DIRECT_SET
+
+    # opacity scales colors and must be a finite, non-negative number
+    for opacity in (-1.0, float("nan"), float("inf")):
+        with pytest.raises(ValueError):
+            pysicgl.Compositor(pysicgl.composition.DIRECT_SET, opacity=opacity)
+
+
+def test_specialized_compositors():
+    screen = pysicgl.Screen((3, 1))
+    interface = pysicgl.Interface(
+        screen, pysicgl.allocate_pixel_memory(screen.pixels)
+    )
+    source = pysicgl.functional.color_from_rgba((0x0F, 0xF0, 0x55, 0x7F))
+    destination = pysicgl.functional.color_from_rgba((0x3C, 0x18, 0xAA, 0x01))
+    sprite = pysicgl.allocate_pixel_memory(screen.pixels)
+    pysicgl.functional.interface_fill(pysicgl.Interface(screen, sprite), source)
+
+    def channels(color):
+        return pysicgl.functional.color_to_rgba(color)
+
+    expected = {
+        "DIRECT_SET": source,
+        "DIRECT_CLEAR": 0,
+        "DIRECT_NONE": destination,
+        "BIT_AND": source & destination,
+        "BIT_OR": source | destination,
+        "BIT_XOR": source ^ destination,
+        "BIT_NAND": ~(source & destination),
+        "BIT_NOR": ~(source | destination),
+        "BIT_XNOR": ~(source ^ destination),
+        "CHANNEL_MIN": pysicgl.functional.color_from_rgba(
+            tuple(map(min, channels(source), channels(destination)))
+        ),
+        "CHANNEL_MAX": pysicgl.functional.color_from_rgba(
+            tuple(map(max, channels(source), channels(destination)))
+        ),
+    }
+    for name, color in expected.items():
+        assert isinstance(pysicgl.composition.generic[name], pysicgl.Compositor)
+        pysicgl.functional.interface_fill(interface, destination)
+        compositor = getattr(pysicgl.composition, name)
+        pysicgl.functional.compose(interface, screen, sprite, compositor)
+        for offset in range(screen.pixels):
+            pixel = pysicgl.functional.get_pixel_at_offset(interface, offset)
+            assert channels(pixel) == channels(color)
+
+
+def test_premultiplied_alpha():
+    screen = pysicgl.Screen((1, 1))
+    interface = pysicgl.Interface(
+        screen, pysicgl.allocate_pixel_memory(screen.pixels)
+    )
+    sprite = pysicgl.allocate_pixel_memory(screen.pixels)
+    sprite_interface = pysicgl.Interface(screen, sprite)
+
+    def pixel(target):
+        return pysicgl.functional.color_to_rgba(
+            pysicgl.functional.get_pixel_at_offset(target, 0)
+        )
+
+    # conversion to premultiplied alpha and back
+    straight = pysicgl.functional.color_from_rgba((200, 100, 50, 128))
+    pysicgl.functional.interface_fill(sprite_interface, straight)
+    pysicgl.functional.premultiply_alpha(sprite_interface)
+    assert pixel(sprite_interface) == (100, 50, 25, 128)
+    pysicgl.functional.unpremultiply_alpha(sprite_interface)
+    assert pixel(sprite_interface) == (199, 100, 50, 128)
+
+    # half transparent red over opaque blue
+    source = pysicgl.functional.color_from_rgba((128, 0, 0, 128))
+    destination = pysicgl.functional.color_from_rgba((0, 0, 255, 255))
+    pysicgl.functional.interface_fill(sprite_interface, source)
+    pysicgl.functional.interface_fill(interface, destination)
+    pysicgl.functional.compose(
+        interface, screen, sprite, pysicgl.composition.PREMULTIPLIED_SOURCE_OVER
+    )
+    assert pixel(interface) == (128, 0, 127, 255)
+
+    pysicgl.functional.interface_fill(interface, destination)
+    pysicgl.functional.compose(
+        interface, screen, sprite, pysicgl.composition.PREMULTIPLIED_DESTINATION_OUT
+    )
+    assert pixel(interface) == (0, 0, 127, 127)
@@ -0,0 +1,208 @@
+import pytest
+import pysicgl
+from tests.testutils import make_interface, rgba
+
+BDF = """STARTFONT 2.1
+FONT -test-tiny
+SIZE 4 75 75
+FONTBOUNDINGBOX 3 4 0 -1
+STARTPROPERTIES 3
+FONT_ASCENT 3
+FONT_DESCENT 1
+DEFAULT_CHAR 63
+ENDPROPERTIES
+CHARS 3
+STARTCHAR question
+ENCODING 63
+DWIDTH 4 0
+BBX 3 3 0 0
+BITMAP
+E0
+20
+40
+ENDCHAR
+STARTCHAR A
+ENCODING 65
+DWIDTH 4 0
+BBX 3 3 0 0
+BITMAP
+40
+E0
+A0
+ENDCHAR
+STARTCHAR g
+ENCODING 103
+DWIDTH 3 0
+BBX 2 3 0 -1
+BITMAP
+C0
+40
+80
+ENDCHAR
+ENDFONT
+"""
+
+
+def lit(interface):
+    width, height = interface.screen.extent
+    return {
+        (u, v)
+        for v in range(height)
+        for u in range(width)
+        if rgba(interface, (u, v))[3] != 0
+    }
+
+
+def test_font_from_bdf():
+    font = pysicgl.Font.from_bdf(BDF)
+    assert font.glyphs == 3
+    assert font.ascent == 3
+    assert font.descent == 1
+    assert font.line_height == 4
+
+    assert font.measure("A") == (4, 4)
+    assert font.measure("Ag") == (7, 4)
+    assert font.measure("A\nAA") == (8, 8)
+    # missing glyphs are drawn with the default character
+    assert font.measure("Z") == font.measure("?")
+
+    with pytest.raises(ValueError):
+        pysicgl.Font.from_bdf("STARTFONT 2.1\nENDFONT\n")
+    with pytest.raises(TypeError):
+        font.measure(b"A")
+
+
+def test_font_from_bdf_errors():
+    # a bitmap with too few rows ends at ENDCHAR and keeps the next glyph
+    short = BDF.replace("BITMAP\nE0\n20\n40\n", "BITMAP\nE0\n", 1)
+    font = pysicgl.Font.from_bdf(short)
+    assert font.glyphs == 3
+    assert font.measure("A") == (4, 4)
+    interface = make_interface((8, 8))
+    white = pysicgl.functional.color_from_rgba((255, 255, 255, 255))
+    pysicgl.functional.interface_text(interface, font, white, (0, 0), "?A")
+    assert lit(interface) == {(0, 0), (1, 0), (2, 0), (5, 0)} | {
+        (4, 1),
+        (5, 1),
+        (6, 1),
+        (4, 2),
+        (6, 2),
+    }
+
+    # sizes and offsets which do not fit a glyph are rejected
+    for line in [
+        "BBX 3 4294967296 0 0",
+        "BBX 2147483648 3 0 0",
+        "BBX 3 3 -2147483648 0",
+        "BBX -1 3 0 0",
+    ]:
+        with pytest.raises(ValueError):
+            pysicgl.Font.from_bdf(BDF.replace("BBX 3 3 0 0", line, 1))
+    with pytest.raises(ValueError):
+        pysicgl.Font.from_bdf(BDF.replace("DWIDTH 4 0", "DWIDTH 9999999999 0", 1))
+    with pytest.raises(ValueError):
+        pysicgl.Font.from_bdf(
+            BDF.replace("FONTBOUNDINGBOX 3 4 0 -1", "FONTBOUNDINGBOX 3 99999 0 -1")
+        )
+
+
+def test_font_packed():
+    # a 3x2 glyph for "a" and an empty glyph for "b"
+    font = pysicgl.Font(bytes([0xA0, 0x40, 0x00, 0x00]), (3, 2), first=97)
+    assert font.glyphs == 2
+    assert font.line_height == 2
+    assert font.measure("ab") == (6, 2)
+
+    font = pysicgl.Font(bytes([0xA0, 0x40]), (3, 2), first=97, spacing=1)
+    assert font.measure("aa") == (8, 2)
+
+    with pytest.raises(ValueError):
+        pysicgl.Font(b"\x00", (0, 2))
+
+    # sizes are bounded like those of BDF fonts, and so is the run of a string
+    with pytest.raises(ValueError):
+        pysicgl.Font(b"\x00", (1, 99999))
+    with pytest.raises(ValueError):
+        pysicgl.Font(b"\x00", (1, 1), spacing=-99999)
+    font = pysicgl.Font(b"\x00", (1, 1), first=97, spacing=32766)
+    assert font.measure("aa") == (65534, 1)
+    with pytest.raises(ValueError):
+        font.measure("a" * 70000)
+
+
+def test_text_drawing():
+    font = pysicgl.Font.from_bdf(BDF)
+    white = pysicgl.functional.color_from_rgba((255, 255, 255, 255))
+
+    interface = make_interface((8, 8))
+    pysicgl.functional.interface_text(interface, font, white, (1, 2), "A")
+    assert lit(interface) == {(2, 2), (1, 3), (2, 3), (3, 3), (1, 4), (3, 4)}
+    assert rgba(interface, (2, 2)) == (255, 255, 255, 255)
+
+    # the descender of "g" reaches below the baseline
+    interface = make_interface((8, 8))
+    pysicgl.functional.interface_text(interface, font, white, (0, 0), "g")
+    assert lit(interface) == {(0, 1), (1, 1), (1, 2), (0, 3)}
+
+    # drawing in global coordinates and clipping to the interface
+    interface = make_interface((4, 4), (10, 10))
+    pysicgl.functional.global_text(interface, font, white, (9, 10), "A")
+    assert lit(interface) == {(0, 0), (0, 1), (1, 1), (1, 2)}
+
+    # a screen offsets the text and clips it
+    interface = make_interface((8, 8))
+    screen = pysicgl.Screen((2, 8), (4, 0))
+    pysicgl.functional.screen_text(interface, screen, font, white, (0, 0), "A")
+    assert lit(interface) == {(5, 0), (4, 1), (5, 1), (4, 2)}
+
+    # positions at the limits of ext_t are clipped without overflowing
+    interface = make_interface((8, 8))
+    for position in [(-(2**31), 0), (2**31 - 1, 0), (0, -(2**31)), (0, 2**31 - 1)]:
+        pysicgl.functional.interface_text(interface, font, white, position, "AAAA")
+        pysicgl.functional.interface_text(
+            interface,
+            font,
+            white,
+            position,
+            "AAAA",
+            compositor=pysicgl.composition.BIT_OR,
+        )
+    shifted = make_interface((8, 8), (2**31 - 8, 2**31 - 8))
+    pysicgl.functional.global_text(shifted, font, white, (-(2**31), 0), "AAAA")
+    assert lit(interface) == lit(shifted) == set()
+
+
+def test_text_compositor():
+    font = pysicgl.Font.from_bdf(BDF)
+    red = pysicgl.functional.color_from_rgba((255, 0, 0, 255))
+    blue = pysicgl.functional.color_from_rgba((0, 0, 255, 255))
+
+    interface = make_interface((8, 8))
+    pysicgl.functional.interface_fill(interface, blue)
+    compositor = pysicgl.composition.BIT_OR
+    pysicgl.functional.interface_text(
+        interface, font, red, (0, 0), "A", compositor=compositor
+    )
+    assert rgba(interface, (1, 0)) == (255, 0, 255, 255)
+    assert rgba(interface, (0, 0)) == (0, 0, 255, 255)
+
+    with pytest.raises(TypeError):
+        pysicgl.functional.interface_text(
+            interface, font, red, (0, 0), "A", compositor=1
+        )
+
+
+def test_text_run_cache():
+    font = pysicgl.Font.from_bdf(BDF)
+    white = pysicgl.functional.color_from_rgba((255, 255, 255, 255))
+    first = make_interface((8, 8))
+    second = make_interface((8, 8))
+
+    # the same string drawn from the cache and after clearing it
+    pysicgl.functional.interface_text(first, font, white, (0, 0), "AA")
+    for idx in range(40):
+        font.measure(str(idx))
+    font.measure("AA")
+    font.clear_cache()
+    pysicgl.functional.interface_text(second, font, white, (0, 0), "AA")
+    assert lit(first) == lit(second)
@@ -1,6 +1,11 @@
+import sys
+import threading
+
 import pytest
 import pysicgl
 
+from tests.testutils import make_interface
+
 
 def test_module_exists():
     assert hasattr(pysicgl, "functional")
@@ -16,3 +21,848 @@ def test_has_get_pixel_at_offset():
 
 def test_has_get_pixel_at_coordinates():
     assert hasattr(pysicgl.functional, "get_pixel_at_coordinates")
+
+
+def test_scalar_field_compose():
+    screen = pysicgl.Screen((4, 2))
+    memory = pysicgl.allocate_pixel_memory(screen.pixels)
+    interface = pysicgl.Interface(screen, memory)
+
+    color = pysicgl.functional.color_from_rgba((10, 20, 30, 40))
+    sequence = pysicgl.ColorSequence(
+        colors=[color], interpolator=pysicgl.interpolation.DISCRETE_LINEAR
+    )
+    field = pysicgl.ScalarField([0.0] * screen.pixels)
+
+    pysicgl.functional.scalar_field_compose(
+        interface, screen, field, sequence, pysicgl.composition.DIRECT_SET
+    )
+    for offset in range(screen.pixels):
+        assert pysicgl.functional.get_pixel_at_offset(interface, offset) == color
+
+    # memory which does not cover the screen is rejected
+    large = pysicgl.Screen((512, 512))
+    undersized = pysicgl.Interface(large, bytearray(4))
+    with pytest.raises(ValueError):
+        pysicgl.functional.scalar_field_compose(
+            undersized,
+            large,
+            pysicgl.ScalarField([0.0] * large.pixels),
+            sequence,
+            pysicgl.composition.DIRECT_SET,
+        )
+
+
+def test_scalar_field_extent():
+    screen = pysicgl.Screen((4, 2))
+    memory = pysicgl.allocate_pixel_memory(screen.pixels)
+    interface = pysicgl.Interface(screen, memory)
+
+    colors = [
+        pysicgl.functional.color_from_rgba((value, value, value, 255))
+        for value in (0, 64, 128, 192)
+    ]
+    sequence = pysicgl.ColorSequence(
+        colors=colors, interpolator=pysicgl.interpolation.CONTINUOUS_LINEAR
+    )
+    # a gradient across a field which is smaller than the screen
+    field = pysicgl.ScalarField([0.0, 0.75])
+
+    rendered = {}
+    for filter in (
+        pysicgl.functional.FILTER_NEAREST,
+        pysicgl.functional.FILTER_BILINEAR,
+    ):
+        pysicgl.functional.interface_fill(interface, 0)
+        pysicgl.functional.scalar_field(
+            interface, screen, field, sequence, extent=(2, 1), filter=filter
+        )
+        rendered[filter] = [
+            pysicgl.functional.get_pixel_at_offset(interface, offset)
+            for offset in range(screen.pixels)
+        ]
+
+    # nearest sampling only reproduces the two field values
+    nearest = rendered[pysicgl.functional.FILTER_NEAREST]
+    assert len(set(nearest)) == 2
+    # bilinear sampling blends between them
+    bilinear = rendered[pysicgl.functional.FILTER_BILINEAR]
+    assert len(set(bilinear)) > 2
+    assert nearest != bilinear
+
+    with pytest.raises(ValueError):
+        pysicgl.functional.scalar_field(
+            interface, screen, field, sequence, extent=(2, 2)
+        )
+
+    # memory which does not cover the screen is rejected before resampling
+    large = pysicgl.Screen((512, 512))
+    undersized = pysicgl.Interface(large, bytearray(4))
+    with pytest.raises(ValueError):
+        pysicgl.functional.scalar_field(
+            undersized, large, field, sequence, extent=(2, 1)
+        )
+
+    # failed calls release their references
+    before = sys.getrefcount(field), sys.getrefcount(sequence)
+    for _ in range(10):
+        with pytest.raises(ValueError):
+            pysicgl.functional.scalar_field(
+                interface, screen, pysicgl.ScalarField([0.0]), sequence
+            )
+        with pytest.raises(ValueError):
+            pysicgl.functional.scalar_field(
+                interface, screen, field, sequence, extent=(2, 2)
+            )
+    assert (sys.getrefcount(field), sys.getrefcount(sequence)) == before
+
+
+def test_field_generators():
+    field = pysicgl.ScalarField([0.0] * 8)
+
+    pysicgl.functional.field_linear_gradient(field, (4, 2), scale=0.5)
+    assert [field[idx] for idx in range(8)] == [0.0, 0.5, 1.0, 1.5] * 2
+
+    pysicgl.functional.field_radial_gradient(field, (4, 2))
+    assert [field[idx] for idx in range(4)] == [0.0, 1.0, 2.0, 3.0]
+
+    for generator in (
+        pysicgl.functional.field_plasma,
+        pysicgl.functional.field_noise,
+    ):
+        generator(field, (4, 2), t=1.5, scale=0.3)
+        for idx in range(8):
+            assert 0.0 <= field[idx] <= 1.0
+
+    with pytest.raises(ValueError):
+        pysicgl.functional.field_conic_gradient(field, (4, 4))
+
+
+def test_scalar_expression():
+    expression = pysicgl.ScalarExpression("sin(x*0.1 + t) * cos(y*0.07)")
+    assert expression.source == "sin(x*0.1 + t) * cos(y*0.07)"
+
+    field = pysicgl.ScalarField([0.0] * 8)
+    pysicgl.functional.field_expression(
+        field, (4, 2), pysicgl.ScalarExpression("u + 10 * v + t"), t=0.5
+    )
+    assert [field[idx] for idx in range(8)] == [
+        0.5,
+        1.5,
+        2.5,
+        3.5,
+        10.5,
+        11.5,
+        12.5,
+        13.5,
+    ]
+
+    # constant sub-expressions are folded during compilation
+    assert pysicgl.ScalarExpression("2 * pi * 3").instructions == 0
+
+    for source in ("sin(", "u +", "unknown(u)", "1 2"):
+        with pytest.raises(ValueError):
+            pysicgl.ScalarExpression(source)
+
+    # deep nesting is rejected instead of exhausting the stack
+    for source in ("(" * 100000 + "u" + ")" * 100000, "-" * 100000 + "u"):
+        with pytest.raises(ValueError):
+            pysicgl.ScalarExpression(source)
+    pysicgl.ScalarExpression("(" * 16 + "u" + ")" * 16)
+
+
+def test_scalar_expression_draw():
+    screen = pysicgl.Screen((3, 2))
+    memory = pysicgl.allocate_pixel_memory(screen.pixels)
+    interface = pysicgl.Interface(screen, memory)
+
+    color = pysicgl.functional.color_from_rgba((10, 20, 30, 40))
+    sequence = pysicgl.ColorSequence(
+        colors=[color], interpolator=pysicgl.interpolation.DISCRETE_LINEAR
+    )
+    expression = pysicgl.ScalarExpression("u * v")
+    pysicgl.functional.scalar_expression(interface, screen, expression, sequence)
+    for offset in range(screen.pixels):
+        assert pysicgl.functional.get_pixel_at_offset(interface, offset) == color
+
+    # memory which does not cover the screen is rejected
+    large = pysicgl.Screen((512, 512))
+    undersized = pysicgl.Interface(large, bytearray(4))
+    with pytest.raises(ValueError):
+        pysicgl.functional.scalar_expression(undersized, large, expression, sequence)
+
+
+def test_scalar_field_storage():
+    screen = pysicgl.Screen((4, 2))
+    memory = pysicgl.allocate_pixel_memory(screen.pixels)
+    interface = pysicgl.Interface(screen, memory)
+
+    color = pysicgl.functional.color_from_rgba((10, 20, 30, 40))
+    sequence = pysicgl.ColorSequence(
+        colors=[color], interpolator=pysicgl.interpolation.DISCRETE_LINEAR
+    )
+
+    for storage in (
+        pysicgl.SCALAR_STORAGE_FLOAT64,
+        pysicgl.SCALAR_STORAGE_FLOAT32,
+        pysicgl.SCALAR_STORAGE_UINT16,
+    ):
+        field = pysicgl.ScalarField(screen.pixels, storage=storage)
+        assert field.storage == storage
+        pysicgl.functional.field_linear_gradient(field, (4, 2), scale=0.25)
+        expected = [0.0, 0.25, 0.5, 0.75]
+        assert [field[idx] for idx in range(4)] == pytest.approx(expected, abs=1e-4)
+
+        pysicgl.functional.interface_fill(interface, 0)
+        pysicgl.functional.scalar_field(interface, screen, field, sequence)
+        for offset in range(screen.pixels):
+            pixel = pysicgl.functional.get_pixel_at_offset(interface, offset)
+            assert pixel == color
+
+    # normalized storage clamps to the unit range
+    field = pysicgl.ScalarField([-1.0, 2.0], storage=pysicgl.SCALAR_STORAGE_UINT16)
+    assert (field[0], field[1]) == (0.0, 1.0)
+
+    # indices which are not sizes raise their own error
+    with pytest.raises(IndexError):
+        field[2]
+    with pytest.raises(OverflowError):
+        field[-1]
+    with pytest.raises(TypeError):
+        field["0"]
+
+
+def test_interface_blit_and_compose():
+    source_screen = pysicgl.Screen((2, 2))
+    source = pysicgl.Interface(
+        source_screen, pysicgl.allocate_pixel_memory(source_screen.pixels)
+    )
+    screen = pysicgl.Screen((4, 4))
+    interface = pysicgl.Interface(
+        screen, pysicgl.allocate_pixel_memory(screen.pixels)
+    )
+
+    for u in range(2):
+        for v in range(2):
+            color = pysicgl.functional.color_from_rgba((u + 1, v + 1, 0, 0))
+            pysicgl.functional.interface_pixel(source, color, (u, v))
+
+    # the source is clipped against the destination
+    pysicgl.functional.interface_blit(interface, (3, -1), source)
+    pixel = pysicgl.functional.get_pixel_at_coordinates(interface, (3, 0))
+    assert pysicgl.functional.color_to_rgba(pixel) == (1, 2, 0, 0)
+
+    # only the requested source region is composed
+    pysicgl.functional.interface_fill(interface, 0)
+    pysicgl.functional.interface_compose(
+        interface,
+        (1, 1),
+        source,
+        pysicgl.composition.DIRECT_SET,
+        ((1, 0), (1, 1)),
+    )
+    pixels = [
+        pysicgl.functional.get_pixel_at_offset(interface, offset)
+        for offset in range(screen.pixels)
+    ]
+    assert sum(1 for pixel in pixels if pixel != 0) == 2
+    pixel = pysicgl.functional.get_pixel_at_coordinates(interface, (1, 2))
+    assert pysicgl.functional.color_to_rgba(pixel) == (2, 2, 0, 0)
+
+    # extreme positions are clipped away without overflowing
+    pysicgl.functional.interface_fill(interface, 0)
+    pysicgl.functional.interface_blit(interface, (2**31 - 1, 2**31 - 1), source)
+    pysicgl.functional.interface_blit(interface, (-(2**31), -(2**31)), source)
+    assert not any(
+        pysicgl.functional.get_pixel_at_offset(interface, offset)
+        for offset in range(screen.pixels)
+    )
+
+
+def test_interface_compose_overlapping_row():
+    screen = pysicgl.Screen((8, 1))
+    interface = pysicgl.Interface(
+        screen, pysicgl.allocate_pixel_memory(screen.pixels)
+    )
+    for u in range(8):
+        pysicgl.functional.interface_pixel(interface, 1 << u, (u, 0))
+
+    # every pixel is composed with the source as it was before the call
+    pysicgl.functional.interface_compose(
+        interface,
+        (1, 0),
+        interface,
+        pysicgl.composition.BIT_OR,
+        ((0, 0), (6, 0)),
+    )
+    pixels = [
+        pysicgl.functional.get_pixel_at_offset(interface, offset)
+        for offset in range(screen.pixels)
+    ]
+    assert pixels == [1, 3, 6, 12, 24, 48, 96, 192]
+
+
+def test_interface_scaled_blit():
+    black = pysicgl.functional.color_from_rgba((0, 0, 0, 255))
+    white = pysicgl.functional.color_from_rgba((255, 255, 255, 255))
+    source = make_interface((2, 1))
+    pysicgl.functional.interface_pixel(source, black, (0, 0))
+    pysicgl.functional.interface_pixel(source, white, (1, 0))
+
+    destination = make_interface((4, 2))
+    pysicgl.functional.interface_scaled_blit(destination, ((0, 0), (3, 1)), source)
+    for v in range(2):
+        row = [
+            pysicgl.functional.get_pixel_at_coordinates(destination, (u, v))
+            for u in range(4)
+        ]
+        assert row == [black, black, white, white]
+
+    pysicgl.functional.interface_scaled_blit(
+        destination,
+        ((0, 0), (3, 1)),
+        source,
+        filter=pysicgl.functional.FILTER_BILINEAR,
+    )
+    row = [
+        pysicgl.functional.color_to_rgba(
+            pysicgl.functional.get_pixel_at_coordinates(destination, (u, 0))
+        )[0]
+        for u in range(4)
+    ]
+    assert row[0] == 0 and row[3] == 255
+    assert 0 < row[1] < row[2] < 255
+
+    # thumbnails select from the source region and clip to the destination
+    pysicgl.functional.interface_fill(destination, 0)
+    pysicgl.functional.interface_scaled_compose(
+        destination,
+        ((3, 1), (4, 2)),
+        source,
+        pysicgl.composition.DIRECT_SET,
+        source_corners=((1, 0), (1, 0)),
+    )
+    assert pysicgl.functional.get_pixel_at_coordinates(destination, (3, 1)) == white
+    assert pysicgl.functional.get_pixel_at_coordinates(destination, (2, 1)) == 0
+
+    with pytest.raises(ValueError):
+        pysicgl.functional.interface_scaled_blit(
+            destination, ((0, 0), (1, 1)), source, source_corners=((0, 0), (2, 0))
+        )
+
+    # targets far beyond the destination are clipped without overflowing
+    pysicgl.functional.interface_fill(destination, 0)
+    pysicgl.functional.interface_scaled_blit(
+        destination, ((-(2**15), 0), (2**15 - 1, 1)), source
+    )
+    assert pysicgl.functional.get_pixel_at_coordinates(destination, (0, 0)) == white
+    # unless the source can no longer be stepped across them
+    with pytest.raises(ValueError):
+        pysicgl.functional.interface_scaled_blit(
+            destination, ((-(2**31), -(2**31)), (2**31 - 1, 2**31 - 1)), source
+        )
+
+
+def test_interface_affine_blit():
+    source = make_interface((3, 2))
+    colors = {}
+    for v in range(2):
+        for u in range(3):
+            colors[(u, v)] = pysicgl.functional.color_from_rgba((u, v, 0, 255))
+            pysicgl.functional.interface_pixel(source, colors[(u, v)], (u, v))
+
+    # rotate a quarter turn so that (x, y) lands on (1 - y, x)
+    destination = make_interface((4, 4))
+    pysicgl.functional.interface_fill(destination, 0)
+    pysicgl.functional.interface_affine_blit(
+        destination, ((0, -1, 2), (1, 0, 0)), source
+    )
+    for (u, v), color in colors.items():
+        rotated = (1 - v, u)
+        pixel = pysicgl.functional.get_pixel_at_coordinates(destination, rotated)
+        assert pixel == color
+    assert pysicgl.functional.get_pixel_at_coordinates(destination, (3, 3)) == 0
+
+    # content outside of the destination is clipped, untouched pixels remain
+    pysicgl.functional.interface_fill(destination, 0)
+    pysicgl.functional.interface_affine_blit(
+        destination,
+        ((2, 0, -3), (0, 2, 0)),
+        source,
+        compositor=pysicgl.composition.DIRECT_SET,
+        filter=pysicgl.functional.FILTER_BILINEAR,
+    )
+    assert pysicgl.functional.get_pixel_at_coordinates(destination, (0, 0)) != 0
+    assert pysicgl.functional.get_pixel_at_coordinates(destination, (2, 3)) != 0
+    assert pysicgl.functional.get_pixel_at_coordinates(destination, (3, 0)) == 0
+
+    with pytest.raises(ValueError):
+        pysicgl.functional.interface_affine_blit(
+            destination, ((1, 1, 0), (1, 1, 0)), source
+        )
+
+    # transforms far beyond the destination draw nothing
+    pysicgl.functional.interface_fill(destination, 0)
+    for matrix in (((1, 0, 3e9), (0, 1, 0)), ((1, 0, 0), (0, 1, -3e9))):
+        pysicgl.functional.interface_affine_blit(destination, matrix, source)
+    assert not any(
+        pysicgl.functional.get_pixel_at_offset(destination, offset)
+        for offset in range(destination.screen.pixels)
+    )
+
+    with pytest.raises(ValueError):
+        pysicgl.functional.interface_affine_blit(
+            destination, ((1, 0, 0), (0, 1, 0)), source, filter=7
+        )
+    with pytest.raises(ValueError):
+        pysicgl.functional.interface_scaled_blit(
+            destination, ((0, 0), (1, 1)), source, filter=7
+        )
+
+
+def test_blur():
+    screen = pysicgl.Screen((5, 3))
+    interface = pysicgl.Interface(
+        screen, pysicgl.allocate_pixel_memory(screen.pixels)
+    )
+
+    def reds():
+        return [
+            [
+                pysicgl.functional.color_to_rgba(
+                    pysicgl.functional.get_pixel_at_coordinates(interface, (u, v))
+                )[0]
+                for u in range(5)
+            ]
+            for v in range(3)
+        ]
+
+    # a uniform interface is unchanged by blurring
+    gray = pysicgl.functional.color_from_rgba((90, 90, 90, 255))
+    pysicgl.functional.interface_fill(interface, gray)
+    pysicgl.functional.box_blur(interface, 2)
+    pysicgl.functional.gaussian_blur(interface, 1.5)
+    assert all(red == 90 for row in reds() for red in row)
+
+    # a single bright column spreads to its neighbors
+    pysicgl.functional.interface_fill(interface, 0)
+    white = pysicgl.functional.color_from_rgba((255, 255, 255, 255))
+    for v in range(3):
+        pysicgl.functional.interface_pixel(interface, white, (2, v))
+    pysicgl.functional.box_blur(interface, 1)
+    assert reds() == [[0, 85, 85, 85, 0]] * 3
+
+    # blurring may be limited to a region in global coordinates
+    pysicgl.functional.interface_fill(interface, 0)
+    for v in range(3):
+        pysicgl.functional.interface_pixel(interface, white, (2, v))
+    pysicgl.functional.gaussian_blur(
+        interface, 1.0, screen=pysicgl.Screen((2, 3), (3, 0))
+    )
+    assert reds() == [[0, 0, 255, 0, 0]] * 3
+    pysicgl.functional.gaussian_blur(interface, 1.0)
+    row = reds()[1]
+    assert row[2] < 255 and row[1] > 0 and row[1] == row[3]
+
+    # boxes wider than the interface repeat the edge pixels
+    pysicgl.functional.interface_fill(interface, 0)
+    for v in range(3):
+        pysicgl.functional.interface_pixel(interface, white, (0, v))
+    pysicgl.functional.box_blur(interface, 7)
+    expected = [round(255 * (8 - u) / 15) for u in range(5)]
+    assert reds() == [expected] * 3
+
+    # huge radii neither overflow nor lose precision
+    pysicgl.functional.interface_fill(interface, gray)
+    pysicgl.functional.box_blur(interface, 2**31 - 1)
+    pysicgl.functional.gaussian_blur(interface, 1e6)
+    for offset in range(screen.pixels):
+        pixel = pysicgl.functional.get_pixel_at_offset(interface, offset)
+        assert pysicgl.functional.color_to_rgba(pixel) == (90, 90, 90, 255)
+
+    for sigma in (float("nan"), float("inf"), 1e300):
+        with pytest.raises(ValueError):
+            pysicgl.functional.gaussian_blur(interface, sigma)
+
+
+def test_blur_while_memory_is_replaced():
+    screen = pysicgl.Screen((64, 64))
+    interface = pysicgl.Interface(
+        screen, pysicgl.allocate_pixel_memory(screen.pixels)
+    )
+    done = threading.Event()
+
+    def replace_memory():
+        while not done.is_set():
+            interface.memory = pysicgl.allocate_pixel_memory(screen.pixels)
+
+    # the filters hold the memory they started with until they finish
+    thread = threading.Thread(target=replace_memory)
+    thread.start()
+    try:
+        for _ in range(50):
+            pysicgl.functional.box_blur(interface, 3)
+            pysicgl.functional.convolve(interface, [[1, 2, 1]] * 3)
+    finally:
+        done.set()
+        thread.join()
+
+
+def test_convolve():
+    screen = pysicgl.Screen((5, 3))
+    interface = pysicgl.Interface(
+        screen, pysicgl.allocate_pixel_memory(screen.pixels)
+    )
+    white = pysicgl.functional.color_from_rgba((255, 255, 255, 255))
+
+    def reds():
+        return [
+            [
+                pysicgl.functional.color_to_rgba(
+                    pysicgl.functional.get_pixel_at_coordinates(interface, (u, v))
+                )[0]
+                for u in range(5)
+            ]
+            for v in range(3)
+        ]
+
+    def edge_column():
+        pysicgl.functional.interface_fill(interface, 0)
+        for v in range(3):
+            pysicgl.functional.interface_pixel(interface, white, (0, v))
+
+    # the identity kernel leaves the interface unchanged
+    edge_column()
+    pysicgl.functional.convolve(interface, ((0, 0, 0), (0, 1, 0), (0, 0, 0)))
+    assert reds() == [[255, 0, 0, 0, 0]] * 3
+
+    # a horizontal box spreads the column according to the edge mode
+    box = ((0, 0, 0), (1, 1, 1), (0, 0, 0))
+    pysicgl.functional.convolve(interface, box)
+    assert reds() == [[170, 85, 0, 0, 0]] * 3
+    edge_column()
+    pysicgl.functional.convolve(interface, box, edge=pysicgl.functional.EDGE_WRAP)
+    assert reds() == [[85, 85, 0, 0, 85]] * 3
+    edge_column()
+    pysicgl.functional.convolve(interface, box, edge=pysicgl.functional.EDGE_ZERO)
+    assert reds() == [[85, 85, 0, 0, 0]] * 3
+
+    # float and 5x5 kernels share the same weights, alpha is kept by default
+    edge_column()
+    kernel = [[0.0] * 5 for _ in range(5)]
+    kernel[0][2] = kernel[4][2] = 0.5
+    pysicgl.functional.convolve(
+        interface, kernel, edge=pysicgl.functional.EDGE_WRAP, divisor=1
+    )
+    assert reds() == [[255, 0, 0, 0, 0]] * 3
+
+    # edge detection of a uniform interface is zero plus the bias
+    pysicgl.functional.interface_fill(interface, white)
+    laplacian = ((0, -1, 0), (-1, 4, -1), (0, -1, 0))
+    pysicgl.functional.convolve(interface, laplacian, bias=128)
+    assert reds() == [[128] * 5] * 3
+    assert pysicgl.functional.color_to_rgba(
+        pysicgl.functional.get_pixel_at_offset(interface, 0)
+    )[3] == 255
+
+    with pytest.raises(ValueError):
+        pysicgl.functional.convolve(interface, ((1, 1), (1, 1)))
+    with pytest.raises(ValueError):
+        pysicgl.functional.convolve(interface, ((1, 1, 1),))
+    with pytest.raises(ValueError):
+        pysicgl.functional.convolve(interface, ((1,),), edge=7)
+
+    # converting a weight may mutate the kernel, which is parsed from a copy
+    kernel = [[0, 0, 0], [0, 1, 0], [0, 0, 0]]
+
+    class Clearing:
+        def __float__(self):
+            for row in kernel:
+                row.clear()
+            kernel.clear()
+            return 0.0
+
+    kernel[2][2] = Clearing()
+    edge_column()
+    pysicgl.functional.convolve(interface, kernel)
+    assert reds() == [[255, 0, 0, 0, 0]] * 3
+
+
+def test_antialiased_primitives():
+    screen = pysicgl.Screen((8, 8))
+    interface = pysicgl.Interface(
+        screen, pysicgl.allocate_pixel_memory(screen.pixels)
+    )
+    black = pysicgl.functional.color_from_rgba((0, 0, 0, 255))
+    white = pysicgl.functional.color_from_rgba((255, 255, 255, 255))
+
+    def red(u, v):
+        return pysicgl.functional.color_to_rgba(
+            pysicgl.functional.get_pixel_at_coordinates(interface, (u, v))
+        )[0]
+
+    # a line between pixel rows is shared evenly by both rows
+    pysicgl.functional.interface_fill(interface, black)
+    pysicgl.functional.interface_line_aa(interface, white, (1, 2.5), (6, 2.5))
+    assert red(3, 2) == red(3, 3) == 128
+    assert red(3, 1) == red(3, 4) == 0
+
+    # a line on pixel centers covers them fully apart from its ends
+    pysicgl.functional.interface_fill(interface, black)
+    pysicgl.functional.interface_line_aa(interface, white, (1, 1), (1, 6))
+    assert [red(1, v) for v in range(8)] == [0, 128, 255, 255, 255, 255, 128, 0]
+
+    # coverage scales the alpha of the color
+    pysicgl.functional.interface_fill(interface, black)
+    half = pysicgl.functional.color_from_rgba((255, 255, 255, 128))
+    pysicgl.functional.interface_line_aa(interface, half, (0, 4), (7, 4))
+    assert red(3, 4) == 128
+
+    # the outline of a circle straddles its radius
+    pysicgl.functional.interface_fill(interface, black)
+    pysicgl.functional.interface_circle_aa(interface, white, (3.5, 3.5), 6)
+    assert red(3, 3) == 0
+    assert red(0, 3) > 0 and red(7, 3) == red(0, 3)
+    assert red(3, 0) == red(0, 3)
+
+    # screen drawing is offset by the location of the screen and clipped to it
+    pysicgl.functional.interface_fill(interface, black)
+    region = pysicgl.Screen((4, 4), (4, 4))
+    pysicgl.functional.screen_line_aa(interface, region, white, (-4, 0), (3, 0))
+    assert red(3, 4) == 0 and red(4, 4) == 255
+
+    pysicgl.functional.interface_fill(interface, black)
+    pysicgl.functional.screen_ellipse_aa(interface, region, white, (0, 0), (2, 1))
+    assert red(4, 4) == 0 and red(6, 4) == 255
+    assert red(2, 4) == 0
+
+    # global drawing is relative to the location of the interface
+    shifted = pysicgl.Interface(
+        pysicgl.Screen((8, 8), (10, 10)), pysicgl.allocate_pixel_memory(64)
+    )
+    pysicgl.functional.global_line_aa(shifted, white, (10, 12), (17, 12))
+    assert pysicgl.functional.color_to_rgba(
+        pysicgl.functional.get_pixel_at_coordinates(shifted, (4, 2))
+    )[0] == 255
+    pysicgl.functional.global_circle_aa(shifted, white, (14, 14), 4)
+    pysicgl.functional.global_ellipse_aa(shifted, white, (14, 14), (3, 2))
+
+    # lines far outside of the interface are clipped before drawing
+    pysicgl.functional.interface_fill(interface, black)
+    pysicgl.functional.interface_line_aa(interface, white, (-3e9, 2), (3e9, 2))
+    assert [red(u, 2) for u in range(8)] == [255] * 8
+    assert red(3, 1) == red(3, 3) == 0
+    pysicgl.functional.interface_fill(interface, black)
+    pysicgl.functional.interface_line_aa(interface, white, (5, -1e300), (5, 1e300))
+    assert [red(5, v) for v in range(8)] == [255] * 8
+    pysicgl.functional.interface_fill(interface, black)
+    pysicgl.functional.interface_line_aa(interface, white, (-3e9, -3e9), (3e9, 3e9))
+    assert [red(u, u) for u in range(8)] == [255] * 8
+    pysicgl.functional.interface_line_aa(interface, white, (-3e9, 20), (3e9, 20))
+    pysicgl.functional.interface_line_aa(
+        interface, white, (float("nan"), 0), (3, 3)
+    )
+
+    # ellipses far outside of the interface are clipped before drawing
+    pysicgl.functional.interface_fill(interface, black)
+    pysicgl.functional.interface_circle_aa(interface, white, (3.5, 3e9 + 3), 6e9)
+    assert [red(u, 3) for u in range(8)] == [255] * 8
+    assert red(3, 2) == red(3, 4) == 0
+    pysicgl.functional.interface_fill(interface, black)
+    pysicgl.functional.interface_ellipse_aa(interface, white, (1e300, 0), (1, 1e300))
+    pysicgl.functional.interface_circle_aa(interface, white, (-3e9, 3e9), 0)
+    pysicgl.functional.interface_circle_aa(interface, white, (3, 3), 1e308)
+    assert [red(u, v) for u in range(8) for v in range(8)] == [0] * 64
+
+    nan = float("nan")
+    inf = float("inf")
+    with pytest.raises(ValueError):
+        pysicgl.functional.interface_circle_aa(interface, white, (3, 3), -1)
+    with pytest.raises(ValueError):
+        pysicgl.functional.interface_circle_aa(interface, white, (3, 3), inf)
+    with pytest.raises(ValueError):
+        pysicgl.functional.interface_circle_aa(interface, white, (nan, 3), 2)
+    with pytest.raises(ValueError):
+        pysicgl.functional.global_ellipse_aa(interface, white, (3, -inf), (1, 1))
+
+
+def test_filled_shapes():
+    screen = pysicgl.Screen((8, 8))
+    interface = pysicgl.Interface(
+        screen, pysicgl.allocate_pixel_memory(screen.pixels)
+    )
+    white = pysicgl.functional.color_from_rgba((255, 255, 255, 255))
+
+    def mask():
+        return [
+            "".join(
+                "#"
+                if pysicgl.functional.get_pixel_at_coordinates(interface, (u, v))
+                else "."
+                for u in range(8)
+            )
+            for v in range(8)
+        ]
+
+    pysicgl.functional.interface_fill(interface, 0)
+    pysicgl.functional.interface_circle_filled(interface, white, (3.5, 3.5), 8)
+    assert mask() == [
+        "..####..",
+        ".######.",
+        "########",
+        "########",
+        "########",
+        "########",
+        ".######.",
+        "..####..",
+    ]
+
+    pysicgl.functional.interface_fill(interface, 0)
+    pysicgl.functional.interface_ellipse_filled(interface, white, (3, 3), (3, 1))
+    assert mask()[1:6] == ["........", "...#....", "#######.", "...#....", "........"]
+
+    pysicgl.functional.interface_fill(interface, 0)
+    pysicgl.functional.interface_rounded_rectangle_filled(
+        interface, white, (0, 0), (7, 5), 2
+    )
+    assert mask()[:7] == [
+        "..####..",
+        ".######.",
+        "########",
+        "########",
+        ".######.",
+        "..####..",
+        "........",
+    ]
+
+    # a square with a square hole bridged from its corner shows the
+    # difference between the fill rules
+    square = [(0, 0), (8, 0), (8, 8), (0, 8), (0, 0)]
+    inner = [(2, 2), (6, 2), (6, 6), (2, 6), (2, 2)]
+    for vertices, rule, row in [
+        (square + inner, pysicgl.functional.FILL_NONZERO, "########"),
+        (square + inner, pysicgl.functional.FILL_EVEN_ODD, "##....##"),
+        (square + inner[::-1], pysicgl.functional.FILL_NONZERO, "##....##"),
+    ]:
+        pysicgl.functional.interface_fill(interface, 0)
+        pysicgl.functional.interface_polygon_filled(
+            interface, white, vertices, rule=rule
+        )
+        assert mask()[2:6] == [row] * 4
+        assert mask()[1] == mask()[6] == "########"
+
+    # the screen and global domains
+    pysicgl.functional.interface_fill(interface, 0)
+    region = pysicgl.Screen((4, 4), (4, 4))
+    pysicgl.functional.screen_polygon_filled(
+        interface, region, white, [[-4, -4], [4, -4], [4, 4], [-4, 4]]
+    )
+    pysicgl.functional.screen_circle_filled(interface, region, white, (0, 0), 1)
+    assert mask()[3:5] == ["........", "....####"]
+    pysicgl.functional.global_rounded_rectangle_filled(
+        interface, white, (0, 0), (1, 1), 0
+    )
+    pysicgl.functional.global_ellipse_filled(interface, white, (0, 7), (0, 0))
+    pysicgl.functional.global_circle_filled(interface, white, (7, 0), 0)
+    pysicgl.functional.screen_ellipse_filled(interface, region, white, (0, 0), (1, 1))
+    pysicgl.functional.screen_rounded_rectangle_filled(
+        interface, region, white, (0, 0), (1, 1), 1
+    )
+    pysicgl.functional.global_polygon_filled(interface, white, [(0, 0), (1, 0), (0, 1)])
+    assert mask()[0][:2] == "##" and mask()[7][0] == "#" and mask()[0][7] == "#"
+
+    with pytest.raises(ValueError):
+        pysicgl.functional.interface_polygon_filled(interface, white, [(0, 0, 0)])
+    with pytest.raises(ValueError):
+        pysicgl.functional.interface_polygon_filled(interface, white, [], rule=5)
+
+    # non-finite shapes are rejected rather than filling everything
+    nan = float("nan")
+    inf = float("inf")
+    pysicgl.functional.interface_fill(interface, 0)
+    with pytest.raises(ValueError):
+        pysicgl.functional.interface_circle_filled(interface, white, (3, 3), nan)
+    with pytest.raises(ValueError):
+        pysicgl.functional.interface_circle_filled(interface, white, (nan, 3), 2)
+    with pytest.raises(ValueError):
+        pysicgl.functional.interface_ellipse_filled(interface, white, (3, 3), (inf, 1))
+    with pytest.raises(ValueError):
+        pysicgl.functional.global_ellipse_filled(interface, white, (3, -inf), (1, 1))
+    with pytest.raises(ValueError):
+        pysicgl.functional.interface_rounded_rectangle_filled(
+            interface, white, (0, 0), (7, 7), nan
+        )
+    with pytest.raises(ValueError):
+        pysicgl.functional.interface_polygon_filled(
+            interface, white, [(0, 0), (nan, 0), (0, 7)]
+        )
+    with pytest.raises(ValueError):
+        pysicgl.functional.screen_polygon_filled(
+            interface, region, white, [(0, 0), (7, 0), (0, inf)]
+        )
+    assert mask() == ["........"] * 8
+
+    # converting a coordinate may mutate the vertices, which are copied first
+    vertices = [[0, 0], [7, 0], [0, 7]]
+
+    class Clearing:
+        def __float__(self):
+            for vertex in vertices:
+                vertex.clear()
+            vertices.clear()
+            return 7.0
+
+    vertices[2][1] = Clearing()
+    pysicgl.functional.interface_polygon_filled(interface, white, vertices)
+    assert mask()[0][:7] == "#######" and mask()[6][0] == "#"
+
+    # huge but finite shapes are clipped
+    pysicgl.functional.interface_circle_filled(interface, white, (3, 3), 1e300)
+    assert mask() == ["########"] * 8
+
+
+def test_fill_spans():
+    screen = pysicgl.Screen((37, 5), (10, 10))
+    interface = pysicgl.Interface(
+        screen, pysicgl.allocate_pixel_memory(screen.pixels)
+    )
+    color = pysicgl.functional.color_from_rgba((1, 2, 3, 4))
+    other = pysicgl.functional.color_from_rgba((5, 6, 7, 8))
+
+    def pixel(u, v):
+        return pysicgl.functional.get_pixel_at_coordinates(interface, (u, v))
+
+    pysicgl.functional.interface_fill(interface, color)
+    assert all(pixel(u, v) == color for u in range(37) for v in range(5))
+
+    # spans starting and ending at odd offsets, corners in either order
+    pysicgl.functional.interface_rectangle_filled(interface, other, (35, 3), (1, 1))
+    assert [pixel(u, 2) == other for u in (0, 1, 35, 36)] == [
+        False,
+        True,
+        True,
+        False,
+    ]
+    assert pixel(20, 0) == color and pixel(20, 4) == color
+
+    # screen and global rectangles are clipped to the interface
+    pysicgl.functional.interface_fill(interface, color)
+    region = pysicgl.Screen((4, 4), (44, 12))
+    pysicgl.functional.screen_rectangle_filled(interface, region, other, (1, 1), (9, 9))
+    assert [pixel(u, 3) == other for u in (34, 35, 36)] == [False, True, True]
+    assert pixel(35, 2) == color
+    pysicgl.functional.screen_fill(interface, region, other)
+    assert pixel(34, 2) == other and pixel(33, 2) == color
+    pysicgl.functional.interface_fill(interface, other)
+    pysicgl.functional.global_rectangle_filled(interface, color, (0, 0), (10, 10))
+    assert pixel(0, 0) == color and pixel(1, 0) == other and pixel(0, 1) == other
+
+    # frames large enough to be streamed past the cache
+    screen = pysicgl.Screen((1024, 1024))
+    interface = pysicgl.Interface(
+        screen, pysicgl.allocate_pixel_memory(screen.pixels)
+    )
+    pysicgl.functional.interface_fill(interface, other)
+    memory = bytes(interface.memory)
+    assert memory == memory[:4] * screen.pixels
+    assert pysicgl.functional.get_pixel_at_offset(interface, 0) == other
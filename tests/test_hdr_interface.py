@@ -0,0 +1,133 @@
+import threading
+
+import pytest
+import pysicgl
+from tests.testutils import filled, make_interface, rgba
+
+
+def test_hdr_accumulation():
+    hdr = pysicgl.HDRInterface(pysicgl.Screen((4, 4)))
+    assert hdr.get_pixel((0, 0)) == (0.0, 0.0, 0.0, 0.0)
+
+    # many additive layers accumulate past full scale without saturating
+    layer = filled((4, 4), (255, 51, 0, 255))
+    for _ in range(10):
+        hdr.compose(layer, mode=pysicgl.functional.HDR_ADD)
+    r, g, b, a = hdr.get_pixel((1, 1))
+    assert r == pytest.approx(10.0)
+    assert g == pytest.approx(2.0)
+    assert b == 0.0
+    assert a == pytest.approx(1.0)
+
+    hdr.scale(0.5)
+    assert hdr.get_pixel((1, 1))[:3] == pytest.approx((5.0, 1.0, 0.0))
+
+    hdr.compose(filled((4, 4), (0, 0, 255, 255)), mode=pysicgl.functional.HDR_OVER)
+    assert hdr.get_pixel((1, 1)) == pytest.approx((0.0, 0.0, 1.0, 1.0))
+
+    hdr.clear((2.0, 2.0, 2.0, 1.0))
+    half = filled((2, 2), (128, 255, 255, 255), location=(2, 2))
+    hdr.compose(half, mode=pysicgl.functional.HDR_MULTIPLY)
+    assert hdr.get_pixel((3, 3))[0] == pytest.approx(2.0 * 128 / 255)
+    assert hdr.get_pixel((0, 0))[0] == pytest.approx(2.0)
+
+    hdr.compose(hdr, mode=pysicgl.functional.HDR_MAX, scale=2.0)
+    assert hdr.get_pixel((0, 0))[0] == pytest.approx(4.0)
+
+    with pytest.raises(ValueError):
+        hdr.compose(layer, mode=17)
+    with pytest.raises(TypeError):
+        hdr.compose(1)
+
+
+def test_hdr_tone_map():
+    hdr = pysicgl.HDRInterface(pysicgl.Screen((2, 2), (1, 1)))
+    hdr.clear((4.0, 0.5, 0.25, 1.0))
+    interface = make_interface((2, 2))
+
+    hdr.tone_map(interface)
+    assert rgba(interface, (1, 1)) == (255, 128, 64, 255)
+    # placed in global coordinates
+    assert rgba(interface, (0, 0)) == (0, 0, 0, 0)
+
+    hdr.tone_map(interface, exposure=0.5)
+    assert rgba(interface, (1, 1)) == (255, 64, 32, 255)
+
+    hdr.tone_map(interface, operator=pysicgl.functional.TONE_MAP_REINHARD)
+    assert rgba(interface, (1, 1)) == (204, 85, 51, 255)
+
+    with pytest.raises(ValueError):
+        hdr.tone_map(interface, operator=5)
+
+
+def test_hdr_screen_changes():
+    screen = pysicgl.Screen((4, 4))
+    hdr = pysicgl.HDRInterface(screen)
+    interface = make_interface((8, 8))
+
+    # the memory is checked against the screen on every call
+    screen.set_corners((0, 0), (7, 7))
+    with pytest.raises(ValueError):
+        hdr.get_pixel((7, 7))
+    with pytest.raises(ValueError):
+        hdr.compose(interface)
+    with pytest.raises(ValueError):
+        hdr.tone_map(interface)
+    with pytest.raises(ValueError):
+        pysicgl.HDRInterface(pysicgl.Screen((2, 2))).compose(hdr)
+    with pytest.raises(ValueError):
+        hdr.scale(2.0)
+    with pytest.raises(ValueError):
+        hdr.clear()
+
+    screen.set_corners((0, 0), (1, 1))
+    hdr.clear((1.0, 1.0, 1.0, 1.0))
+    hdr.compose(interface)
+    hdr.tone_map(interface)
+    assert hdr.get_pixel((1, 1)) == (1.0, 1.0, 1.0, 1.0)
+    assert rgba(interface, (1, 1)) == (255, 255, 255, 255)
+
+
+def test_hdr_uninitialized():
+    hdr = pysicgl.HDRInterface.__new__(pysicgl.HDRInterface)
+    interface = make_interface((2, 2))
+    assert hdr.screen is None
+    with pytest.raises(ValueError):
+        hdr.clear()
+    with pytest.raises(ValueError):
+        hdr.get_pixel((0, 0))
+    with pytest.raises(ValueError):
+        hdr.compose(interface)
+    with pytest.raises(ValueError):
+        hdr.scale(2.0)
+    with pytest.raises(ValueError):
+        hdr.tone_map(interface)
+    with pytest.raises(ValueError):
+        pysicgl.HDRInterface(pysicgl.Screen((2, 2))).compose(hdr)
+
+
+def test_hdr_while_reinitialized():
+    screen = pysicgl.Screen((64, 64))
+    hdr = pysicgl.HDRInterface(screen)
+    other = pysicgl.HDRInterface(screen)
+    interface = make_interface((64, 64))
+    done = threading.Event()
+
+    def reinitialize():
+        while not done.is_set():
+            hdr.__init__(screen)
+            other.__init__(screen)
+            interface.memory = pysicgl.allocate_pixel_memory(screen.pixels)
+
+    # the memory is held until each call finishes
+    thread = threading.Thread(target=reinitialize)
+    thread.start()
+    try:
+        for _ in range(50):
+            hdr.compose(interface)
+            hdr.compose(other, mode=pysicgl.functional.HDR_MAX)
+            hdr.scale(0.5)
+            hdr.tone_map(interface)
+    finally:
+        done.set()
+        thread.join()
@@ -0,0 +1,111 @@
+import threading
+
+import pytest
+import pysicgl
+from tests.testutils import make_interface, rgba
+
+INTERPOLATOR = pysicgl.interpolation.CONTINUOUS_CIRCULAR
+
+
+def make_palette(*colors):
+    colors = [pysicgl.functional.color_from_rgba(color) for color in colors]
+    return pysicgl.ColorSequence(colors=colors, interpolator=INTERPOLATOR)
+
+
+def make_indexed(extent, palette, location=(0, 0)):
+    screen = pysicgl.Screen(extent, location)
+    return pysicgl.IndexedInterface(screen, bytearray(screen.pixels), palette)
+
+
+def test_indexed_drawing():
+    palette = make_palette((0, 0, 0, 255), (255, 0, 0, 255))
+    indexed = make_indexed((4, 3), palette)
+    assert indexed.palette is palette
+    assert len(indexed.memory) == 12
+
+    indexed.fill(1)
+    assert indexed.get_pixel((3, 2)) == 1
+    indexed.rectangle_filled(2, (1, 1), (5, 5))
+    assert indexed.get_pixel((0, 0)) == 1
+    assert indexed.get_pixel((1, 1)) == 2
+    assert indexed.get_pixel((3, 2)) == 2
+    indexed.pixel(0, (0, 2))
+    assert indexed.get_pixel((0, 2)) == 0
+
+    with pytest.raises(ValueError):
+        indexed.fill(256)
+    with pytest.raises(IndexError):
+        indexed.get_pixel((4, 0))
+    with pytest.raises(TypeError):
+        indexed.palette = [1, 2]
+
+
+def test_indexed_expand():
+    palette = make_palette((0, 0, 0, 255), (255, 0, 0, 255))
+    indexed = make_indexed((2, 2), palette, location=(1, 1))
+    indexed.fill(1)
+    indexed.pixel(0, (1, 1))
+    indexed.pixel(5, (0, 1))
+
+    interface = make_interface((3, 3))
+    indexed.expand(interface)
+    assert rgba(interface, (0, 0)) == (0, 0, 0, 0)
+    assert rgba(interface, (1, 1)) == (255, 0, 0, 255)
+    assert rgba(interface, (2, 2)) == (0, 0, 0, 255)
+    # indices past the end of the palette are transparent
+    assert rgba(interface, (1, 2)) == (0, 0, 0, 0)
+
+    # palette animation is a palette swap
+    indexed.palette = make_palette((0, 0, 255, 255), (0, 255, 0, 255))
+    indexed.expand(interface, compositor=pysicgl.composition.BIT_OR)
+    assert rgba(interface, (1, 1)) == (255, 255, 0, 255)
+    assert rgba(interface, (2, 2)) == (0, 0, 255, 255)
+
+    packed = bytearray(12)
+    indexed.expand_rgb(packed)
+    assert packed == bytes([0, 255, 0, 0, 255, 0, 0, 0, 0, 0, 0, 255])
+    with pytest.raises(ValueError):
+        indexed.expand_rgb(bytearray(11))
+
+
+def test_indexed_uninitialized():
+    indexed = pysicgl.IndexedInterface.__new__(pysicgl.IndexedInterface)
+    assert indexed.screen is None
+    assert indexed.palette is None
+    with pytest.raises(ValueError):
+        indexed.fill(0)
+    with pytest.raises(ValueError):
+        indexed.pixel(0, (0, 0))
+    with pytest.raises(ValueError):
+        indexed.get_pixel((0, 0))
+    with pytest.raises(ValueError):
+        indexed.rectangle_filled(0, (0, 0), (1, 1))
+    with pytest.raises(ValueError):
+        indexed.expand(make_interface((2, 2)))
+    with pytest.raises(ValueError):
+        indexed.expand_rgb(bytearray(12))
+
+
+def test_indexed_expand_while_replaced():
+    palette = make_palette((0, 0, 0, 255), (255, 0, 0, 255))
+    screen = pysicgl.Screen((64, 64))
+    indexed = pysicgl.IndexedInterface(screen, bytearray(screen.pixels), palette)
+    interface = make_interface((64, 64))
+    done = threading.Event()
+
+    def replace_memory():
+        while not done.is_set():
+            indexed.__init__(screen, bytearray(screen.pixels), palette)
+            interface.memory = pysicgl.allocate_pixel_memory(screen.pixels)
+
+    # expanding holds the indices and the destination until it finishes
+    thread = threading.Thread(target=replace_memory)
+    thread.start()
+    try:
+        for _ in range(50):
+            indexed.expand(interface)
+            indexed.expand(interface, compositor=pysicgl.composition.BIT_OR)
+            indexed.expand_rgb(bytearray(3 * screen.pixels))
+    finally:
+        done.set()
+        thread.join()
@@ -0,0 +1,165 @@
+import pytest
+import pysicgl
+from tests.testutils import make_interface
+
+
+def fill_layer(extent, color):
+    interface = make_interface(extent)
+    pysicgl.functional.interface_fill(interface, color)
+    return interface
+
+
+def test_layer_stack_management():
+    stack = pysicgl.LayerStack()
+    assert len(stack) == 0
+
+    layer = fill_layer((2, 2), 0)
+    compositor = pysicgl.composition.DIRECT_SET
+    assert stack.add(layer, layer.screen, compositor) == 0
+    assert stack.add(layer, layer.screen, compositor, opacity=0.5) == 1
+    assert len(stack) == 2
+
+    stack.update(1, visible=False)
+    assert stack.layers[1][3:] == (0.5, False)
+
+    stack.remove(0)
+    assert len(stack) == 1
+    with pytest.raises(IndexError):
+        stack.remove(1)
+
+    stack.clear()
+    assert len(stack) == 0
+
+
+def test_layer_stack_flatten():
+    destination = make_interface((4, 2))
+    pysicgl.functional.interface_fill(destination, 0)
+
+    red = pysicgl.functional.color_from_rgba((100, 0, 0, 255))
+    green = pysicgl.functional.color_from_rgba((0, 100, 0, 255))
+    blue = pysicgl.functional.color_from_rgba((0, 0, 100, 255))
+
+    stack = pysicgl.LayerStack()
+    stack.add(
+        fill_layer((4, 2), red), pysicgl.Screen((4, 2)), pysicgl.composition.DIRECT_SET
+    )
+    # placed on the right half, partially outside of the destination
+    stack.add(
+        fill_layer((4, 4), green),
+        pysicgl.Screen((4, 4), (2, 0)),
+        pysicgl.composition.CHANNEL_SUM_CLAMPED,
+        opacity=0.5,
+    )
+    hidden = stack.add(
+        fill_layer((4, 2), blue),
+        pysicgl.Screen((4, 2)),
+        pysicgl.composition.DIRECT_SET,
+        visible=False,
+    )
+
+    stack.flatten(destination)
+    for v in range(2):
+        assert pysicgl.functional.get_pixel_at_coordinates(destination, (0, v)) == red
+        assert pysicgl.functional.get_pixel_at_coordinates(destination, (1, v)) == red
+        for u in (2, 3):
+            pixel = pysicgl.functional.get_pixel_at_coordinates(destination, (u, v))
+            assert pysicgl.functional.color_to_rgba(pixel)[:3] == (100, 50, 0)
+
+    stack.update(hidden, visible=True)
+    stack.flatten(destination)
+    for offset in range(destination.screen.pixels):
+        assert pysicgl.functional.get_pixel_at_offset(destination, offset) == blue
+
+
+def test_layer_stack_rejects_destination_layer():
+    destination = make_interface((2, 2))
+    stack = pysicgl.LayerStack()
+    stack.add(destination, destination.screen, pysicgl.composition.DIRECT_SET)
+    with pytest.raises(ValueError):
+        stack.flatten(destination)
+
+
+def test_layer_stack_rechecks_layers():
+    destination = make_interface((2, 2))
+    layer = fill_layer((2, 2), 0)
+    stack = pysicgl.LayerStack()
+    stack.add(layer, layer.screen, pysicgl.composition.DIRECT_SET)
+
+    # the memory of a layer shrinks after it was added
+    layer.memory = pysicgl.allocate_pixel_memory(1)
+    with pytest.raises(ValueError):
+        stack.flatten(destination)
+    with pytest.raises(ValueError):
+        stack.flatten(destination, incremental=True)
+
+
+def test_layer_stack_incremental():
+    background = pysicgl.functional.color_from_rgba((1, 2, 3, 255))
+    red = pysicgl.functional.color_from_rgba((100, 0, 0, 255))
+    green = pysicgl.functional.color_from_rgba((0, 100, 0, 255))
+    blue = pysicgl.functional.color_from_rgba((0, 0, 100, 255))
+
+    def reference(stack):
+        expected = make_interface((4, 2))
+        pysicgl.functional.interface_fill(expected, background)
+        copy = pysicgl.LayerStack()
+        for interface, screen, compositor, opacity, visible in stack.layers:
+            copy.add(interface, screen, compositor, opacity=opacity, visible=visible)
+        copy.flatten(expected)
+        return [
+            pysicgl.functional.get_pixel_at_offset(expected, offset)
+            for offset in range(expected.screen.pixels)
+        ]
+
+    def pixels(interface):
+        return [
+            pysicgl.functional.get_pixel_at_offset(interface, offset)
+            for offset in range(interface.screen.pixels)
+        ]
+
+    destination = make_interface((4, 2))
+    pysicgl.functional.interface_fill(destination, background)
+
+    stack = pysicgl.LayerStack()
+    stack.add(
+        fill_layer((2, 2), red), pysicgl.Screen((2, 2)), pysicgl.composition.DIRECT_SET
+    )
+    sprite = fill_layer((1, 1), green)
+    sprite_screen = pysicgl.Screen((1, 1), (1, 0))
+    stack.add(sprite, sprite_screen, pysicgl.composition.CHANNEL_SUM_CLAMPED)
+    stack.add(
+        fill_layer((2, 2), blue),
+        pysicgl.Screen((2, 2), (2, 0)),
+        pysicgl.composition.DIRECT_SET,
+        opacity=0.5,
+    )
+
+    stack.flatten(destination, incremental=True)
+    assert pixels(destination) == reference(stack)
+
+    # nothing is dirty so the destination is left untouched
+    pysicgl.functional.interface_pixel(destination, 0, (3, 1))
+    stack.flatten(destination, incremental=True)
+    assert pysicgl.functional.get_pixel_at_coordinates(destination, (3, 1)) == 0
+    stack.mark_dirty(2, ((1, 1), (1, 1)))
+    stack.flatten(destination, incremental=True)
+    assert pixels(destination) == reference(stack)
+
+    # change the pixels of a layer and then move it
+    pysicgl.functional.interface_fill(sprite, blue)
+    stack.mark_dirty(1)
+    stack.flatten(destination, incremental=True)
+    assert pixels(destination) == reference(stack)
+
+    sprite_screen.set_corners((0, 1), (0, 1))
+    stack.mark_dirty(1)
+    stack.flatten(destination, incremental=True)
+    assert pixels(destination) == reference(stack)
+
+    stack.update(0, visible=False)
+    stack.flatten(destination, incremental=True)
+    assert pixels(destination) == reference(stack)
+
+    stack.remove(0)
+    stack.flatten(destination, incremental=True)
+    assert pixels(destination) == reference(stack)
@@ -0,0 +1,85 @@
+import pytest
+import pysicgl
+from tests.testutils import make_interface, rgba
+
+
+def make_ring():
+    # a 4x4 square outline, transparent inside
+    sprite = make_interface((4, 4))
+    red = pysicgl.functional.color_from_rgba((255, 0, 0, 255))
+    pysicgl.functional.interface_rectangle(sprite, red, (0, 0), (3, 3))
+    return sprite
+
+
+def test_rle_sprite_encoding():
+    source = make_ring()
+    sprite = pysicgl.RLESprite(source)
+    assert sprite.extent == (4, 4)
+    # one run on the top and bottom rows and two on each middle row
+    assert sprite.runs == 6
+    assert sprite.pixels == 12
+
+    from_buffer = pysicgl.RLESprite(source.memory, (4, 4))
+    assert from_buffer.runs == 6
+
+    with pytest.raises(ValueError):
+        pysicgl.RLESprite(source.memory)
+    with pytest.raises(ValueError):
+        pysicgl.RLESprite(source.memory, (8, 8))
+
+
+def test_rle_sprite_draw():
+    sprite = pysicgl.RLESprite(make_ring())
+    blue = pysicgl.functional.color_from_rgba((0, 0, 255, 255))
+
+    interface = make_interface((6, 6))
+    pysicgl.functional.interface_fill(interface, blue)
+    sprite.draw(interface, (1, 1))
+    assert rgba(interface, (1, 1)) == (255, 0, 0, 255)
+    assert rgba(interface, (4, 2)) == (255, 0, 0, 255)
+    # transparent pixels are not touched
+    assert rgba(interface, (2, 2)) == (0, 0, 255, 255)
+    assert rgba(interface, (0, 0)) == (0, 0, 255, 255)
+
+    # runs are clipped to the interface
+    interface = make_interface((3, 3))
+    sprite.draw(interface, (-2, -1))
+    assert rgba(interface, (0, 0)) == (0, 0, 0, 0)
+    assert rgba(interface, (1, 0)) == (255, 0, 0, 255)
+    assert rgba(interface, (1, 1)) == (255, 0, 0, 255)
+    assert rgba(interface, (0, 2)) == (255, 0, 0, 255)
+    assert rgba(interface, (2, 0)) == (0, 0, 0, 0)
+
+    # and to a screen, in whose coordinates the position is given
+    interface = make_interface((6, 6))
+    screen = pysicgl.Screen((2, 6), (3, 0))
+    sprite.draw(interface, (0, 0), screen=screen)
+    assert rgba(interface, (3, 0)) == (255, 0, 0, 255)
+    assert rgba(interface, (4, 0)) == (255, 0, 0, 255)
+    assert rgba(interface, (5, 0)) == (0, 0, 0, 0)
+
+    interface = make_interface((6, 6))
+    pysicgl.functional.interface_fill(interface, blue)
+    sprite.draw(interface, (0, 0), compositor=pysicgl.composition.BIT_OR)
+    assert rgba(interface, (0, 0)) == (255, 0, 255, 255)
+    assert rgba(interface, (1, 1)) == (0, 0, 255, 255)
+
+
+def test_rle_sprite_draw_extremes():
+    sprite = pysicgl.RLESprite(make_ring())
+    interface = make_interface((6, 6))
+
+    # positions at the limits of ext_t are clipped without overflowing
+    for position in [(0, -(2**31)), (-(2**31), 0), (2**31 - 1, 0), (0, 2**31 - 1)]:
+        sprite.draw(interface, position)
+        sprite.draw(interface, position, compositor=pysicgl.composition.BIT_OR)
+    screen = pysicgl.Screen((6, 6), (2**31 - 6, 2**31 - 6))
+    sprite.draw(interface, (2**31 - 1, 2**31 - 1), screen=screen)
+    assert all(
+        rgba(interface, (u, v)) == (0, 0, 0, 0) for u in range(6) for v in range(6)
+    )
+
+    # an uninitialized sprite draws nothing
+    empty = pysicgl.RLESprite.__new__(pysicgl.RLESprite)
+    empty.draw(interface, (0, 0))
+    assert empty.extent == (0, 0)
@@ -0,0 +1,137 @@
+import pytest
+import pysicgl
+from tests.testutils import filled, make_interface, rgba
+
+
+def test_sprite_atlas_packing():
+    atlas = pysicgl.SpriteAtlas(width=8)
+    assert atlas.extent == (8, 0)
+    assert atlas.add(filled((4, 2), (255, 0, 0, 255)), name="red") == 0
+    assert atlas.add(filled((4, 3), (0, 255, 0, 255)), name="green") == 1
+    # does not fit beside the others so starts a new shelf
+    assert atlas.add(filled((2, 2), (0, 0, 255, 255))) == 2
+    assert atlas.sprites == 3
+    assert atlas.names == {"red": 0, "green": 1}
+    assert atlas.extent[1] >= 5
+    assert atlas.sprite_extent("green") == (4, 3)
+    assert atlas.sprite_extent(2) == (2, 2)
+
+    with pytest.raises(ValueError):
+        atlas.add(filled((9, 1), (0, 0, 0, 255)))
+    with pytest.raises(KeyError):
+        atlas.sprite_extent("blue")
+    with pytest.raises(IndexError):
+        atlas.sprite_extent(3)
+
+
+def test_sprite_atlas_draw():
+    atlas = pysicgl.SpriteAtlas(width=8)
+    red = atlas.add(filled((2, 2), (255, 0, 0, 255)), name="red")
+    blue = atlas.add(filled((2, 2), (0, 0, 255, 255)))
+
+    interface = make_interface((6, 6))
+    atlas.draw(
+        interface,
+        [
+            (red, (0, 0)),
+            ("red", (4, 4)),
+            (blue, (5, 2)),
+            (blue, (1, 1), pysicgl.composition.BIT_OR),
+        ],
+    )
+    assert rgba(interface, (0, 0)) == (255, 0, 0, 255)
+    assert rgba(interface, (1, 1)) == (255, 0, 255, 255)
+    assert rgba(interface, (2, 2)) == (0, 0, 255, 255)
+    assert rgba(interface, (5, 5)) == (255, 0, 0, 255)
+    # clipped to the interface
+    assert rgba(interface, (5, 3)) == (0, 0, 255, 255)
+    assert rgba(interface, (3, 0)) == (0, 0, 0, 0)
+
+    # screen coordinates are offset by the location of the screen
+    interface = make_interface((6, 6))
+    screen = pysicgl.Screen((3, 3), (2, 2))
+    atlas.draw(interface, [(red, (0, 0)), (red, (2, 2))], screen=screen)
+    assert rgba(interface, (2, 2)) == (255, 0, 0, 255)
+    assert rgba(interface, (4, 4)) == (255, 0, 0, 255)
+    assert rgba(interface, (5, 5)) == (0, 0, 0, 0)
+
+    with pytest.raises(TypeError):
+        atlas.draw(interface, [red])
+    with pytest.raises(IndexError):
+        atlas.draw(interface, [(7, (0, 0))])
+
+
+def test_sprite_atlas_draw_extremes():
+    atlas = pysicgl.SpriteAtlas(width=8)
+    red = atlas.add(filled((4, 4), (255, 0, 0, 255)))
+    interface = make_interface((6, 6))
+
+    # positions at the limits of ext_t are clipped without overflowing
+    for position in [(-(2**31), 0), (2**31 - 1, 0), (0, -(2**31)), (0, 2**31 - 1)]:
+        atlas.draw(interface, [(red, position)])
+        atlas.draw(interface, [(red, position, pysicgl.composition.BIT_OR)])
+    screen = pysicgl.Screen((6, 6), (2**31 - 6, 2**31 - 6))
+    atlas.draw(interface, [(red, (2**31 - 1, 2**31 - 1))], screen=screen)
+    assert all(
+        rgba(interface, (u, v)) == (0, 0, 0, 0) for u in range(6) for v in range(6)
+    )
+
+
+def test_sprite_atlas_grows_while_parsing():
+    atlas = pysicgl.SpriteAtlas(width=2)
+    red = atlas.add(filled((2, 2), (255, 0, 0, 255)))
+
+    class Position:
+        # adds sprites to the atlas while the batch is being parsed
+        def __index__(self):
+            for _ in range(64):
+                atlas.add(filled((2, 2), (0, 0, 255, 255)))
+            return 0
+
+    interface = make_interface((4, 4))
+    atlas.draw(interface, [(red, (2, 2)), (red, (Position(), 0))])
+    assert rgba(interface, (0, 0)) == (255, 0, 0, 255)
+    assert rgba(interface, (3, 3)) == (255, 0, 0, 255)
+    assert atlas.sprites == 65
+
+
+def test_sprite_atlas_changes_while_parsing():
+    atlas = pysicgl.SpriteAtlas(width=2)
+    red = atlas.add(filled((2, 2), (255, 0, 0, 255)))
+    interface = make_interface((4, 4))
+
+    class Clearing:
+        # empties the batch while it is being parsed
+        def __index__(self):
+            batch.clear()
+            return 2
+
+    batch = [(red, (0, 0)), (red, (Clearing(), 2)), (red, (0, 2))]
+    atlas.draw(interface, batch)
+    assert rgba(interface, (0, 0)) == (255, 0, 0, 255)
+    assert rgba(interface, (3, 3)) == (255, 0, 0, 255)
+    assert rgba(interface, (1, 3)) == (255, 0, 0, 255)
+
+    class Reinitializing:
+        # replaces the sprites after the first has been resolved
+        def __index__(self):
+            atlas.__init__(width=1)
+            atlas.add(filled((1, 1), (0, 0, 255, 255)))
+            return 0
+
+    with pytest.raises(ValueError):
+        atlas.draw(interface, [(red, (0, 0)), (red, (Reinitializing(), 0))])
+    assert atlas.sprites == 1
+
+
+def test_sprite_atlas_uninitialized():
+    atlas = pysicgl.SpriteAtlas.__new__(pysicgl.SpriteAtlas)
+    interface = make_interface((4, 4))
+    assert atlas.names is None
+    assert atlas.sprites == 0
+    with pytest.raises(ValueError):
+        atlas.draw(interface, [])
+    with pytest.raises(ValueError):
+        atlas.add(filled((2, 2), (255, 0, 0, 255)), name="red")
+    with pytest.raises(ValueError):
+        atlas.sprite_extent("red")
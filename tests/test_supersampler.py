@@ -0,0 +1,94 @@
+import pytest
+import pysicgl
+from tests.testutils import make_interface, rgba
+
+
+def test_supersampler_mirrors_screen():
+    screen = pysicgl.Screen((4, 3), (2, 1))
+    sampler = pysicgl.Supersampler(screen, factor=4)
+    assert sampler.factor == 4
+    assert sampler.screen is screen
+    assert sampler.interface.screen.extent == (16, 12)
+    assert sampler.interface.screen.location == (8, 4)
+
+    with pytest.raises(ValueError):
+        pysicgl.Supersampler(screen, factor=1)
+    with pytest.raises(ValueError):
+        pysicgl.Supersampler(screen, factor=9)
+
+
+@pytest.mark.parametrize("factor", [2, 3, 4])
+def test_supersampler_resolve(factor):
+    target = make_interface((4, 4))
+    sampler = pysicgl.Supersampler(target.screen, factor=factor)
+    white = pysicgl.functional.color_from_rgba((255, 255, 255, 255))
+
+    # a uniform color survives filtering exactly
+    sampler.clear(white)
+    sampler.resolve(target)
+    assert rgba(target, (3, 3)) == (255, 255, 255, 255)
+
+    # a single covered subpixel contributes its share of the pixel
+    sampler.clear()
+    pysicgl.functional.interface_pixel(sampler.interface, white, (factor, 0))
+    sampler.resolve(target)
+    expected = round(255 / (factor * factor))
+    assert rgba(target, (1, 0)) == (expected,) * 4
+    assert rgba(target, (0, 0)) == (0, 0, 0, 0)
+
+
+def test_supersampler_compose_clipped():
+    target = make_interface((4, 4))
+    red = pysicgl.functional.color_from_rgba((255, 0, 0, 255))
+    pysicgl.functional.interface_fill(target, red)
+
+    # the sampled screen hangs off the edge of the target
+    sampler = pysicgl.Supersampler(pysicgl.Screen((2, 2), (3, 3)))
+    green = pysicgl.functional.color_from_rgba((0, 255, 0, 255))
+    sampler.clear(green)
+    sampler.resolve(target, compositor=pysicgl.composition.CHANNEL_SUM_CLAMPED)
+    assert rgba(target, (3, 3)) == (255, 255, 0, 255)
+    assert rgba(target, (2, 2)) == (255, 0, 0, 255)
+
+
+def test_supersampler_uninitialized():
+    sampler = pysicgl.Supersampler.__new__(pysicgl.Supersampler)
+    assert sampler.interface is None
+    with pytest.raises(ValueError):
+        sampler.clear()
+    with pytest.raises(ValueError):
+        sampler.resolve(make_interface((2, 2)))
+
+
+def test_supersampler_memory_replaced():
+    target = make_interface((2, 2))
+    sampler = pysicgl.Supersampler(target.screen)
+
+    # the supersampled interface no longer covers the sampled screen
+    sampler.interface.memory = pysicgl.allocate_pixel_memory(4)
+    with pytest.raises(ValueError):
+        sampler.resolve(target)
+
+
+@pytest.mark.parametrize("factor", [2, 3, 4])
+def test_supersampler_matches_reference(factor):
+    target = make_interface((5, 3))
+    sampler = pysicgl.Supersampler(target.screen, factor=factor)
+    width, height = 5 * factor, 3 * factor
+    for v in range(height):
+        for u in range(width):
+            channels = tuple((u * 37 + v * 91 + k * 53) % 256 for k in range(4))
+            color = pysicgl.functional.color_from_rgba(channels)
+            pysicgl.functional.interface_pixel(sampler.interface, color, (u, v))
+
+    sampler.resolve(target)
+    samples = factor * factor
+    for v in range(3):
+        for u in range(5):
+            sums = [0] * 4
+            for y in range(v * factor, (v + 1) * factor):
+                for x in range(u * factor, (u + 1) * factor):
+                    pixel = rgba(sampler.interface, (x, y))
+                    sums = [a + b for a, b in zip(sums, pixel)]
+            expected = tuple((total + samples // 2) // samples for total in sums)
+            assert rgba(target, (u, v)) == expected
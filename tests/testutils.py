@@ -3,6 +3,8 @@
 
 import math
 
+import pysicgl
+
 
 def vec_add(*vectors):
     return tuple(sum(elements) for elements in zip(*vectors))
@@ -15,3 +17,27 @@ def vec_magnitude(vector):
 def vec_normalize(vector):
     magnitude = vec_magnitude(vector)
     return tuple(element / magnitude for element in vector)
+
+
+# interface utilities
+
+
+def make_interface(extent, location=(0, 0)):
+    screen = pysicgl.Screen(extent, location)
+    memory = pysicgl.allocate_pixel_memory(screen.pixels)
+    return pysicgl.Interface(screen, memory)
+
+
+def filled(extent, color, location=(0, 0)):
+    # an interface filled with an (r, g, b, a) color
+    interface = make_interface(extent, location)
+    pysicgl.functional.interface_fill(
+        interface, pysicgl.functional.color_from_rgba(color)
+    )
+    return interface
+
+
+def rgba(interface, coordinates):
+    return pysicgl.functional.color_to_rgba(
+        pysicgl.functional.get_pixel_at_coordinates(interface, coordinates)
+    )